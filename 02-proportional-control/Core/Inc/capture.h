@@ -0,0 +1,171 @@
+/**
+ * @file    capture.h
+ * @brief   Triggered capture of control-loop samples ("on-device scope").
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * The UART can carry a few lines per control period, which is not
+ * enough to watch a transient.  Instead, every iteration stores one
+ * sample in a RAM ring.  When a trigger fires, the ring keeps `pre`
+ * samples from before it and records until the window is full.  Then it
+ * freezes.  The window goes out one line at a time, as slowly as the
+ * link needs, and recording resumes when capture_arm() is called again.
+ *
+ * Triggers are edge-sensitive: the error and saturation conditions must
+ * be absent on one sample and present on the next.  A loop that stays
+ * saturated therefore does not produce a stream of identical captures.
+ * A condition that is present at arming is ignored until it clears.
+ *
+ * Usage:
+ *     #include "capture.h"
+ *     static capture_t scope;
+ *     capture_init(&scope, CAPTURE_TRIG_SETPOINT | CAPTURE_TRIG_SATURATION,
+ *                  64u, 20.0f, 0.0f, 100.0f);
+ *     capture_arm(&scope);
+ *     …                                                 // every iteration
+ *     capture_sample_t s = { t0, raw, y, u, integral };
+ *     capture_record(&scope, &s, ctrl.setpoint);
+ *     …                                                 // at leisure
+ *     if (scope.state == CAPTURE_FROZEN)
+ *     {
+ *         if (capture_format(&scope, line++, timebase_hz(), buf, sizeof buf))
+ *             send(buf);
+ *         else
+ *             capture_arm(&scope), line = 0;
+ *     }
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ramfunc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef CAPTURE_DEPTH
+#define CAPTURE_DEPTH   256u    /**< Samples per window, a power of two */
+#endif
+
+#if (CAPTURE_DEPTH & (CAPTURE_DEPTH - 1u)) != 0u
+#error "CAPTURE_DEPTH must be a power of two"
+#endif
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef struct
+{
+    uint32_t t;             /**< Time base stamp of the sample          */
+    uint32_t raw;           /**< ADC counts                             */
+    float    filtered;      /**< Measurement the controller used        */
+    float    duty;          /**< Output applied (%)                     */
+    float    integral;      /**< Integrator state (0 for a P loop)      */
+} capture_sample_t;
+
+typedef enum
+{
+    CAPTURE_TRIG_SETPOINT   = 1u << 0,  /**< Setpoint changed            */
+    CAPTURE_TRIG_ERROR      = 1u << 1,  /**< |setpoint - filtered| rose above the threshold */
+    CAPTURE_TRIG_SATURATION = 1u << 2,  /**< Duty reached out_min or out_max */
+    CAPTURE_TRIG_FORCE      = 1u << 3   /**< capture_force()             */
+} capture_trigger_t;
+
+typedef enum
+{
+    CAPTURE_IDLE = 0,       /**< Not recording                          */
+    CAPTURE_ARMED,          /**< Recording, waiting for a trigger       */
+    CAPTURE_POST,           /**< Triggered, recording the rest          */
+    CAPTURE_FROZEN          /**< Window complete, ready to read out     */
+} capture_state_t;
+
+typedef struct
+{
+    capture_sample_t buf[CAPTURE_DEPTH];
+
+    uint32_t triggers;      /**< Enabled CAPTURE_TRIG_* bits            */
+    uint32_t pre;           /**< Samples kept from before the trigger   */
+    float    err_threshold; /**< Error trigger level                    */
+    float    out_min;       /**< Saturation trigger limits              */
+    float    out_max;
+
+    volatile capture_state_t state;
+    uint32_t head;          /**< Samples written since init (ring index) */
+    uint32_t recorded;      /**< Samples written since arming           */
+    uint32_t remaining;     /**< Post-trigger samples still to record   */
+    uint32_t level_prev;    /**< Error/saturation bits of the last sample */
+    float    setpoint;      /**< Setpoint of the last sample            */
+    volatile uint32_t forced;   /**< capture_force() pending            */
+
+    /* The frozen window */
+    uint32_t cause;         /**< CAPTURE_TRIG_* bits that fired         */
+    uint32_t count;         /**< Samples in the window                  */
+    uint32_t trig_index;    /**< Position of the trigger sample in it   */
+    uint32_t t_trigger;     /**< Stamp of the trigger sample            */
+    uint32_t captures;      /**< Windows completed since init           */
+} capture_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Configure the triggers; the capture starts idle.
+ * @param  triggers       CAPTURE_TRIG_* bits to act on
+ * @param  pre            Samples kept from before the trigger
+ *                        (at most CAPTURE_DEPTH - 1)
+ * @param  err_threshold  Level of the error trigger, in measurement units
+ * @param  out_min        Duty at or below which the loop is saturated
+ * @param  out_max        Duty at or above which the loop is saturated
+ */
+void capture_init(capture_t *c, uint32_t triggers, uint32_t pre,
+                  float err_threshold, float out_min, float out_max);
+
+/**
+ * @brief  Start recording and wait for the next trigger.
+ */
+void capture_arm(capture_t *c);
+
+/**
+ * @brief  Trigger on the next recorded sample (safe from an interrupt).
+ */
+void capture_force(capture_t *c);
+
+/**
+ * @brief  Store one control-loop sample and evaluate the triggers.
+ * @param  s         Sample of this iteration
+ * @param  setpoint  Setpoint the controller used
+ * @return true on the sample that completes the window
+ */
+RAMFUNC bool capture_record(capture_t *c, const capture_sample_t *s, float setpoint);
+
+/**
+ * @brief  Sample i of the frozen window, oldest first.
+ */
+const capture_sample_t *capture_sample(const capture_t *c, uint32_t i);
+
+/**
+ * @brief  Format line n of the frozen window's read-out:
+ *             scope_begin,<core_hz>,<cause>,<count>,<trig_index>
+ *             scope,<dt_cycles>,<raw>,<filtered>,<duty>,<integral>  (count lines)
+ *             scope_end
+ *         dt_cycles is signed and relative to the trigger sample.  The
+ *         three values are in thousandths, so no float printf is needed.
+ * @param  core_hz  Cycle counter frequency, passed through for the host
+ * @return Characters written, 0 once n is past the last line
+ */
+size_t capture_format(const capture_t *c, uint32_t n, uint32_t core_hz,
+                      char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CAPTURE_H */
@@ -0,0 +1,45 @@
+/**
+ * @file    dwt.h
+ * @brief   Minimal access to the Cortex-M4 DWT cycle counter.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * CYCCNT runs at HCLK (180 MHz here) and wraps every ~23.8 s; always
+ * take differences with unsigned arithmetic.
+ */
+
+#ifndef DWT_H
+#define DWT_H
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Enable trace and start the cycle counter from zero. */
+static inline void dwt_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/** Current cycle count. */
+static inline uint32_t dwt_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/** Convert microseconds to cycles at the current core clock. */
+static inline uint32_t dwt_us_to_cycles(uint32_t us)
+{
+    return (SystemCoreClock / 1000000u) * us;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* DWT_H */
@@ -0,0 +1,36 @@
+/**
+ * @file    led_gamma_table.h
+ * @brief   LED output linearisation curve, generated by
+ *          Tools/gen_gamma_lut.py – do not edit.
+ *
+ * Source: log CdS model (U0=5.0, ambient 5.0, span 85.0).
+ * Entry i is the duty (Q16, 65536 = 100 %) for a command of
+ * i/64 of full scale; see LedPwm_setCurve().
+ */
+
+#ifndef LED_GAMMA_TABLE_H
+#define LED_GAMMA_TABLE_H
+
+#include <stdint.h>
+#include "led_pwm.h"
+#include "ramfunc.h"
+
+#define LED_GAMMA_SEGMENTS  64u
+
+#if LED_GAMMA_SEGMENTS != LED_PWM_CURVE_SEGMENTS
+#error "led_gamma_table.h does not match LED_PWM_CURVE_SEGMENTS; regenerate it"
+#endif
+
+RAMDATA static const uint32_t led_gamma_table[LED_GAMMA_SEGMENTS + 1u] = {
+        0u,   160u,   327u,   503u,   687u,   880u,  1082u,  1295u,
+     1518u,  1751u,  1996u,  2253u,  2522u,  2805u,  3101u,  3412u,
+     3738u,  4080u,  4438u,  4814u,  5208u,  5621u,  6055u,  6510u,
+     6986u,  7486u,  8011u,  8561u,  9137u,  9742u, 10377u, 11042u,
+    11739u, 12471u, 13238u, 14043u, 14887u, 15772u, 16700u, 17673u,
+    18694u, 19764u, 20887u, 22064u, 23298u, 24593u, 25951u, 27375u,
+    28868u, 30434u, 32077u, 33799u, 35606u, 37500u, 39487u, 41570u,
+    43755u, 46046u, 48449u, 50970u, 53612u, 56384u, 59291u, 62339u,
+    65536u,
+};
+
+#endif /* LED_GAMMA_TABLE_H */
@@ -3,15 +3,40 @@
 
 #include "stm32f4xx_hal.h"
 #include <stdint.h>
+#include <stdbool.h>
 #include "logger.h"
+#include "ramfunc.h"
+
+/** Full scale of LedPwm_setDutyQ16(): 100 % duty */
+#define LED_PWM_Q16_ONE  65536u
+
+/** Segments of a LedPwm_setCurve() table, 2^(16 - LED_PWM_CURVE_SHIFT) */
+#define LED_PWM_CURVE_SEGMENTS  64u
+#define LED_PWM_CURVE_SHIFT     10u
 
 /**
  * @brief PWM-controlled LED interface.
+ *
+ * With Period = 100-1 the compare register has about 100 steps, so
+ * LedPwm_setDuty() gives 101 LED levels and any finer controller output
+ * is lost.  LedPwm_setDutyFloat() / LedPwm_setDutyQ16() keep the
+ * fraction of a count: with dithering enabled, LedPwm_periodElapsed()
+ * (called from the timer update interrupt) adds it to an accumulator
+ * every PWM period and emits one extra count each time that overflows –
+ * a first-order sigma-delta modulator.  The LED and the CdS cell average
+ * over hundreds of periods, so the effective duty is the exact one.
+ *
+ * An optional curve (LedPwm_setCurve()) sits in front of the compare
+ * value and linearises the LED → CdS response.
  */
 typedef struct {
     TIM_HandleTypeDef* htim;  /**< Pointer to the timer handle */
     uint32_t channel;         /**< Timer channel used for PWM (e.g., TIM_CHANNEL_1) */
     uint8_t duty_percent;     /**< Current duty cycle percentage (0–100) */
+    volatile uint32_t compare_q16; /**< Target compare value, Q16.16 counts */
+    uint32_t sd_acc;          /**< Sigma-delta accumulator (fraction of a count, Q16) */
+    bool dither;              /**< Compare value updated every period by the ISR */
+    const uint32_t* curve;    /**< Command → duty table (Q16), NULL = linear */
 } LedPwm_t;
 
 /**
@@ -45,4 +70,57 @@ void LedPwm_stop(LedPwm_t* led);
  */
 void LedPwm_setDuty(LedPwm_t* led, uint8_t duty_percent);
 
+/**
+ * @brief Set the duty cycle with sub-count resolution.
+ *
+ * Full scale is Period + 1 counts (always on).  Without dithering the
+ * compare value is rounded to the nearest count.
+ *
+ * @param led Pointer to a LedPwm_t structure
+ * @param duty_q16 Duty cycle, LED_PWM_Q16_ONE = 100 %
+ */
+RAMFUNC void LedPwm_setDutyQ16(LedPwm_t* led, uint32_t duty_q16);
+
+/**
+ * @brief As LedPwm_setDutyQ16(), in percent (clamped to 0–100).
+ *
+ * @param led Pointer to a LedPwm_t structure
+ * @param duty_percent Duty cycle in percent
+ */
+RAMFUNC void LedPwm_setDutyFloat(LedPwm_t* led, float duty_percent);
+
+/**
+ * @brief Insert a linearisation curve between the command and the compare value.
+ *
+ * The table holds LED_PWM_CURVE_SEGMENTS + 1 duties in Q16 at evenly
+ * spaced commands (Tools/gen_gamma_lut.py writes led_gamma_table.h).
+ * Every set call then interpolates between the two neighbouring
+ * entries: one shift, one multiply. It applies from the next set call.
+ *
+ * @param led Pointer to a LedPwm_t structure
+ * @param curve Monotonic table, kept by reference; NULL for none
+ */
+void LedPwm_setCurve(LedPwm_t* led, const uint32_t* curve);
+
+/**
+ * @brief Enable or disable sigma-delta dithering.
+ *
+ * Enables the timer update interrupt; its handler must call
+ * LedPwm_periodElapsed().
+ *
+ * @param led Pointer to a LedPwm_t structure
+ * @param enable true to dither the compare value every PWM period
+ */
+void LedPwm_setDither(LedPwm_t* led, bool enable);
+
+/**
+ * @brief Load the next period's compare value (timer update interrupt).
+ *
+ * The compare register is preloaded, so the value takes effect at the
+ * following update event.
+ *
+ * @param led Pointer to a LedPwm_t structure
+ */
+RAMFUNC void LedPwm_periodElapsed(LedPwm_t* led);
+
 #endif // LED_PWM_H
@@ -16,8 +16,31 @@
  * - `LOG_USE_SD`: Enable/disable SD card output (default: 0)
  * - `LOG_USE_IT`: Enable interrupt-based UART TX (default: 1)
  * - `LOG_USE_DMA`: Enable DMA-based UART TX (default: 0)
- * - `LOG_BUFFER_SIZE`: Buffer size for log formatting
+ * - `LOG_BUFFER_SIZE`: Buffer size for log formatting, time stamp excluded
  * - `LOG_RING_BUFFER_SIZE`: Ring buffer size for non-blocking TX
+ * - `LOG_RX_BUFFER_SIZE`: Receive ring size for Log_Poll() (default: 256)
+ * - `LOG_FRAME_MAX`: Longest binary frame received (default: 128)
+ * - `LOG_SD_BLOCK_SECTORS`: Sectors per SD write (default: 4, i.e. 2 KB)
+ * - `LOG_SD_SYNC_MS`: Longest time SD data waits in RAM (default: 1000)
+ *
+ * ## SD card output:
+ * `Log()` only copies the message into one of two sector-aligned RAM
+ * blocks.  `Log_Service()`, called from the main loop's idle time, writes
+ * full blocks with one multi-sector `f_write()` each and syncs every
+ * `LOG_SD_SYNC_MS`.  A call does at most one block write or one sync, so
+ * its stall is bounded.  When both blocks are full, messages are dropped
+ * whole and counted (`Log_GetSdStats()`).  Log() and Log_Service() must
+ * run in the same context (not from an interrupt).
+ *
+ * ## Time stamps:
+ * After `Log_SetClock()` every message starts with `@<hex>:`, the time
+ * it was logged in ticks of a free-running 32-bit counter (TIM5),
+ * extended to 64 bits: each read that finds the counter below the last
+ * one counts a wrap.  So the counter must be read at least once per wrap
+ * (47.7 s at 90 MHz); `Log_Sync()` once a second covers that.  The sync record `@<hex>:sync,<hz>` is sent
+ * only while the UART ring is empty, so it leaves the moment it is
+ * stamped; the host fits the device clock to their arrival times
+ * (uart_plotter/devclock.py).
  *
  * ## Example:
  * @code
@@ -34,7 +57,10 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdarg.h>
+#include "ramfunc.h"
 
 #ifdef __has_include
 #  if __has_include("logger_config.h")
@@ -77,13 +103,96 @@ void Log_SetLevel(LogLevel level);
  */
 void Log(LogLevel level, const char* format, ...);
 
+/**
+ * @brief Queue raw bytes (e.g. a binary frame) for UART output.
+ *
+ * Unlike text messages, the bytes are queued completely or not at all,
+ * so a full ring never leaves half a frame on the wire.  Bypasses the
+ * level filter and the SD backend.
+ *
+ * @param data Bytes to send; may contain any value.
+ * @param len  Number of bytes.
+ * @return true if queued, false if dropped for lack of space.
+ */
+RAMFUNC bool Log_WriteBytes(const uint8_t* data, size_t len);
+
+/** Longest Log_FormatStamp() output: '@', 16 hex digits, ':' and NUL */
+#define LOG_STAMP_MAX 19
+
+/** Free-running 32-bit counter read for time stamps (e.g. TIM5->CNT). */
+typedef uint32_t (*Log_ClockSource)(void);
+
+/**
+ * @brief Stamp every message with the time it was logged.
+ *
+ * @param read Counter to read, or NULL to stop stamping.
+ * @param hz   Its rate, announced in the sync records.
+ */
+void Log_SetClock(Log_ClockSource read, uint32_t hz);
+
+/**
+ * @brief Current time: the counter extended to 64 bits by counting wraps.
+ *
+ * Must be called at least once per counter wrap; safe from interrupts.
+ * @return Counts since Log_SetClock(), plus its first reading; 0 without a clock.
+ */
+RAMFUNC uint64_t Log_Timestamp(void);
+
+/**
+ * @brief Write a time stamp as `@<hex>:`, the prefix of stamped messages.
+ *
+ * @param stamp A value of Log_Timestamp().
+ * @param buf   Destination, LOG_STAMP_MAX bytes suffice.
+ * @param size  Its size.
+ * @return Characters written (NUL excluded); 0 if size is too small.
+ */
+size_t Log_FormatStamp(uint64_t stamp, char* buf, size_t size);
+
+/**
+ * @brief Send the clock sync record `@<hex>:sync,<hz>` if the UART is idle.
+ *
+ * A record that had to wait behind queued bytes would arrive late, so it
+ * is not sent then; call again on the next pass.  Reads the clock either
+ * way, which keeps the wrap count current.
+ * @return true if sent.
+ */
+bool Log_Sync(void);
+
 /**
  * @brief Flush output buffers.
  *
- * For SD logging, this calls `f_sync()` to commit to disk.
+ * For SD logging, this writes every buffered byte and calls `f_sync()`
+ * to commit it.  Blocks for up to two writes and a sync.
  */
 void Log_Flush(void);
 
+/**
+ * @brief Counters of the buffered SD backend.
+ */
+typedef struct {
+    uint32_t blocks;          /**< Full blocks written              */
+    uint32_t partial_writes;  /**< Part blocks written for a sync   */
+    uint32_t syncs;           /**< f_sync() calls                   */
+    uint32_t dropped_msgs;    /**< Messages lost to a full buffer   */
+    uint32_t dropped_bytes;   /**< Their total length               */
+    uint32_t errors;          /**< Failed or short FatFS writes     */
+} LogSdStats;
+
+/**
+ * @brief Background work of the SD backend (no-op without LOG_USE_SD).
+ *
+ * Writes one full block if one is waiting, otherwise syncs when
+ * LOG_SD_SYNC_MS has passed since the last sync.
+ *
+ * @param now_ms Millisecond time stamp (e.g. HAL_GetTick()).
+ */
+void Log_Service(uint32_t now_ms);
+
+/**
+ * @brief Copy the SD backend counters (all zero without LOG_USE_SD).
+ */
+void Log_GetSdStats(LogSdStats* stats);
+
 /**
  * @brief Disable all logging at runtime.
  *
@@ -95,7 +204,7 @@ void Log_Disable(void);
  * @brief UART output hook. Can be overridden by user.
  * @param msg Null-terminated string to send via UART.
  */
-__attribute__((weak)) void Log_Write_UART(const char* msg);
+RAMFUNC __attribute__((weak)) void Log_Write_UART(const char* msg);
 
 /**
  * @brief SD card output hook. Can be overridden by user.
@@ -126,9 +235,36 @@ typedef void (*Log_CommandCallback)(const char* cmd);
 void Log_SetCommandCallback(Log_CommandCallback cb);
 
 /**
- * @brief Poll the UART for incoming bytes and dispatch completed commands.
+ * Callback type used when a binary frame is received over UART.
+ *
+ * @param frame The bytes between the two 0x00 delimiters, still
+ *              COBS-encoded.
+ * @param len   Their number (at most LOG_FRAME_MAX).
+ * @return false if the frame is not valid; its closing 0x00 is then
+ *         taken as the start of the next frame, which resynchronises
+ *         after joining a stream midway.
+ */
+typedef bool (*Log_FrameCallback)(const uint8_t* frame, size_t len);
+
+/**
+ * @brief Register a callback for binary frames received over UART.
+ *
+ * A 0x00 byte outside a text line starts a frame and the next 0x00 ends
+ * it, the same framing the binary telemetry uses on output.  Text
+ * commands keep working alongside, also behind a stray 0x00 or a bad
+ * frame: a line end after only printable bytes, or LOG_FRAME_MAX bytes
+ * without a delimiter, leaves frame mode.  Without a callback, frames
+ * are skipped.
+ */
+void Log_SetFrameCallback(Log_FrameCallback cb);
+
+/**
+ * @brief Dispatch received bytes: completed commands and frames.
  *
- * Call periodically from the main loop to process command input.
+ * With `LOG_USE_IT` or `LOG_USE_DMA` the UART interrupt queues bytes in
+ * a `LOG_RX_BUFFER_SIZE` ring, so nothing is lost between calls.
+ * Otherwise the UART is polled, which only catches the byte in its data
+ * register.  Call periodically from the main loop.
  */
 void Log_Poll(void);
 
@@ -1,11 +1,25 @@
 // logger_config.h
 #pragma once
 
-// user configuration overrides
+// user configuration overrides (each may also come from -D)
+#ifndef LOG_UART_HANDLE
 #define LOG_UART_HANDLE     huart2
+#endif
+#ifndef LOG_USE_SD
 #define LOG_USE_SD          0
+#endif
+#ifndef LOG_USE_UART
 #define LOG_USE_UART        1
+#endif
+#ifndef LOG_USE_IT
 #define LOG_USE_IT          1
+#endif
+#ifndef LOG_USE_DMA
 #define LOG_USE_DMA         0
+#endif
+#ifndef LOG_BUFFER_SIZE
 #define LOG_BUFFER_SIZE     1024
+#endif
+#ifndef LOG_RING_BUFFER_SIZE
 #define LOG_RING_BUFFER_SIZE 2048
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file    looptime.h
+ * @brief   Control-loop period / jitter / deadline instrumentation.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * The module only does arithmetic on cycle stamps handed to it, so it
+ * runs unchanged on the host.  On target the stamps come from TIM5
+ * (see timebase.h), which keeps counting while the core sleeps.
+ *
+ * Usage:
+ *     #include "looptime.h"
+ *     looptime_t lt;
+ *     looptime_init(&lt, period_cycles, deadline_cycles);
+ *     …
+ *     looptime_begin(&lt, timebase_ticks());      // start of iteration
+ *     x = read_sensor();
+ *     looptime_mark(&lt, LOOPTIME_SENSE, timebase_ticks());
+ *     u = PID_COMPUTE(&ctrl, x);
+ *     looptime_mark(&lt, LOOPTIME_COMPUTE, timebase_ticks());
+ *     set_pwm_duty(u);
+ *     looptime_mark(&lt, LOOPTIME_ACTUATE, timebase_ticks());
+ *     …
+ *     looptime_format(&lt, buf, sizeof buf);        // text report, no halt
+ */
+
+#ifndef LOOPTIME_H
+#define LOOPTIME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ramfunc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef LOOPTIME_HIST_BUCKETS
+#define LOOPTIME_HIST_BUCKETS   24   /**< log2 buckets, last one is open-ended */
+#endif
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef enum
+{
+    LOOPTIME_SENSE = 0,     /**< Sensor read finished   */
+    LOOPTIME_COMPUTE,       /**< Controller finished    */
+    LOOPTIME_ACTUATE,       /**< Actuator write finished */
+    LOOPTIME_PHASES
+} looptime_phase_t;
+
+typedef struct
+{
+    uint32_t period;        /**< Nominal period in cycles                    */
+    uint32_t deadline;      /**< Allowed execution time per iteration        */
+
+    uint32_t iterations;    /**< Completed iterations                        */
+    uint32_t overruns;      /**< Iterations whose execution exceeded deadline */
+    uint32_t late_periods;  /**< Periods longer than period + deadline       */
+    uint32_t period_min;    /**< Shortest measured period                    */
+    uint32_t period_max;    /**< Longest measured period                     */
+    uint32_t exec_max;      /**< Worst-case begin → last mark                */
+    uint32_t phase_max[LOOPTIME_PHASES];   /**< Worst case per phase         */
+
+    /** hist[i] counts |period - nominal| in [2^(i-1), 2^i), hist[0] == 0 */
+    uint32_t hist[LOOPTIME_HIST_BUCKETS];
+
+    uint32_t t_begin;       /**< Stamp of current iteration start            */
+    uint32_t t_last;        /**< Stamp of previous mark                      */
+    uint8_t  started;       /**< A previous begin exists (period is valid)   */
+} looptime_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Reset all statistics.
+ * @param  lt        Instrumentation instance
+ * @param  period    Nominal loop period in cycles
+ * @param  deadline  Execution budget per iteration in cycles
+ */
+void looptime_init(looptime_t *lt, uint32_t period, uint32_t deadline);
+
+/**
+ * @brief  Stamp the start of an iteration and update the period statistics.
+ */
+RAMFUNC void looptime_begin(looptime_t *lt, uint32_t now);
+
+/**
+ * @brief  Stamp the end of a phase.  Phases must be marked in order.
+ *         Marking LOOPTIME_ACTUATE closes the iteration.
+ */
+RAMFUNC void looptime_mark(looptime_t *lt, looptime_phase_t phase, uint32_t now);
+
+/**
+ * @brief  Histogram bucket for a given absolute jitter (exposed for tests).
+ */
+uint32_t looptime_bucket(uint32_t jitter);
+
+/**
+ * @brief  Format the statistics as `looptime,...` / `loophist,...` lines.
+ * @return Number of characters written (excluding terminator).
+ */
+size_t looptime_format(const looptime_t *lt, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* LOOPTIME_H */
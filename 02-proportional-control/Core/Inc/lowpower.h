@@ -0,0 +1,47 @@
+#ifndef LOWPOWER_H
+#define LOWPOWER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Sleep-between-ticks support for the bare-metal main loop.
+ *
+ * The core executes WFI until the SysTick (or any other interrupt, e.g. the
+ * logger's UART TX) wakes it, so the loop no longer busy-spins on
+ * `tick_1ms`. Busy time is measured with the DWT cycle counter while awake,
+ * which stops with the core clock in sleep: it counts exactly the awake
+ * cycles, interrupt handlers included (the TIM2 dither ISR runs every
+ * 100 µs).  Anything that must count through a sleep uses TIM5 (timebase.h).
+ *
+ * Define LOWPOWER_USE_WFI=0 to fall back to spinning (e.g. for debuggers
+ * that lose the core in sleep).
+ */
+
+#ifndef LOWPOWER_USE_WFI
+#define LOWPOWER_USE_WFI 1
+#endif
+
+/**
+ * @brief Start idle accounting. Call after dwt_init().
+ */
+void LowPower_init(void);
+
+/**
+ * @brief Sleep until @p flag becomes true.
+ *
+ * The flag is tested with interrupts masked, so an interrupt that sets it
+ * between the test and WFI still wakes the core (no lost ticks).
+ *
+ * @param flag Flag set from an interrupt handler.
+ */
+void LowPower_waitFor(volatile bool* flag);
+
+/**
+ * @brief Fraction of time spent asleep since the previous call.
+ * @param wakeups_out Receives the number of wake-ups in that time, or NULL.
+ * @return Idle ratio in 1/1000 (0 = always busy, 1000 = always asleep).
+ */
+uint32_t LowPower_idlePermille(uint32_t* wakeups_out);
+
+#endif // LOWPOWER_H
@@ -0,0 +1,122 @@
+/**
+ * @file    onchange.h
+ * @brief   Report-on-change scheduler for telemetry channels.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * Printing every channel at a fixed rate wastes the link while the loop
+ * sits at its setpoint, and misses most of a transient.  This module
+ * looks at every control sample and reports a channel only when
+ *
+ *   - it has moved more than its deadband since the value last reported, or
+ *   - max_ms has passed since it was last reported (a heartbeat).
+ *
+ * Each channel is compared with the last value *reported*, not with the
+ * previous sample, so a slow drift is still reported once it adds up to
+ * more than the deadband.  A host that holds each reported value until
+ * the next report is then never further than the deadband from the
+ * sampled signal.  The heartbeat shows that a quiet channel is still
+ * alive.  A channel with deadband 0 is reported on every change.
+ *
+ * One line carries the channels that were due on the same sample:
+ *
+ *     chg,<ms>,<mask>,<value of each set bit, lowest first>
+ *
+ * uart_plotter/onchange_rebuild.py turns these lines back into a series
+ * on a uniform time grid.  If a line cannot be queued, call
+ * onchange_force() so the next sample reports every channel again.
+ *
+ * Usage:
+ *     #include "onchange.h"
+ *     static const onchange_channel_t cfg[ONCHANGE_CHANNELS] = {
+ *         { 32, 1000u }, { 100, 1000u }, { 100, 1000u } };
+ *     static onchange_t chg;
+ *     onchange_init(&chg, cfg);
+ *     …                                               // every sample
+ *     uint32_t due = onchange_update(&chg, now_ms, v);
+ *     if (due && !send(buf, onchange_format(now_ms, due, v, buf, sizeof buf)))
+ *         onchange_force(&chg);
+ */
+
+#ifndef ONCHANGE_H
+#define ONCHANGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ramfunc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef ONCHANGE_CHANNELS
+#define ONCHANGE_CHANNELS   3u      /**< Channels per sample, up to 32  */
+#endif
+
+#if ONCHANGE_CHANNELS > 32u
+#error "ONCHANGE_CHANNELS must fit the 32-bit report mask"
+#endif
+
+/** Longest line: "chg," two 10-digit fields, 12 characters per value */
+#define ONCHANGE_LINE_MAX   (4u + 2u * 11u + 12u * ONCHANGE_CHANNELS + 2u)
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef struct
+{
+    int32_t  deadband;      /**< Report when |value - reported| exceeds this */
+    uint32_t max_ms;        /**< Report at least this often, 0 = never       */
+} onchange_channel_t;
+
+typedef struct
+{
+    onchange_channel_t cfg[ONCHANGE_CHANNELS];
+    int32_t  reported[ONCHANGE_CHANNELS];   /**< Last value reported     */
+    uint32_t t_reported[ONCHANGE_CHANNELS]; /**< When, in ms             */
+    uint32_t forced;                        /**< Channels due regardless */
+    uint32_t samples;                       /**< onchange_update() calls */
+    uint32_t reports;                       /**< Calls that reported     */
+    uint32_t values;                        /**< Channel values reported */
+} onchange_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Set the channel configuration; the first sample reports all.
+ * @param  cfg  ONCHANGE_CHANNELS entries, copied
+ */
+void onchange_init(onchange_t *o, const onchange_channel_t *cfg);
+
+/**
+ * @brief  Report every channel on the next sample.
+ */
+void onchange_force(onchange_t *o);
+
+/**
+ * @brief  Decide which channels of this sample to report.
+ * @param  now_ms  Time stamp of the sample
+ * @param  values  ONCHANGE_CHANNELS values
+ * @return Mask of the channels to report (bit n = channel n), 0 if none;
+ *         they count as reported from here on
+ */
+RAMFUNC uint32_t onchange_update(onchange_t *o, uint32_t now_ms, const int32_t *values);
+
+/**
+ * @brief  Write the `chg,...` line for the channels in mask.
+ * @return Characters written (without the terminator), 0 if mask is 0
+ *         or cap is too small
+ */
+size_t onchange_format(uint32_t now_ms, uint32_t mask, const int32_t *values,
+                       char *buf, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* ONCHANGE_H */
@@ -0,0 +1,157 @@
+/**
+ * @file    param.h
+ * @brief   Typed parameter registry with binary get / set / list frames.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * Each tunable value (gains, setpoint, limits, telemetry deadbands) is
+ * listed once, with an ID, a type, a range and a name.  A tuning tool
+ * reads and writes the values by ID in small binary frames, so the MCU
+ * does not parse any strings.  On the UART the frames are COBS-encoded
+ * between 0x00 bytes, like the telemetry (Log_SetFrameCallback()).
+ *
+ *     request:   cmd, seq, body…, crc16
+ *     response:  cmd | 0x80, seq, status, body…, crc16
+ *
+ *     PARAM_CMD_GET   id…               → (id, type, value)…
+ *     PARAM_CMD_SET   (id, value)…      → nothing, or the failing id
+ *     PARAM_CMD_LIST  first index       → count, then per entry from there:
+ *                                         id, type, flags, min, max,
+ *                                         name length, name
+ *
+ * Values, min and max take 4 bytes, little-endian (floats as IEEE 754
+ * bits).  The CRC is CRC-16/CCITT-FALSE over every byte before it, sent
+ * low byte first.  The host matches responses to requests by `seq`.
+ *
+ * A SET is checked in full before any of it is taken: an unknown or
+ * read-only ID, or a value outside [min, max], rejects the whole frame.
+ * Accepted values are staged.  They reach the variables only when the
+ * control loop calls param_commit() at the start of a tick, so a tick
+ * sees all of an update or none of it.  GET returns the applied values.
+ * param_handle() and param_commit() must run in the same context.
+ *
+ * Usage:
+ *     #include "param.h"
+ *     static const param_def_t defs[] = {
+ *         { 1u, PARAM_F32, 0u, "kp", &ctrl.Kp, 0.0f, 10.0f },
+ *     };
+ *     static param_registry_t params;
+ *     param_init(&params, defs, 1u);
+ *     …                                             // frame received
+ *     size_t n = param_handle(&params, req, len, resp, sizeof resp);
+ *     …                                             // start of each tick
+ *     param_commit(&params);
+ */
+
+#ifndef PARAM_H
+#define PARAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ramfunc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef PARAM_MAX
+#define PARAM_MAX           32u     /**< Registry entries, up to 32     */
+#endif
+
+#if PARAM_MAX > 32u
+#error "PARAM_MAX must fit the 32-bit pending mask"
+#endif
+
+#define PARAM_NAME_MAX      15u     /**< Longest name sent by LIST      */
+#define PARAM_FRAME_MAX     128u    /**< Response buffer for param_handle() */
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef enum
+{
+    PARAM_F32 = 0u,
+    PARAM_U32 = 1u,
+    PARAM_I32 = 2u
+} param_type_t;
+
+typedef enum
+{
+    PARAM_CMD_GET  = 0x01u,
+    PARAM_CMD_SET  = 0x02u,
+    PARAM_CMD_LIST = 0x03u,
+    PARAM_CMD_RESPONSE = 0x80u      /**< Or-ed into the response's cmd  */
+} param_cmd_t;
+
+typedef enum
+{
+    PARAM_OK = 0u,
+    PARAM_ERR_CRC,                  /**< CRC mismatch                   */
+    PARAM_ERR_CMD,                  /**< Unknown command                */
+    PARAM_ERR_LENGTH,               /**< Body malformed, or reply too long */
+    PARAM_ERR_ID,                   /**< Unknown ID                     */
+    PARAM_ERR_READ_ONLY,            /**< SET of a read-only entry       */
+    PARAM_ERR_RANGE                 /**< Value outside [min, max]       */
+} param_status_t;
+
+#define PARAM_READ_ONLY     0x01u   /**< param_def_t.flags              */
+
+typedef struct
+{
+    uint8_t     id;                 /**< Stable address used by the host */
+    uint8_t     type;               /**< param_type_t                    */
+    uint8_t     flags;              /**< PARAM_READ_ONLY                 */
+    const char *name;               /**< Up to PARAM_NAME_MAX characters */
+    void       *value;              /**< The 32-bit variable itself      */
+    float       min;                /**< Accepted range, inclusive       */
+    float       max;
+} param_def_t;
+
+typedef struct
+{
+    const param_def_t *defs;
+    uint32_t count;
+    uint32_t staged[PARAM_MAX];     /**< Raw values waiting for commit  */
+    uint32_t pending;               /**< Bit n: defs[n] is staged       */
+    uint32_t frames;                /**< Requests answered              */
+    uint32_t errors;                /**< Of those, with a non-OK status */
+    uint32_t commits;               /**< Commits that applied something */
+} param_registry_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Attach the table of entries (kept by reference).
+ */
+void param_init(param_registry_t *r, const param_def_t *defs, uint32_t count);
+
+/**
+ * @brief  Answer one request frame (already COBS-decoded).
+ * @param  resp  Response buffer, PARAM_FRAME_MAX bytes
+ * @return Response length, 0 if the request is too short to answer
+ */
+size_t param_handle(param_registry_t *r, const uint8_t *req, size_t n,
+                    uint8_t *resp, size_t cap);
+
+/**
+ * @brief  Apply the staged values.  Call at the start of a control tick.
+ * @return true if staged values were applied
+ */
+RAMFUNC bool param_commit(param_registry_t *r);
+
+/**
+ * @brief  CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF).
+ */
+uint16_t param_crc16(const uint8_t *data, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PARAM_H */
@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "logger.h"
+#include "ramfunc.h"
 
 // Default configuration macros (raw ADC range for 12-bit)
 #define DEFAULT_SCALING    true
@@ -30,4 +31,4 @@ void photoCell_init(photoCell_t* sensor, bool scaled, uint16_t min_value, uint16
  * @param sensor Pointer to photoCell_t struct.
  * @return Scaled light level (0–100 if scaled, or raw clipped to 0–255).
  */
-uint8_t readSensor(photoCell_t* sensor);
+RAMFUNC uint8_t readSensor(photoCell_t* sensor);
@@ -19,6 +19,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "ramfunc.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -93,7 +94,7 @@ void pid_init(pid_t *pid,
  * @param  measured  Current process value
  * @return float     Controller output
  */
-float pid_compute(const pid_t *pid, float measured);
+RAMFUNC float pid_compute(const pid_t *pid, float measured);
 
 /* -------------- Convenience macro (computes in-place) -------------- */
 #define PID_COMPUTE(pid_ptr, meas)  pid_compute((pid_ptr), (meas))
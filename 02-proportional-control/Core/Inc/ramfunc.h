@@ -0,0 +1,58 @@
+/**
+ * @file    ramfunc.h
+ * @brief   Place hot functions and tables in zero-wait-state SRAM.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * At 180 MHz the flash needs 5 wait states; the ART accelerator hides
+ * them only while the code stays in its 64-line instruction cache.
+ * Functions tagged RAMFUNC are linked into `.RamFunc`, which the linker
+ * script collects inside `.data`, so the startup code copies them to
+ * SRAM together with the initialised variables.  Tables tagged RAMDATA
+ * (typically `const` look-up tables) go to `.RamData` the same way.
+ *
+ * Usage:
+ *     #include "ramfunc.h"
+ *     RAMFUNC float pid_compute(pid_t *pid, float measured);  // header
+ *     RAMFUNC float pid_compute(pid_t *pid, float measured)   // source
+ *     { … }
+ *     RAMDATA static const uint16_t lut[256] = { … };
+ *
+ * Put the macro on the prototype as well as on the definition: `long_call`
+ * makes callers branch through a register instead of a linker veneer in
+ * flash (SRAM at 0x2000_0000 is out of BL range from 0x0800_0000).
+ * Helpers called from a RAMFUNC must not end up as separate functions in
+ * flash; declare them RAMFUNC_INLINE, which inlines them even at -O0.
+ * Interrupt handlers, and HAL callbacks they reach, take RAMFUNC_ISR:
+ * the same section without `long_call`, so their CubeMX / HAL prototypes
+ * stay valid.  Vectors hold the full address, and the linker adds a
+ * veneer where HAL code in flash calls one.
+ *
+ * The build prints the placed symbols and their sizes (see
+ * cmake/ramfunc_report.cmake).  Define RAMFUNC_DISABLE=1 to link
+ * everything from flash again, e.g. for an A/B run of the bench.
+ */
+
+#ifndef RAMFUNC_H
+#define RAMFUNC_H
+
+#ifndef RAMFUNC_DISABLE
+#define RAMFUNC_DISABLE   0         /**< 1: RAMFUNC / RAMDATA expand to nothing */
+#endif
+
+#if defined(__arm__) && !RAMFUNC_DISABLE
+#define RAMFUNC     __attribute__((section(".RamFunc"), long_call, noinline))
+#define RAMFUNC_ISR __attribute__((section(".RamFunc"), noinline))
+#define RAMDATA     __attribute__((section(".RamData")))
+#else
+/* Host builds and flash-only builds */
+#define RAMFUNC
+#define RAMFUNC_ISR
+#define RAMDATA
+#endif
+
+/* Helpers of RAMFUNC code: always inlined, so they run from SRAM too */
+#define RAMFUNC_INLINE    static inline __attribute__((always_inline))
+
+#endif /* RAMFUNC_H */
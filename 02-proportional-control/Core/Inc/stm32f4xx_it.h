@@ -58,6 +58,7 @@ void SysTick_Handler(void);
 void DMA1_Stream6_IRQHandler(void);
 void USART2_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void TIM2_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -0,0 +1,140 @@
+/**
+ * @file    telemetry.h
+ * @brief   Delta / zig-zag varint encoder for the telemetry stream.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * A text line such as `telemetry,2048,4000,-12` costs about 24 bytes,
+ * though the readings barely move from one tick to the next.  The
+ * encoder batches TELEMETRY_BATCH samples of TELEMETRY_CHANNELS integer
+ * channels into one binary frame:
+ *
+ *     seq, n, stamp, keyframe (n values), then n-1 samples of deltas
+ *
+ * Every value is zig-zag mapped (0, -1, 1, -2 … → 0, 1, 2, 3 …) and
+ * written as a base-128 varint, so a change of ±63 takes one byte.  Each
+ * frame starts with absolute values (the keyframe), so a lost frame
+ * costs only its own samples, and `seq` shows the gap.  `stamp` is the
+ * time of the keyframe (Log_Timestamp(), 64-bit ticks) as an unsigned
+ * varint; the other samples follow at the sampling period.
+ *
+ * telemetry_flush() COBS-encodes the frame between two 0x00 bytes.  Log
+ * text never contains 0x00, so the binary frames share the UART with
+ * the text log.  The host splits on 0x00 (uart_plotter/telemetry_decode.py).
+ *
+ * Usage:
+ *     #include "telemetry.h"
+ *     static telemetry_t tlm;
+ *     telemetry_init(&tlm);
+ *     …                                              // every iteration
+ *     int32_t v[TELEMETRY_CHANNELS] = { raw, duty_centi, err_centi };
+ *     if (telemetry_put(&tlm, v, Log_Timestamp()))
+ *     {
+ *         uint8_t wire[TELEMETRY_WIRE_MAX];
+ *         Log_WriteBytes(wire, telemetry_flush(&tlm, wire, sizeof wire));
+ *     }
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ramfunc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef TELEMETRY_CHANNELS
+#define TELEMETRY_CHANNELS  3u      /**< Values per sample              */
+#endif
+
+#ifndef TELEMETRY_BATCH
+#define TELEMETRY_BATCH     16u     /**< Samples per frame              */
+#endif
+
+#if TELEMETRY_BATCH > 255u
+#error "TELEMETRY_BATCH must fit the frame's count byte"
+#endif
+
+/** Largest frame before COBS: seq, n, a 10-byte stamp, 5 bytes per value */
+#define TELEMETRY_FRAME_MAX (12u + 5u * TELEMETRY_CHANNELS * TELEMETRY_BATCH)
+
+/** Largest frame on the wire: two delimiters and one COBS byte per 254 */
+#define TELEMETRY_WIRE_MAX  (TELEMETRY_FRAME_MAX + TELEMETRY_FRAME_MAX / 254u + 3u)
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef struct
+{
+    uint8_t  frame[TELEMETRY_FRAME_MAX];    /**< Frame being built      */
+    uint32_t len;                           /**< Bytes in frame         */
+    uint32_t samples;                       /**< Samples in frame       */
+    int32_t  prev[TELEMETRY_CHANNELS];      /**< Last sample, for deltas */
+    uint8_t  seq;                           /**< Next frame number      */
+} telemetry_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Start with an empty frame and sequence number 0.
+ */
+void telemetry_init(telemetry_t *t);
+
+/**
+ * @brief  Append one sample.
+ * @param  values  TELEMETRY_CHANNELS values
+ * @param  stamp   Time of the sample; kept only for the keyframe
+ * @return true when the frame is full and must be flushed
+ */
+RAMFUNC bool telemetry_put(telemetry_t *t, const int32_t *values, uint64_t stamp);
+
+/**
+ * @brief  Emit the pending frame (if any) and start the next one.
+ * @param  out  Destination, at least TELEMETRY_WIRE_MAX bytes
+ * @return Bytes written to out, 0 if no sample was pending or out is
+ *         too small
+ */
+size_t telemetry_flush(telemetry_t *t, uint8_t *out, size_t cap);
+
+/* --------------------------------------------------------------------
+ * Codec primitives (exposed for tests and the decoder)
+ * ------------------------------------------------------------------*/
+
+/** Zig-zag map: small magnitudes of either sign become small codes */
+static inline uint32_t telemetry_zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t telemetry_unzigzag(uint32_t z)
+{
+    return (int32_t)(z >> 1) ^ -(int32_t)(z & 1u);
+}
+
+/**
+ * @brief  COBS-encode n bytes, adding the 0x00 delimiters on both sides.
+ * @return Bytes written, 0 if cap is too small
+ */
+size_t telemetry_cobs(const uint8_t *in, size_t n, uint8_t *out, size_t cap);
+
+/**
+ * @brief  Decode one COBS block, the bytes between the two delimiters.
+ * @return Bytes written to out, 0 if the block is malformed (a zero
+ *         byte or a code running past the end) or cap is too small
+ */
+size_t telemetry_uncobs(const uint8_t *in, size_t n, uint8_t *out, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* TELEMETRY_H */
@@ -0,0 +1,128 @@
+/**
+ * @file    capture.c
+ * @brief   Implementation of the triggered sample capture.
+ */
+
+#include "capture.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CAPTURE_MASK    (CAPTURE_DEPTH - 1u)
+#define CAPTURE_LEVELS  (CAPTURE_TRIG_ERROR | CAPTURE_TRIG_SATURATION)
+
+/* ----------------------------- Helpers ----------------------------- */
+RAMFUNC_INLINE uint32_t capture_levels(const capture_t *c,
+                                       const capture_sample_t *s, float setpoint)
+{
+    float e = setpoint - s->filtered;
+    uint32_t err = (e > c->err_threshold || -e > c->err_threshold);
+    uint32_t sat = (s->duty <= c->out_min || s->duty >= c->out_max);
+    return (err ? CAPTURE_TRIG_ERROR : 0u) | (sat ? CAPTURE_TRIG_SATURATION : 0u);
+}
+
+/* Thousandths, rounded half away from zero */
+static long capture_milli(float v)
+{
+    return (long)(v * 1000.0f + ((v < 0.0f) ? -0.5f : 0.5f));
+}
+
+/* --------------------------- Public API ---------------------------- */
+void capture_init(capture_t *c, uint32_t triggers, uint32_t pre,
+                  float err_threshold, float out_min, float out_max)
+{
+    memset(c, 0, sizeof(*c));
+    c->triggers      = triggers;
+    c->pre           = (pre < CAPTURE_DEPTH) ? pre : (CAPTURE_DEPTH - 1u);
+    c->err_threshold = err_threshold;
+    c->out_min       = out_min;
+    c->out_max       = out_max;
+    c->state         = CAPTURE_IDLE;
+}
+
+void capture_arm(capture_t *c)
+{
+    c->recorded   = 0u;
+    c->level_prev = CAPTURE_LEVELS;     /* present conditions must clear first */
+    c->forced     = 0u;
+    c->state      = CAPTURE_ARMED;
+}
+
+void capture_force(capture_t *c)
+{
+    c->forced = CAPTURE_TRIG_FORCE;
+}
+
+RAMFUNC bool capture_record(capture_t *c, const capture_sample_t *s, float setpoint)
+{
+    capture_state_t state = c->state;
+    if (state == CAPTURE_IDLE || state == CAPTURE_FROZEN) return false;
+
+    c->buf[c->head & CAPTURE_MASK] = *s;
+    c->head++;
+    c->recorded++;
+
+    if (state == CAPTURE_ARMED)
+    {
+        uint32_t level   = capture_levels(c, s, setpoint);
+        uint32_t changed = (c->recorded > 1u && setpoint != c->setpoint)
+                           ? CAPTURE_TRIG_SETPOINT : 0u;
+        uint32_t fired   = ((level & ~c->level_prev) | changed | c->forced)
+                           & (c->triggers | CAPTURE_TRIG_FORCE);
+        c->level_prev = level;
+        c->setpoint   = setpoint;
+        if (fired == 0u) return false;
+
+        c->cause     = fired;
+        c->t_trigger = s->t;
+        c->remaining = CAPTURE_DEPTH - c->pre;
+        c->state     = CAPTURE_POST;
+    }
+
+    if (--c->remaining != 0u) return false;
+
+    /* A trigger soon after arming leaves less than `pre` of history */
+    uint32_t post = CAPTURE_DEPTH - c->pre;
+    c->count      = (c->recorded < CAPTURE_DEPTH) ? c->recorded : CAPTURE_DEPTH;
+    c->trig_index = c->count - post;
+    c->captures++;
+    c->state      = CAPTURE_FROZEN;
+    return true;
+}
+
+const capture_sample_t *capture_sample(const capture_t *c, uint32_t i)
+{
+    return &c->buf[(c->head - c->count + i) & CAPTURE_MASK];
+}
+
+size_t capture_format(const capture_t *c, uint32_t n, uint32_t core_hz,
+                      char *buf, size_t len)
+{
+    int w;
+
+    if (n == 0u)
+    {
+        w = snprintf(buf, len, "scope_begin,%lu,%lu,%lu,%lu\n",
+                     (unsigned long)core_hz, (unsigned long)c->cause,
+                     (unsigned long)c->count, (unsigned long)c->trig_index);
+    }
+    else if (n <= c->count)
+    {
+        const capture_sample_t *s = capture_sample(c, n - 1u);
+        /* Unsigned subtraction handles CYCCNT wrap inside the window */
+        int32_t dt = (int32_t)(s->t - c->t_trigger);
+        w = snprintf(buf, len, "scope,%ld,%lu,%ld,%ld,%ld\n",
+                     (long)dt, (unsigned long)s->raw, capture_milli(s->filtered),
+                     capture_milli(s->duty), capture_milli(s->integral));
+    }
+    else if (n == c->count + 1u)
+    {
+        w = snprintf(buf, len, "scope_end\n");
+    }
+    else
+    {
+        return 0u;
+    }
+
+    if (w < 0) return 0u;
+    return ((size_t)w < len) ? (size_t)w : (len ? len - 1u : 0u);
+}
@@ -1,10 +1,24 @@
 #include "led_pwm.h"
 #include "stm32f4xx_hal.h"
+#include <stddef.h>
+
+// Command (Q16) → duty (Q16) by linear interpolation in the curve
+RAMFUNC_INLINE uint32_t applyCurve(const uint32_t* curve, uint32_t q16) {
+    uint32_t i = q16 >> LED_PWM_CURVE_SHIFT;
+    if (i >= LED_PWM_CURVE_SEGMENTS) return curve[LED_PWM_CURVE_SEGMENTS];
+    int32_t frac = (int32_t)(q16 & ((1u << LED_PWM_CURVE_SHIFT) - 1u));
+    int32_t step = (int32_t)(curve[i + 1u] - curve[i]);
+    return curve[i] + (uint32_t)((step * frac) >> LED_PWM_CURVE_SHIFT);
+}
 
 void LedPwm_init(LedPwm_t* led, TIM_HandleTypeDef* htim, uint32_t channel) {
     led->htim = htim;
     led->channel = channel;
     led->duty_percent = 0;
+    led->compare_q16 = 0;
+    led->sd_acc = 0;
+    led->dither = false;
+    led->curve = NULL;
 
     // Initialize the PWM channel
     HAL_TIM_PWM_Start(led->htim, led->channel);
@@ -29,11 +43,63 @@ void LedPwm_setDuty(LedPwm_t* led, uint8_t duty_percent) {
     if (duty_percent > 100) duty_percent = 100;
     led->duty_percent = duty_percent;
 
-    uint32_t period = led->htim->Init.Period;
-    uint32_t pulse = (period * duty_percent) / 100;
+    uint32_t pulse;
+    if (led->curve) {
+        LedPwm_setDutyQ16(led, ((uint32_t)duty_percent * LED_PWM_Q16_ONE) / 100u);
+        pulse = (led->compare_q16 + 0x8000u) >> 16;
+    } else {
+        uint32_t period = led->htim->Init.Period;
+        pulse = (period * duty_percent) / 100;
 
-    __HAL_TIM_SET_COMPARE(led->htim, led->channel, pulse);
+        led->compare_q16 = pulse << 16;
+        __HAL_TIM_SET_COMPARE(led->htim, led->channel, pulse);
+    }
 
     Log(LOG_LEVEL_DEBUG, "LED PWM duty cycle set to %d%% (pulse: %lu)\n", 
         led->duty_percent, pulse);
 }
+
+RAMFUNC void LedPwm_setDutyQ16(LedPwm_t* led, uint32_t duty_q16) {
+    if (duty_q16 > LED_PWM_Q16_ONE) duty_q16 = LED_PWM_Q16_ONE;
+    if (led->curve) duty_q16 = applyCurve(led->curve, duty_q16);
+
+    // Counts in Q16.16; full scale is Period + 1 counts
+    uint32_t counts = led->htim->Init.Period + 1u;
+    uint32_t compare = (uint32_t)((uint64_t)duty_q16 * counts);
+    led->compare_q16 = compare;
+
+    if (!led->dither) {
+        __HAL_TIM_SET_COMPARE(led->htim, led->channel, (compare + 0x8000u) >> 16);
+    }
+}
+
+RAMFUNC void LedPwm_setDutyFloat(LedPwm_t* led, float duty_percent) {
+    if (duty_percent < 0.0f) duty_percent = 0.0f;
+    if (duty_percent > 100.0f) duty_percent = 100.0f;
+    LedPwm_setDutyQ16(led, (uint32_t)(duty_percent * (LED_PWM_Q16_ONE / 100.0f) + 0.5f));
+}
+
+void LedPwm_setCurve(LedPwm_t* led, const uint32_t* curve) {
+    led->curve = curve;
+    Log(LOG_LEVEL_DEBUG, "LED PWM linearisation %s\n", curve ? "on" : "off");
+}
+
+void LedPwm_setDither(LedPwm_t* led, bool enable) {
+    led->sd_acc = 0;
+    led->dither = enable;
+    if (enable) {
+        __HAL_TIM_ENABLE_IT(led->htim, TIM_IT_UPDATE);
+    } else {
+        __HAL_TIM_DISABLE_IT(led->htim, TIM_IT_UPDATE);
+        __HAL_TIM_SET_COMPARE(led->htim, led->channel, (led->compare_q16 + 0x8000u) >> 16);
+    }
+    Log(LOG_LEVEL_DEBUG, "LED PWM dithering %s\n", enable ? "on" : "off");
+}
+
+RAMFUNC void LedPwm_periodElapsed(LedPwm_t* led) {
+    // First-order sigma-delta: the fraction accumulates, its carry is the extra count
+    uint32_t compare = led->compare_q16;
+    uint32_t sum = led->sd_acc + (compare & 0xFFFFu);
+    led->sd_acc = sum & 0xFFFFu;
+    __HAL_TIM_SET_COMPARE(led->htim, led->channel, (compare >> 16) + (sum >> 16));
+}
@@ -43,9 +43,43 @@
 #define LOG_RING_BUFFER_SIZE 1024
 #endif
 
+#ifndef LOG_UART_MAX_ITERATIONS
+#define LOG_UART_MAX_ITERATIONS 64  // Max bytes consumed per Log_Poll() call
+#endif
+
+#ifndef LOG_RX_BUFFER_SIZE
+#define LOG_RX_BUFFER_SIZE 256      // Received bytes waiting for Log_Poll()
+#endif
+
+#ifndef LOG_FRAME_MAX
+#define LOG_FRAME_MAX 128           // Longest binary frame, COBS-encoded
+#endif
+
+// Interrupt reception whenever transmission is non-blocking
+#define LOG_RX_IT (LOG_USE_UART && (LOG_USE_DMA || LOG_USE_IT))
+
+#ifndef LOG_SD_SECTOR_SIZE
+#define LOG_SD_SECTOR_SIZE 512      // Card sector; writes are aligned to it
+#endif
+
+#ifndef LOG_SD_BLOCK_SECTORS
+#define LOG_SD_BLOCK_SECTORS 4      // Sectors per f_write() (2 KB)
+#endif
+
+#ifndef LOG_SD_SYNC_MS
+#define LOG_SD_SYNC_MS 1000         // Longest time data waits in RAM
+#endif
+
+#define LOG_SD_BLOCK_SIZE (LOG_SD_SECTOR_SIZE * LOG_SD_BLOCK_SECTORS)
+
 static LogLevel current_level = LOG_LEVEL_INFO;
 static uint8_t logging_enabled = 1;
 
+static Log_ClockSource clock_read = NULL;
+static uint32_t clock_hz = 0;
+static uint32_t clock_last = 0;             // Counter at the previous read
+static uint32_t clock_high = 0;             // Wraps counted: the upper 32 bits
+
 static char ring_buffer[LOG_RING_BUFFER_SIZE];
 static volatile uint16_t head = 0;
 static volatile uint16_t tail = 0;
@@ -60,13 +94,25 @@ extern UART_HandleTypeDef LOG_UART_HANDLE;
 #if LOG_USE_SD
 static FIL log_file;
 static uint8_t sd_initialized = 0;
+
+/* Log_Write_SD() fills one block while Log_Service() writes the other.
+ * Each block starts on a block boundary of the file, so FatFS writes
+ * whole sectors straight to the card without going through its window. */
+static uint8_t sd_buf[2][LOG_SD_BLOCK_SIZE] __attribute__((aligned(4)));
+static uint8_t sd_active;                   // Block being filled
+static uint32_t sd_fill;                    // Bytes in the active block
+static uint32_t sd_cap;                     // Its size (the first may be short)
+static volatile uint8_t sd_pending;         // The other block awaits f_write()
+static uint8_t sd_unsynced;                 // Data written since the last f_sync()
+static uint32_t sd_last_sync;               // now_ms of the last sync
+static LogSdStats sd_stats;
 #endif
 
 /**
  * @brief Writes a string into the ring buffer for non-blocking UART output.
  * @param data Null-terminated string to enqueue.
  */ 
-static void ring_buffer_write(const char* data) {
+RAMFUNC static void ring_buffer_write(const char* data) {
     while (*data) {
         uint16_t next = (head + 1) % LOG_RING_BUFFER_SIZE;
         if (next == tail) break; // Buffer full
@@ -75,6 +121,15 @@ static void ring_buffer_write(const char* data) {
     }
 }
 
+#if LOG_USE_UART && (LOG_USE_DMA || LOG_USE_IT)
+/**
+ * @brief Free bytes in the ring buffer (one slot stays empty).
+ */
+RAMFUNC static uint16_t ring_buffer_free(void) {
+    return (uint16_t)((tail + LOG_RING_BUFFER_SIZE - head - 1) % LOG_RING_BUFFER_SIZE);
+}
+#endif
+
 /**
  * @brief Starts or continues sending data from the ring buffer via UART.
  */
@@ -104,20 +159,66 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
     }
 }
 
+#if LOG_RX_IT
+static uint8_t rx_ring[LOG_RX_BUFFER_SIZE];
+static volatile uint16_t rx_head = 0;
+static volatile uint16_t rx_tail = 0;
+static uint8_t rx_byte;
+
+/**
+ * @brief UART reception complete callback: queues the byte for Log_Poll().
+ *        A byte that finds the ring full is lost.
+ * @param huart Pointer to the HAL UART handle.
+ */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart->Instance == LOG_UART_HANDLE.Instance) {
+        uint16_t next = (rx_head + 1) % LOG_RX_BUFFER_SIZE;
+        if (next != rx_tail) {
+            rx_ring[rx_head] = rx_byte;
+            rx_head = next;
+        }
+        HAL_UART_Receive_IT(&LOG_UART_HANDLE, &rx_byte, 1);
+    }
+}
+
+/**
+ * @brief UART error callback: an overrun or framing error stops the
+ *        HAL reception, so restart it.
+ * @param huart Pointer to the HAL UART handle.
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    if (huart->Instance == LOG_UART_HANDLE.Instance) {
+        HAL_UART_Receive_IT(&LOG_UART_HANDLE, &rx_byte, 1);
+    }
+}
+#endif
+
 /**
  * @brief Initializes the logging system.
  *
  * - Resets the ring buffer
  * - Enables logging
+ * - Starts interrupt reception for Log_Poll()
  * - Opens SD file if SD logging is enabled
  */
 void Log_Init(void) {
     head = tail = 0;
     logging_enabled = 1;
+#if LOG_RX_IT
+    rx_head = rx_tail = 0;
+    HAL_UART_Receive_IT(&LOG_UART_HANDLE, &rx_byte, 1);
+#endif
 #if LOG_USE_SD
     if (f_open(&log_file, "log.txt", FA_OPEN_ALWAYS | FA_WRITE) == FR_OK) {
         f_lseek(&log_file, f_size(&log_file));
         sd_initialized = 1;
+        /* Fill up to the next block boundary first, then whole blocks */
+        sd_active = 0;
+        sd_fill = 0;
+        sd_cap = LOG_SD_BLOCK_SIZE - (uint32_t)(f_size(&log_file) % LOG_SD_BLOCK_SIZE);
+        sd_pending = 0;
+        sd_unsynced = 0;
+        memset(&sd_stats, 0, sizeof(sd_stats));
     }
 #endif
 }
@@ -137,10 +238,90 @@ void Log_Disable(void) {
     logging_enabled = 0;
 }
 
+/**
+ * @brief Selects the counter that stamps each message; NULL turns stamps off.
+ * @param read Free-running 32-bit counter.
+ * @param hz Its rate, for the sync records.
+ */
+void Log_SetClock(Log_ClockSource read, uint32_t hz) {
+    clock_read = read;
+    clock_hz = hz;
+    clock_last = read ? read() : 0;
+    clock_high = 0;
+}
+
+/**
+ * @brief Reads the counter and extends it to 64 bits.
+ *
+ * A reading below the previous one means the counter wrapped in between;
+ * that holds as long as reads are less than one wrap apart.  The read and
+ * the update run with interrupts masked: an ISR logging in between would
+ * otherwise store a later reading, and this one would count a false wrap.
+ */
+RAMFUNC uint64_t Log_Timestamp(void) {
+    if (!clock_read) return 0;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t now = clock_read();
+    if (now < clock_last) clock_high++;
+    clock_last = now;
+    uint32_t high = clock_high;
+    __set_PRIMASK(primask);
+    return ((uint64_t)high << 32) | now;
+}
+
+/**
+ * @brief Formats `@<hex>:` by hand (newlib-nano's printf has no %llx).
+ */
+size_t Log_FormatStamp(uint64_t stamp, char* buf, size_t size) {
+    char digits[16];
+    size_t n = 0;
+    do {
+        digits[n++] = "0123456789abcdef"[stamp & 0xF];
+        stamp >>= 4;
+    } while (stamp);
+
+    if (size < n + 3) {
+        if (size > 0) buf[0] = '\0';
+        return 0;
+    }
+    size_t w = 0;
+    buf[w++] = '@';
+    while (n > 0) buf[w++] = digits[--n];
+    buf[w++] = ':';
+    buf[w] = '\0';
+    return w;
+}
+
+/**
+ * @brief Sends a sync record, only when nothing is queued ahead of it.
+ * @return true if sent.
+ */
+bool Log_Sync(void) {
+    uint64_t stamp = Log_Timestamp();
+    if (!logging_enabled || !clock_read) return false;
+#if LOG_USE_UART && (LOG_USE_DMA || LOG_USE_IT)
+    if (head != tail) return false;  // Would wait behind the queued bytes
+#endif
+
+    char buffer[LOG_STAMP_MAX + 16];
+    size_t n = Log_FormatStamp(stamp, buffer, sizeof(buffer));
+    snprintf(buffer + n, sizeof(buffer) - n, "sync,%lu\n", (unsigned long)clock_hz);
+
+#if LOG_USE_UART
+    Log_Write_UART(buffer);
+#endif
+#if LOG_USE_SD
+    Log_Write_SD(buffer);
+#endif
+    return true;
+}
+
 /**
  * @brief Logs a formatted message based on severity level.
  *
  * - Message is dropped if below current log level or if logging is disabled.
+ * - With a clock set, it is prefixed with the time stamp taken on entry.
  * - Output is routed to UART and/or SD depending on configuration.
  *
  * @param level Severity level (LOG_LEVEL_ERROR, etc.)
@@ -150,10 +331,11 @@ void Log_Disable(void) {
 void Log(LogLevel level, const char* format, ...) {
     if (!logging_enabled || level > current_level) return;
 
-    char buffer[LOG_BUFFER_SIZE];
+    char buffer[LOG_STAMP_MAX - 1 + LOG_BUFFER_SIZE];  // The stamp takes no message room
+    size_t stamp = clock_read ? Log_FormatStamp(Log_Timestamp(), buffer, sizeof(buffer)) : 0;
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    vsnprintf(buffer + stamp, sizeof(buffer) - stamp, format, args);
     va_end(args);
 
 #if LOG_USE_UART
@@ -165,22 +347,129 @@ void Log(LogLevel level, const char* format, ...) {
 }
 
 /**
- * @brief Forces a flush of buffered data to the SD card.
+ * @brief Queues a binary frame for UART output, all or nothing.
+ * @param data Bytes to enqueue.
+ * @param len Number of bytes.
+ * @return true if queued.
+ */
+RAMFUNC bool Log_WriteBytes(const uint8_t* data, size_t len) {
+#if LOG_USE_UART && (LOG_USE_DMA || LOG_USE_IT)
+    if (!logging_enabled || len > ring_buffer_free()) return false;
+    for (size_t i = 0; i < len; i++) {
+        ring_buffer[head] = (char)data[i];
+        head = (head + 1) % LOG_RING_BUFFER_SIZE;
+    }
+    ring_buffer_send_next();
+    return true;
+#elif LOG_USE_UART
+    if (!logging_enabled) return false;
+    return HAL_UART_Transmit(&LOG_UART_HANDLE, (uint8_t*)data, len, HAL_MAX_DELAY) == HAL_OK;
+#else
+    (void)data;
+    (void)len;
+    return false;
+#endif
+}
+
+#if LOG_USE_SD
+/**
+ * @brief Hands a full active block to Log_Service() if the other one is free.
+ */
+static void sd_rotate(void) {
+    if (sd_fill < sd_cap || sd_pending) return;
+    sd_pending = 1;
+    sd_active ^= 1;
+    sd_fill = 0;
+    sd_cap = LOG_SD_BLOCK_SIZE;
+}
+
+/**
+ * @brief Writes the pending block: one aligned multi-sector f_write().
+ */
+static void sd_write_pending(void) {
+    UINT bw;
+    /* Only the first block can start off a boundary; it ends on one */
+    uint32_t len = (uint32_t)(LOG_SD_BLOCK_SIZE - f_tell(&log_file) % LOG_SD_BLOCK_SIZE);
+    const uint8_t* block = &sd_buf[sd_active ^ 1][LOG_SD_BLOCK_SIZE - len];
+    if (f_write(&log_file, block, len, &bw) != FR_OK || bw != len) sd_stats.errors++;
+    sd_stats.blocks++;
+    sd_pending = 0;
+    sd_unsynced = 1;
+    sd_rotate();
+}
+
+/**
+ * @brief Commits everything logged so far.
+ *
+ * The partly filled block is written too, and the file pointer moves back
+ * to its start: the block stays in RAM and is written again, whole and
+ * aligned, once full.
+ */
+static void sd_sync(void) {
+    if (sd_fill > 0) {
+        UINT bw;
+        FSIZE_t start = f_tell(&log_file);
+        const uint8_t* data = &sd_buf[sd_active][LOG_SD_BLOCK_SIZE - sd_cap];
+        if (f_write(&log_file, data, sd_fill, &bw) != FR_OK || bw != sd_fill) sd_stats.errors++;
+        f_lseek(&log_file, start);
+        sd_stats.partial_writes++;
+        sd_unsynced = 1;
+    }
+    if (sd_unsynced) {
+        if (f_sync(&log_file) != FR_OK) sd_stats.errors++;
+        sd_stats.syncs++;
+        sd_unsynced = 0;
+    }
+}
+#endif
+
+/**
+ * @brief Forces all buffered data to the SD card (blocking).
  */
 void Log_Flush(void) {
 #if LOG_USE_SD
     if (sd_initialized) {
-        f_sync(&log_file);
+        if (sd_pending) sd_write_pending();
+        sd_sync();
     }
 #endif
 }
 
+/**
+ * @brief Background SD work: at most one block write or one sync per call.
+ * @param now_ms Millisecond time stamp, for the sync interval.
+ */
+void Log_Service(uint32_t now_ms) {
+#if LOG_USE_SD
+    if (!sd_initialized) return;
+    sd_rotate();
+    if (sd_pending) {
+        sd_write_pending();
+        return;
+    }
+    if (now_ms - sd_last_sync >= LOG_SD_SYNC_MS) {
+        sd_last_sync = now_ms;
+        sd_sync();
+    }
+#else
+    (void)now_ms;
+#endif
+}
+
+void Log_GetSdStats(LogSdStats* stats) {
+#if LOG_USE_SD
+    *stats = sd_stats;
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
 /**
  * @brief Default UART log output (weak).
  *        Can be overridden for custom UART routing or formatting.
  * @param msg Null-terminated string to send.
  */
-__attribute__((weak)) void Log_Write_UART(const char* msg) {
+RAMFUNC __attribute__((weak)) void Log_Write_UART(const char* msg) {
 #if LOG_USE_DMA || LOG_USE_IT
     ring_buffer_write(msg);
     ring_buffer_send_next();
@@ -196,10 +485,27 @@ __attribute__((weak)) void Log_Write_UART(const char* msg) {
  */
 __attribute__((weak)) void Log_Write_SD(const char* msg) {
 #if LOG_USE_SD
-    if (sd_initialized) {
-        UINT bw;
-        f_write(&log_file, msg, strlen(msg), &bw);
+    if (!sd_initialized) return;
+
+    /* Whole messages only: a line that does not fit is dropped, not cut */
+    uint32_t len = (uint32_t)strlen(msg);
+    uint32_t room = (sd_cap - sd_fill) + (sd_pending ? 0 : LOG_SD_BLOCK_SIZE);
+    if (len > room) {
+        sd_stats.dropped_msgs++;
+        sd_stats.dropped_bytes += len;
+        return;
     }
+    while (len > 0) {
+        uint32_t n = sd_cap - sd_fill;
+        if (n > len) n = len;
+        memcpy(&sd_buf[sd_active][LOG_SD_BLOCK_SIZE - sd_cap + sd_fill], msg, n);
+        sd_fill += n;
+        msg += n;
+        len -= n;
+        sd_rotate();
+    }
+#else
+    (void)msg;
 #endif
 }
 
@@ -207,42 +513,117 @@ __attribute__((weak)) void Log_Write_SD(const char* msg) {
 
 static char cmd_buffer[64];
 static uint8_t cmd_index = 0;
+static uint8_t cmd_drop = 0;    // Skip to the next delimiter: an overlong frame's rest
 static Log_CommandCallback cmd_callback = NULL;
 
+static uint8_t frame_buffer[LOG_FRAME_MAX];
+static uint16_t frame_index = 0;
+static uint8_t in_frame = 0;
+static uint8_t frame_text = 1;  // Only printable bytes since the last 0x00
+static Log_FrameCallback frame_callback = NULL;
+
 void Log_SetCommandCallback(Log_CommandCallback cb)
 {
     cmd_callback = cb;
 }
 
+void Log_SetFrameCallback(Log_FrameCallback cb)
+{
+    frame_callback = cb;
+}
+
 __attribute__((weak)) void Log_CommandReceived(const char* cmd)
 {
     Log(LOG_LEVEL_INFO, "CMD: %s\n", cmd);
 }
 
+/**
+ * @brief Next received byte, from the interrupt ring or polled from the UART.
+ */
+static int poll_byte(uint8_t* byte)
+{
+#if LOG_RX_IT
+    if (rx_tail == rx_head) return 0;
+    *byte = rx_ring[rx_tail];
+    rx_tail = (rx_tail + 1) % LOG_RX_BUFFER_SIZE;
+    return 1;
+#elif LOG_USE_UART
+    return HAL_UART_Receive(&LOG_UART_HANDLE, byte, 1, 0) == HAL_OK;
+#else
+    (void)byte;
+    return 0;
+#endif
+}
+
+/**
+ * @brief Assembles text commands; a 0x00 opens a frame.
+ */
+static void poll_text_byte(uint8_t byte)
+{
+    if (byte == 0x00) {
+        in_frame = 1;
+        frame_index = 0;
+        frame_text = 1;
+        cmd_drop = 0;
+    } else if (byte == '\n' || byte == '\r') {
+        if (cmd_index > 0 && !cmd_drop) {
+            cmd_buffer[cmd_index] = '\0';
+            if (cmd_callback) {
+                cmd_callback(cmd_buffer);
+            } else {
+                Log_CommandReceived(cmd_buffer);
+            }
+        }
+        cmd_index = 0;
+        cmd_drop = 0;
+    } else if (cmd_index < sizeof(cmd_buffer) - 2) {
+        cmd_buffer[cmd_index++] = (char)byte;
+    }
+}
+
+/**
+ * @brief Collects the bytes between two 0x00 delimiters.  A frame the
+ *        callback rejects is taken to be the tail of a frame joined
+ *        midway, so its closing 0x00 opens the next.  Text mode returns
+ *        when no callback is set, after LOG_FRAME_MAX bytes without a
+ *        delimiter, or at a line end after only printable bytes: that was
+ *        a command behind a stray 0x00.  A COBS frame's first byte is the
+ *        distance to its first zero, so a short frame is never printable.
+ */
+static void poll_frame_byte(uint8_t byte)
+{
+    if (byte == 0x00) {
+        if (frame_callback == NULL ||
+            (frame_index > 0 && frame_callback(frame_buffer, frame_index))) {
+            in_frame = 0;
+        }
+        frame_index = 0;
+        frame_text = 1;
+    } else if ((byte == '\n' || byte == '\r') && frame_text) {
+        in_frame = 0;
+        for (uint16_t i = 0; i < frame_index; i++) poll_text_byte(frame_buffer[i]);
+        poll_text_byte(byte);
+    } else if (frame_index == sizeof(frame_buffer)) {
+        in_frame = 0;
+        cmd_drop = 1;
+    } else {
+        frame_buffer[frame_index++] = byte;
+        frame_text &= (byte >= 0x20 && byte < 0x7F);
+    }
+}
+
 void Log_Poll(void)
 {
-#if LOG_USE_UART
     uint8_t byte;
     uint16_t iteration_count = 0; // Counter to track iterations
-    while (HAL_UART_Receive(&LOG_UART_HANDLE, &byte, 1, 0) == HAL_OK) {
-        if (++iteration_count > LOG_UART_MAX_ITERATIONS) {
-            break; // Exit the loop if the maximum iteration count is reached
-        }
-        if (byte == '\n' || byte == '\r') {
-            if (cmd_index > 0) {
-                cmd_buffer[cmd_index] = '\0';
-                if (cmd_callback) {
-                    cmd_callback(cmd_buffer);
-                } else {
-                    Log_CommandReceived(cmd_buffer);
-                }
-                cmd_index = 0;
-            }
-        } else if (cmd_index < sizeof(cmd_buffer) - 2) {
-            cmd_buffer[cmd_index++] = (char)byte;
+    // Stop at the limit before taking a byte, so none is lost
+    while (iteration_count++ < LOG_UART_MAX_ITERATIONS && poll_byte(&byte)) {
+        if (in_frame) {
+            poll_frame_byte(byte);
+        } else {
+            poll_text_byte(byte);
         }
     }
-#endif
 }
 
 void Log_Telemetry(uint8_t lux_percent, uint8_t duty_percent)
@@ -0,0 +1,54 @@
+#include "lowpower.h"
+#include "stm32f4xx_hal.h"
+#include "dwt.h"
+
+static uint32_t busy_cycles = 0;      // Awake cycles in current window
+static uint32_t wake_stamp = 0;       // CYCCNT when the core last woke
+static uint32_t window_start_ms = 0;  // HAL tick at start of window
+static uint32_t wakeups = 0;          // WFI returns in current window
+
+void LowPower_init(void) {
+    busy_cycles = 0;
+    wakeups = 0;
+    wake_stamp = dwt_cycles();
+    window_start_ms = HAL_GetTick();
+}
+
+void LowPower_waitFor(volatile bool* flag) {
+#if LOWPOWER_USE_WFI
+    __disable_irq();
+    while (!*flag) {
+        busy_cycles += dwt_cycles() - wake_stamp;
+        __DSB();
+        __WFI();                    // Pending IRQ wakes us even with PRIMASK set
+        wake_stamp = dwt_cycles();
+        wakeups++;
+        __enable_irq();             // Let the pending handler run
+        __ISB();
+        __disable_irq();
+    }
+    __enable_irq();
+#else
+    while (!*flag) {
+    }
+#endif
+}
+
+uint32_t LowPower_idlePermille(uint32_t* wakeups_out) {
+    uint32_t now_ms = HAL_GetTick();
+    uint32_t now_cyc = dwt_cycles();
+
+    __disable_irq();
+    uint32_t busy = busy_cycles + (now_cyc - wake_stamp);
+    busy_cycles = 0;
+    wake_stamp = now_cyc;
+    if (wakeups_out) *wakeups_out = wakeups;
+    wakeups = 0;
+    __enable_irq();
+
+    uint64_t span = (uint64_t)(now_ms - window_start_ms) * (SystemCoreClock / 1000u);
+    window_start_ms = now_ms;
+
+    if (span == 0 || busy >= span) return 0;
+    return (uint32_t)(1000u - (busy * 1000ull) / span);
+}
@@ -23,8 +23,17 @@
 /* USER CODE BEGIN Includes */
 #include "photocell.h"
 #include "led_pwm.h"
+#include "led_gamma_table.h"
 #include "logger.h"
 #include "pid.h"
+#include "looptime.h"
+#include "capture.h"
+#include "telemetry.h"
+#include "onchange.h"
+#include "param.h"
+#include "dwt.h"
+#include "timebase.h"
+#include "lowpower.h"
 
 /* USER CODE END Includes */
 
@@ -35,7 +44,32 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+#define CONTROL_PERIOD_MS     10u     /* Control loop period            */
+#define CONTROL_DEADLINE_US   2000u   /* Execution budget per iteration */
+#define LOOPTIME_REPORT_MS    1000u   /* Timing report interval         */
+#define LOG_SYNC_MS           1000u   /* Clock sync record interval (host drift fit) */
+
+#ifndef LED_LINEARIZE
+#define LED_LINEARIZE         1       /* 1: equalise the loop gain via led_gamma_table.h */
+#endif
+
+#ifndef SCOPE_ENABLE
+#define SCOPE_ENABLE          1       /* 1: capture a window around each trigger */
+#endif
+#define SCOPE_PRE_TRIGGER     64u     /* Iterations kept from before the trigger */
+#define SCOPE_ERROR_LEVEL     20.0f   /* Error trigger, in reading units (%) */
+#define SCOPE_LINE_MS         5u      /* One read-out line per interval (115200 baud) */
+
+#ifndef TELEMETRY_STREAM
+#define TELEMETRY_STREAM      1       /* 1: every sample as binary delta frames */
+#endif
+#ifndef TELEMETRY_ON_CHANGE
+#define TELEMETRY_ON_CHANGE   1       /* 1: chg lines when a channel leaves its deadband */
+#endif
+
+#ifndef PARAM_PROTOCOL
+#define PARAM_PROTOCOL        1       /* 1: binary get/set/list of the tunables (param.h) */
+#endif
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -81,6 +115,82 @@ LedPwm_t led_pwm = {
 
 pid_t led_ctrl = PID_DEFAULTS;
 
+looptime_t loop_timing;
+
+#if SCOPE_ENABLE
+static capture_t scope;               /* ~5 KB window */
+static uint32_t  scope_line;
+#endif
+
+#if TELEMETRY_STREAM
+static telemetry_t tlm;
+static uint32_t    tlm_frames;
+static uint32_t    tlm_dropped;
+#endif
+
+#if TELEMETRY_ON_CHANGE
+/* Deadbands above the peak-to-peak ADC noise (the duty sees it times Kp);
+ * a heartbeat per channel every second */
+static const onchange_channel_t chg_cfg[ONCHANGE_CHANNELS] = {
+    {  32, 1000u },                   /* raw counts (~0.8 %)           */
+    { 100, 1000u },                   /* duty, hundredths of a percent  */
+    { 100, 1000u },                   /* error, hundredths of a percent */
+};
+static onchange_t chg;
+static uint32_t   chg_dropped;
+#endif
+
+#if PARAM_PROTOCOL
+static uint32_t control_period_ms = CONTROL_PERIOD_MS;
+
+/* IDs are the host's addresses: keep them stable, append new ones.
+ * Ranges are per entry; out_min <= out_max is up to the tool */
+static const param_def_t param_defs[] = {
+    {  1u, PARAM_F32, 0u, "kp",        &led_ctrl.Kp,       0.0f, 10.0f   },
+    {  2u, PARAM_F32, 0u, "setpoint",  &led_ctrl.setpoint, 0.0f, 100.0f  },
+    {  3u, PARAM_F32, 0u, "out_min",   &led_ctrl.out_min,  0.0f, 100.0f  },
+    {  4u, PARAM_F32, 0u, "out_max",   &led_ctrl.out_max,  0.0f, 100.0f  },
+#if TELEMETRY_ON_CHANGE
+    { 10u, PARAM_I32, 0u, "chg_db_raw",  &chg.cfg[0].deadband, 0.0f, 4095.0f  },
+    { 11u, PARAM_I32, 0u, "chg_db_duty", &chg.cfg[1].deadband, 0.0f, 10000.0f },
+    { 12u, PARAM_I32, 0u, "chg_db_err",  &chg.cfg[2].deadband, 0.0f, 10000.0f },
+    { 13u, PARAM_U32, 0u, "chg_hb_raw",  &chg.cfg[0].max_ms,   0.0f, 60000.0f },
+    { 14u, PARAM_U32, 0u, "chg_hb_duty", &chg.cfg[1].max_ms,   0.0f, 60000.0f },
+    { 15u, PARAM_U32, 0u, "chg_hb_err",  &chg.cfg[2].max_ms,   0.0f, 60000.0f },
+#endif
+#if SCOPE_ENABLE
+    { 20u, PARAM_F32, 0u, "scope_err", &scope.err_threshold, 0.0f, 100.0f },
+#endif
+    { 30u, PARAM_U32, PARAM_READ_ONLY, "period_ms", &control_period_ms, 0.0f, 1000.0f },
+};
+static param_registry_t params;
+#endif
+
+/* Time stamps of log records and telemetry frames, in TIM5 ticks */
+static uint32_t log_clock(void)
+{
+    return timebase_ticks();
+}
+
+#if PARAM_PROTOCOL
+/* A request from the tuning tool: decode, answer, encode.  Returns false
+ * for a block that is not a valid request, so the logger resynchronises */
+static bool param_frame(const uint8_t *frame, size_t len)
+{
+    uint8_t req[PARAM_FRAME_MAX];
+    uint8_t resp[PARAM_FRAME_MAX];
+    uint8_t wire[PARAM_FRAME_MAX + PARAM_FRAME_MAX / 254u + 3u];
+
+    size_t n = telemetry_uncobs(frame, len, req, sizeof(req));
+    if (n == 0u) return false;
+    n = param_handle(&params, req, n, resp, sizeof(resp));
+    if (n == 0u) return false;
+
+    Log_WriteBytes(wire, telemetry_cobs(resp, n, wire, sizeof(wire)));
+    return resp[2] != PARAM_ERR_CRC;
+}
+#endif
+
 void app_init(void)
 {
     pid_init(&led_ctrl, 1.2f, 60.0f, 0.0f, 100.0f);
@@ -93,7 +203,130 @@ void app_init(void)
 
     LedPwm_init(&led_pwm, &htim2, TIM_CHANNEL_2);
     LedPwm_start(&led_pwm);
+    LedPwm_setDither(&led_pwm, true);   /* sub-count duty via TIM2 update IRQ */
+#if LED_LINEARIZE
+    LedPwm_setCurve(&led_pwm, led_gamma_table);
+#endif
+
+    dwt_init();                         /* busy time, counted while awake */
+    timebase_init();                    /* wall time, counts through WFI */
+    Log_SetClock(log_clock, timebase_hz());
+    looptime_init(&loop_timing,
+                  timebase_us_to_ticks(CONTROL_PERIOD_MS * 1000u),
+                  timebase_us_to_ticks(CONTROL_DEADLINE_US));
+    LowPower_init();
+
+#if SCOPE_ENABLE
+    capture_init(&scope,
+                 CAPTURE_TRIG_SETPOINT | CAPTURE_TRIG_ERROR | CAPTURE_TRIG_SATURATION,
+                 SCOPE_PRE_TRIGGER, SCOPE_ERROR_LEVEL,
+                 led_ctrl.out_min, led_ctrl.out_max);
+    capture_arm(&scope);
+#endif
+#if TELEMETRY_STREAM
+    telemetry_init(&tlm);
+#endif
+#if TELEMETRY_ON_CHANGE
+    onchange_init(&chg, chg_cfg);
+    for (uint32_t ch = 0; ch < ONCHANGE_CHANNELS; ch++)
+        Log(LOG_LEVEL_INFO, "chg_cfg,%lu,%ld,%lu\n", (unsigned long)ch,
+            (long)chg_cfg[ch].deadband, (unsigned long)chg_cfg[ch].max_ms);
+#endif
+#if PARAM_PROTOCOL
+    param_init(&params, param_defs, sizeof(param_defs) / sizeof(param_defs[0]));
+    Log_SetFrameCallback(param_frame);
+#endif
+}
+
+/* Timing report goes through the non-blocking logger ring buffer */
+static void report_looptime(void)
+{
+    char buf[LOG_BUFFER_SIZE];
+    looptime_format(&loop_timing, buf, sizeof(buf));
+    Log(LOG_LEVEL_INFO, "%s", buf);
+    uint32_t wakeups;
+    uint32_t idle = LowPower_idlePermille(&wakeups);
+    Log(LOG_LEVEL_INFO, "idle,permille=%lu,wakeups=%lu\n",
+        (unsigned long)idle, (unsigned long)wakeups);
+#if TELEMETRY_STREAM
+    Log(LOG_LEVEL_INFO, "tlm,frames=%lu,dropped=%lu\n",
+        (unsigned long)tlm_frames, (unsigned long)tlm_dropped);
+#endif
+#if TELEMETRY_ON_CHANGE
+    Log(LOG_LEVEL_INFO, "chg_stats,samples=%lu,reports=%lu,values=%lu,dropped=%lu\n",
+        (unsigned long)chg.samples, (unsigned long)chg.reports,
+        (unsigned long)chg.values, (unsigned long)chg_dropped);
+#endif
+#if PARAM_PROTOCOL
+    Log(LOG_LEVEL_INFO, "param,frames=%lu,errors=%lu,commits=%lu\n",
+        (unsigned long)params.frames, (unsigned long)params.errors,
+        (unsigned long)params.commits);
+#endif
+}
+
+#if TELEMETRY_STREAM || TELEMETRY_ON_CHANGE
+/* Telemetry channels: raw counts, duty and error in hundredths */
+static void telemetry_values(int32_t *v, float lux_pct, float duty)
+{
+    v[0] = (int32_t)photocell.last_raw_value;
+    v[1] = (int32_t)(duty * 100.0f + 0.5f);
+    v[2] = (int32_t)((led_ctrl.setpoint - lux_pct) * 100.0f);
 }
+#endif
+
+#if TELEMETRY_STREAM
+/* A full frame goes out whole or is counted as dropped.  The frame's
+ * stamp is its first sample's, taken after sense/compute/actuate */
+static void telemetry_sample(float lux_pct, float duty)
+{
+    int32_t v[TELEMETRY_CHANNELS];
+    telemetry_values(v, lux_pct, duty);
+    if (!telemetry_put(&tlm, v, Log_Timestamp())) return;
+
+    static uint8_t wire[TELEMETRY_WIRE_MAX];
+    size_t n = telemetry_flush(&tlm, wire, sizeof(wire));
+    if (Log_WriteBytes(wire, n)) tlm_frames++;
+    else                         tlm_dropped++;
+}
+#endif
+
+#if TELEMETRY_ON_CHANGE
+/* Channels that left their deadband or are due a heartbeat.  A line the
+ * logger cannot take is counted, and every channel is reported again
+ * on the next sample so the host's held values catch up */
+static void onchange_sample(uint32_t t_ms, float lux_pct, float duty)
+{
+    int32_t v[ONCHANGE_CHANNELS];
+    telemetry_values(v, lux_pct, duty);
+    uint32_t due = onchange_update(&chg, t_ms, v);
+    if (due == 0u) return;
+
+    char buf[LOG_STAMP_MAX + ONCHANGE_LINE_MAX];
+    size_t n = Log_FormatStamp(Log_Timestamp(), buf, sizeof(buf));
+    n += onchange_format(t_ms, due, v, buf + n, sizeof(buf) - n);
+    if (!Log_WriteBytes((const uint8_t *)buf, n))
+    {
+        chg_dropped++;
+        onchange_force(&chg);
+    }
+}
+#endif
+
+#if SCOPE_ENABLE
+/* One line of the frozen window per call, so the read-out never fills
+ * the logger ring; re-arms after the last line */
+static void scope_readout(void)
+{
+    char buf[64];
+    if (capture_format(&scope, scope_line++, timebase_hz(), buf, sizeof(buf)))
+    {
+        Log(LOG_LEVEL_INFO, "%s", buf);
+        return;
+    }
+    scope_line = 0u;
+    capture_arm(&scope);
+}
+#endif
 
 /* USER CODE END 0 */
 
@@ -134,6 +367,7 @@ int main(void)
   app_init();
 
   uint32_t t_ms = 0;
+  uint32_t sync_ms = 0;
 
   /* USER CODE END 2 */
 
@@ -145,21 +379,53 @@ int main(void)
 
     /* USER CODE BEGIN 3 */
 
-    /* 1-kHz time-base ----------------------------------------- */
-    if (!tick_1ms) continue;
+    /* 1-kHz time-base: sleep until SysTick ------------------- */
+    LowPower_waitFor(&tick_1ms);
     tick_1ms = false;
     t_ms++;
 
+    /* Host commands and parameter frames ---------------------- */
+    Log_Poll();
+
     /* Every 10 ms: sample sensor & update control ------------- */
-    if (t_ms % 10 == 0)
+    if (t_ms % CONTROL_PERIOD_MS == 0)
     {
+        uint32_t t0 = timebase_ticks();
+        looptime_begin(&loop_timing, t0);
+#if PARAM_PROTOCOL
+        param_commit(&params);                   /* whole updates only */
+#endif
         float lux_pct = readSensor(&photocell);  /* 0–1 */
+        looptime_mark(&loop_timing, LOOPTIME_SENSE, timebase_ticks());
         float duty    = PID_COMPUTE(&led_ctrl, lux_pct);
-        LedPwm_setDuty(&led_pwm, duty);
+        looptime_mark(&loop_timing, LOOPTIME_COMPUTE, timebase_ticks());
+        LedPwm_setDutyFloat(&led_pwm, duty);
+        looptime_mark(&loop_timing, LOOPTIME_ACTUATE, timebase_ticks());
+#if SCOPE_ENABLE
+        capture_sample_t s = { t0, photocell.last_raw_value, lux_pct, duty, 0.0f };
+        capture_record(&scope, &s, led_ctrl.setpoint);
+#endif
+#if TELEMETRY_STREAM
+        telemetry_sample(lux_pct, duty);
+#endif
+#if TELEMETRY_ON_CHANGE
+        onchange_sample(t_ms, lux_pct, duty);
+#endif
     }
 
-    /* Optional: stream data out UART for your logger ---------- */
-    // if (t_ms % 100 == 0) log_telemetry(lux_pct, duty);
+#if SCOPE_ENABLE
+    /* Frozen capture window, at the pace of the UART ---------- */
+    if (scope.state == CAPTURE_FROZEN && t_ms % SCOPE_LINE_MS == 0) scope_readout();
+#endif
+
+    /* Period / jitter / deadline statistics ------------------- */
+    if (t_ms % LOOPTIME_REPORT_MS == 0) report_looptime();
+
+    /* Clock sync record, once the UART ring has drained ------- */
+    if (t_ms - sync_ms >= LOG_SYNC_MS && Log_Sync()) sync_ms = t_ms;
+
+    /* SD log: one block write or sync, after the control work - */
+    Log_Service(t_ms);
   }
   /* USER CODE END 3 */
 }
@@ -0,0 +1,67 @@
+/**
+ * @file    onchange.c
+ * @brief   Implementation of the report-on-change scheduler.
+ */
+
+#include "onchange.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ONCHANGE_ALL    (0xFFFFFFFFu >> (32u - ONCHANGE_CHANNELS))
+
+/* --------------------------- Public API ---------------------------- */
+void onchange_init(onchange_t *o, const onchange_channel_t *cfg)
+{
+    memset(o, 0, sizeof(*o));
+    memcpy(o->cfg, cfg, sizeof(o->cfg));
+    o->forced = ONCHANGE_ALL;
+}
+
+void onchange_force(onchange_t *o)
+{
+    o->forced = ONCHANGE_ALL;
+}
+
+RAMFUNC uint32_t onchange_update(onchange_t *o, uint32_t now_ms, const int32_t *values)
+{
+    uint32_t mask = o->forced;
+    o->samples++;
+
+    for (uint32_t ch = 0; ch < ONCHANGE_CHANNELS; ch++)
+    {
+        const onchange_channel_t *c = &o->cfg[ch];
+        /* 64-bit difference: no overflow across the whole int32 range */
+        int64_t d = (int64_t)values[ch] - (int64_t)o->reported[ch];
+        if (d > c->deadband || -d > c->deadband ||
+            (c->max_ms != 0u && now_ms - o->t_reported[ch] >= c->max_ms))
+        {
+            mask |= 1u << ch;
+        }
+        if (mask & (1u << ch))
+        {
+            o->reported[ch]   = values[ch];
+            o->t_reported[ch] = now_ms;
+            o->values++;
+        }
+    }
+
+    o->forced = 0u;
+    if (mask != 0u) o->reports++;
+    return mask;
+}
+
+size_t onchange_format(uint32_t now_ms, uint32_t mask, const int32_t *values,
+                       char *buf, size_t cap)
+{
+    if (mask == 0u) return 0u;
+
+    int n = snprintf(buf, cap, "chg,%lu,%lu", (unsigned long)now_ms, (unsigned long)mask);
+    for (uint32_t ch = 0; ch < ONCHANGE_CHANNELS && n > 0 && (size_t)n < cap; ch++)
+    {
+        if (mask & (1u << ch))
+            n += snprintf(buf + n, cap - (size_t)n, ",%ld", (long)values[ch]);
+    }
+    if (n > 0 && (size_t)n < cap) n += snprintf(buf + n, cap - (size_t)n, "\n");
+
+    return (n > 0 && (size_t)n < cap) ? (size_t)n : 0u;
+}
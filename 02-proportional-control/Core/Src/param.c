@@ -0,0 +1,211 @@
+/**
+ * @file    param.c
+ * @brief   Implementation of the parameter registry and its frames.
+ */
+
+#include "param.h"
+#include <string.h>
+
+#define PARAM_HEADER    3u          /* cmd, seq, status */
+#define PARAM_CRC       2u
+
+/* ----------------------------- Helpers ----------------------------- */
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t float_bits(float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    return v;
+}
+
+static int32_t param_find(const param_registry_t *r, uint8_t id)
+{
+    for (uint32_t i = 0; i < r->count; i++)
+        if (r->defs[i].id == id) return (int32_t)i;
+    return -1;
+}
+
+/* Range check in double, exact for every 32-bit integer; NaN fails */
+static bool param_in_range(const param_def_t *d, uint32_t raw)
+{
+    double v;
+    switch (d->type)
+    {
+    case PARAM_F32: { float f; memcpy(&f, &raw, sizeof(f)); v = f; break; }
+    case PARAM_U32: v = (double)raw;          break;
+    case PARAM_I32: v = (double)(int32_t)raw; break;
+    default:        return false;
+    }
+    return v >= (double)d->min && v <= (double)d->max;
+}
+
+/* SET: validate every pair, then stage them all */
+static param_status_t param_set(param_registry_t *r, const uint8_t *body, size_t n,
+                                uint8_t *bad_id)
+{
+    if (n == 0u || n % 5u != 0u) return PARAM_ERR_LENGTH;
+
+    for (size_t k = 0; k < n; k += 5u)
+    {
+        int32_t i = param_find(r, body[k]);
+        *bad_id = body[k];
+        if (i < 0) return PARAM_ERR_ID;
+        if (r->defs[i].flags & PARAM_READ_ONLY) return PARAM_ERR_READ_ONLY;
+        if (!param_in_range(&r->defs[i], get_u32(&body[k + 1u]))) return PARAM_ERR_RANGE;
+    }
+    for (size_t k = 0; k < n; k += 5u)
+    {
+        uint32_t i = (uint32_t)param_find(r, body[k]);
+        r->staged[i] = get_u32(&body[k + 1u]);
+        r->pending  |= 1u << i;
+    }
+    return PARAM_OK;
+}
+
+/* GET: id, type, applied value per requested id */
+static param_status_t param_get(const param_registry_t *r, const uint8_t *body, size_t n,
+                                uint8_t *out, size_t room, size_t *len, uint8_t *bad_id)
+{
+    if (n == 0u) return PARAM_ERR_LENGTH;
+    if (n * 6u > room) return PARAM_ERR_LENGTH;
+
+    for (size_t k = 0; k < n; k++)
+    {
+        int32_t i = param_find(r, body[k]);
+        if (i < 0)
+        {
+            *bad_id = body[k];
+            return PARAM_ERR_ID;
+        }
+        uint32_t v;
+        memcpy(&v, r->defs[i].value, sizeof(v));
+        out[6u * k]      = body[k];
+        out[6u * k + 1u] = r->defs[i].type;
+        put_u32(&out[6u * k + 2u], v);
+    }
+    *len = n * 6u;
+    return PARAM_OK;
+}
+
+/* LIST: total count, then as many entries from `first` as fit */
+static param_status_t param_list(const param_registry_t *r, const uint8_t *body, size_t n,
+                                 uint8_t *out, size_t room, size_t *len)
+{
+    if (n != 1u || room < 1u) return PARAM_ERR_LENGTH;
+
+    size_t w = 0u;
+    out[w++] = (uint8_t)r->count;
+    for (uint32_t i = body[0]; i < r->count; i++)
+    {
+        const param_def_t *d = &r->defs[i];
+        size_t name = strlen(d->name);
+        if (name > PARAM_NAME_MAX) name = PARAM_NAME_MAX;
+        if (w + 12u + name > room) break;
+
+        out[w++] = d->id;
+        out[w++] = d->type;
+        out[w++] = d->flags;
+        put_u32(&out[w], float_bits(d->min)); w += 4u;
+        put_u32(&out[w], float_bits(d->max)); w += 4u;
+        out[w++] = (uint8_t)name;
+        memcpy(&out[w], d->name, name);
+        w += name;
+    }
+    *len = w;
+    return PARAM_OK;
+}
+
+/* --------------------------- Public API ---------------------------- */
+void param_init(param_registry_t *r, const param_def_t *defs, uint32_t count)
+{
+    memset(r, 0, sizeof(*r));
+    r->defs  = defs;
+    r->count = (count < PARAM_MAX) ? count : PARAM_MAX;
+}
+
+size_t param_handle(param_registry_t *r, const uint8_t *req, size_t n,
+                    uint8_t *resp, size_t cap)
+{
+    if (n < 2u + PARAM_CRC || cap < PARAM_HEADER + 1u + PARAM_CRC) return 0u;
+
+    size_t         body = n - 2u - PARAM_CRC;
+    size_t         room = cap - PARAM_HEADER - PARAM_CRC;
+    size_t         len  = 0u;
+    uint8_t        bad_id = 0u;
+    param_status_t st;
+
+    if (param_crc16(req, n - PARAM_CRC) != (uint16_t)(req[n - 2u] | (req[n - 1u] << 8)))
+        st = PARAM_ERR_CRC;
+    else if (req[0] == PARAM_CMD_GET)
+        st = param_get(r, &req[2], body, &resp[PARAM_HEADER], room, &len, &bad_id);
+    else if (req[0] == PARAM_CMD_SET)
+        st = param_set(r, &req[2], body, &bad_id);
+    else if (req[0] == PARAM_CMD_LIST)
+        st = param_list(r, &req[2], body, &resp[PARAM_HEADER], room, &len);
+    else
+        st = PARAM_ERR_CMD;
+
+    /* Name the offending entry */
+    if (st == PARAM_ERR_ID || st == PARAM_ERR_READ_ONLY || st == PARAM_ERR_RANGE)
+    {
+        resp[PARAM_HEADER] = bad_id;
+        len = 1u;
+    }
+    else if (st != PARAM_OK)
+    {
+        len = 0u;
+    }
+
+    resp[0] = (uint8_t)(req[0] | PARAM_CMD_RESPONSE);
+    resp[1] = req[1];
+    resp[2] = (uint8_t)st;
+    len += PARAM_HEADER;
+    uint16_t crc = param_crc16(resp, len);
+    resp[len++] = (uint8_t)crc;
+    resp[len++] = (uint8_t)(crc >> 8);
+
+    r->frames++;
+    if (st != PARAM_OK) r->errors++;
+    return len;
+}
+
+RAMFUNC bool param_commit(param_registry_t *r)
+{
+    uint32_t pending = r->pending;
+    if (pending == 0u) return false;
+
+    r->pending = 0u;
+    while (pending != 0u)
+    {
+        uint32_t i = (uint32_t)__builtin_ctz(pending);
+        pending &= pending - 1u;
+        memcpy(r->defs[i].value, &r->staged[i], sizeof(uint32_t));
+    }
+    r->commits++;
+    return true;
+}
+
+uint16_t param_crc16(const uint8_t *data, size_t n)
+{
+    uint16_t crc = 0xFFFFu;
+    for (size_t i = 0; i < n; i++)
+    {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (uint32_t b = 0; b < 8u; b++)
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
@@ -3,7 +3,7 @@
 
 extern ADC_HandleTypeDef hadc1;  // Your global ADC handle
 
-static inline long map_range(long x, long in_min, long in_max, long out_min, long out_max) {
+RAMFUNC_INLINE long map_range(long x, long in_min, long in_max, long out_min, long out_max) {
     return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
@@ -18,7 +18,7 @@ void photoCell_init(photoCell_t* sensor, bool scaled, uint16_t min_value, uint16
         sensor->scaled ? "true" : "false", sensor->min_value, sensor->max_value);
 }
 
-uint8_t readSensor(photoCell_t* sensor) {
+RAMFUNC uint8_t readSensor(photoCell_t* sensor) {
     HAL_ADC_Start(&hadc1);
     HAL_ADC_PollForConversion(&hadc1, HAL_MAX_DELAY);
     uint16_t raw = HAL_ADC_GetValue(&hadc1);
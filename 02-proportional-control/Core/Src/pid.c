@@ -6,7 +6,7 @@
 #include "pid.h"
 
 /* ----------------------------- Helpers ----------------------------- */
-static inline float pid_clamp(float v, float lo, float hi)
+RAMFUNC_INLINE float pid_clamp(float v, float lo, float hi)
 {
     if (v > hi) return hi;
     if (v < lo) return lo;
@@ -26,7 +26,7 @@ void pid_init(pid_t *pid,
     pid->out_max   = out_max;
 }
 
-float pid_compute(const pid_t *pid, float measured)
+RAMFUNC float pid_compute(const pid_t *pid, float measured)
 {
     float error  = pid->setpoint - measured;
     float output = pid->Kp * error;
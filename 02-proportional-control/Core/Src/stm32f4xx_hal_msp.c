@@ -160,6 +160,9 @@ void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef* htim_pwm)
     /* Peripheral clock enable */
     __HAL_RCC_TIM2_CLK_ENABLE();
     /* USER CODE BEGIN TIM2_MspInit 1 */
+    /* Update interrupt drives the PWM dithering (LedPwm_setDither) */
+    HAL_NVIC_SetPriority(TIM2_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
 
     /* USER CODE END TIM2_MspInit 1 */
 
@@ -209,6 +212,7 @@ void HAL_TIM_PWM_MspDeInit(TIM_HandleTypeDef* htim_pwm)
     /* Peripheral clock disable */
     __HAL_RCC_TIM2_CLK_DISABLE();
     /* USER CODE BEGIN TIM2_MspDeInit 1 */
+    HAL_NVIC_DisableIRQ(TIM2_IRQn);
 
     /* USER CODE END TIM2_MspDeInit 1 */
   }
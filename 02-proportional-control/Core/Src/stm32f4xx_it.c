@@ -24,6 +24,8 @@
 /* USER CODE BEGIN Includes */
 #include <stdbool.h>
 #include "main.h"
+#include "led_pwm.h"
+#include "ramfunc.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -61,6 +63,8 @@ extern volatile bool tick_1ms;
 extern DMA_HandleTypeDef hdma_usart2_tx;
 extern UART_HandleTypeDef huart2;
 /* USER CODE BEGIN EV */
+extern TIM_HandleTypeDef htim2;
+extern LedPwm_t led_pwm;
 
 /* USER CODE END EV */
 
@@ -233,4 +237,18 @@ void USART2_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief TIM2 update interrupt: next PWM period's dithered compare value.
+  *        Kept out of HAL_TIM_IRQHandler(), which costs several times the
+  *        update itself at the 10 kHz PWM rate.  Runs from SRAM.
+  */
+RAMFUNC_ISR void TIM2_IRQHandler(void)
+{
+  if (__HAL_TIM_GET_FLAG(&htim2, TIM_FLAG_UPDATE) != RESET)
+  {
+    __HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_UPDATE);
+    LedPwm_periodElapsed(&led_pwm);
+  }
+}
+
 /* USER CODE END 1 */
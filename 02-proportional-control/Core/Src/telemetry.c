@@ -0,0 +1,126 @@
+/**
+ * @file    telemetry.c
+ * @brief   Implementation of the delta / varint telemetry encoder.
+ */
+
+#include "telemetry.h"
+#include <string.h>
+
+/* ----------------------------- Helpers ----------------------------- */
+RAMFUNC_INLINE uint32_t put_varint(uint8_t *p, uint32_t z)
+{
+    uint32_t n = 0u;
+    while (z >= 0x80u)
+    {
+        p[n++] = (uint8_t)(z | 0x80u);
+        z >>= 7;
+    }
+    p[n++] = (uint8_t)z;
+    return n;
+}
+
+static uint32_t put_varint64(uint8_t *p, uint64_t z)
+{
+    uint32_t n = 0u;
+    while (z >= 0x80u)
+    {
+        p[n++] = (uint8_t)(z | 0x80u);
+        z >>= 7;
+    }
+    p[n++] = (uint8_t)z;
+    return n;
+}
+
+/* --------------------------- Public API ---------------------------- */
+void telemetry_init(telemetry_t *t)
+{
+    memset(t, 0, sizeof(*t));
+}
+
+RAMFUNC bool telemetry_put(telemetry_t *t, const int32_t *values, uint64_t stamp)
+{
+    uint8_t *p   = t->frame;
+    uint32_t len = t->len;
+    bool     key = (t->samples == 0u);
+
+    if (key)
+    {
+        p[0] = t->seq;
+        len  = 2u;                      /* p[1], the count, is set by flush */
+        len += put_varint64(&p[len], stamp);
+    }
+
+    for (uint32_t ch = 0; ch < TELEMETRY_CHANNELS; ch++)
+    {
+        /* Unsigned difference: wraps instead of overflowing */
+        int32_t d = key ? values[ch]
+                        : (int32_t)((uint32_t)values[ch] - (uint32_t)t->prev[ch]);
+        len += put_varint(&p[len], telemetry_zigzag(d));
+        t->prev[ch] = values[ch];
+    }
+
+    t->len = len;
+    return ++t->samples >= TELEMETRY_BATCH;
+}
+
+size_t telemetry_flush(telemetry_t *t, uint8_t *out, size_t cap)
+{
+    if (t->samples == 0u) return 0u;
+
+    t->frame[1] = (uint8_t)t->samples;
+    size_t n = telemetry_cobs(t->frame, t->len, out, cap);
+
+    t->seq++;
+    t->samples = 0u;
+    t->len     = 0u;
+    return n;
+}
+
+size_t telemetry_cobs(const uint8_t *in, size_t n, uint8_t *out, size_t cap)
+{
+    if (cap < n + n / 254u + 3u) return 0u;
+
+    size_t  w    = 0u;
+    out[w++]     = 0x00u;
+    size_t  code = w++;                 /* where the current block's length goes */
+    uint8_t run  = 1u;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (in[i] != 0x00u)
+        {
+            out[w++] = in[i];
+            run++;
+        }
+        if (in[i] == 0x00u || run == 0xFFu)
+        {
+            out[code] = run;
+            code      = w++;
+            run       = 1u;
+        }
+    }
+    out[code] = run;
+    out[w++]  = 0x00u;
+    return w;
+}
+
+size_t telemetry_uncobs(const uint8_t *in, size_t n, uint8_t *out, size_t cap)
+{
+    size_t r = 0u, w = 0u;
+    while (r < n)
+    {
+        uint8_t code = in[r++];
+        if (code == 0x00u || r + code - 1u > n || w + code > cap + 1u) return 0u;
+        for (uint8_t i = 1u; i < code; i++)
+        {
+            if (in[r] == 0x00u) return 0u;
+            out[w++] = in[r++];
+        }
+        if (code < 0xFFu && r < n)
+        {
+            if (w >= cap) return 0u;
+            out[w++] = 0x00u;
+        }
+    }
+    return w;
+}
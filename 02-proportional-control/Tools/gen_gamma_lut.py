@@ -0,0 +1,171 @@
+"""Generate the LED output linearisation curve for led_pwm.c.
+
+Equal duty steps do not give equal reading steps: the CdS response is
+roughly logarithmic in light, so near the dark end 1 % of duty moves the
+reading about 15x more than near full duty. The curve maps a linear
+command c (0-100 %) to the duty whose steady-state reading lies a
+fraction c/100 of the way from the reading at 0 % duty to the reading
+at 100 % duty. With it in front of the compare register, the loop gain
+is the same at every operating point.
+
+The curve is inverted from calibration data. That data is either a CSV
+written by uart_plotter/uart_plot.py during a slow duty sweep ('PWM (%)'
+and 'Scaled' columns) or any CSV whose first two columns are duty and
+reading. Without data, the log model of tests/led_plant.h is used:
+
+    python Tools/gen_gamma_lut.py                      # model, rewrites Core/Inc/led_gamma_table.h
+    python Tools/gen_gamma_lut.py --cal log_20250101_120000.csv
+
+The table holds LED_PWM_CURVE_SEGMENTS + 1 breakpoints in Q16 duty
+(65536 = 100 %). LedPwm_setDutyQ16() interpolates linearly between them.
+"""
+
+import argparse
+import csv
+import math
+import os
+
+SEGMENTS = 64         # must match LED_PWM_CURVE_SEGMENTS in led_pwm.h
+Q16_ONE = 65536
+
+# --- Default model (keep in sync with tests/led_plant.h) -----------------
+LOG_U0 = 5.0          # duty (%) where the log curve bends
+AMBIENT = 5.0         # reading with the LED off (%)
+SPAN = 85.0           # reading span from LED off to full duty (%)
+
+
+def model_points():
+    duties = [i * 0.05 for i in range(2001)]
+    return [(u, AMBIENT + SPAN * math.log1p(u / LOG_U0) / math.log1p(100.0 / LOG_U0))
+            for u in duties]
+
+
+def read_calibration(path):
+    """(duty, mean reading) per distinct duty, sorted by duty."""
+    with open(path, newline="") as f:
+        rows = list(csv.reader(f))
+    header = rows[0]
+    if "PWM (%)" in header and "Scaled" in header:
+        du, rd = header.index("PWM (%)"), header.index("Scaled")
+        rows = rows[1:]
+    else:
+        du, rd = 0, 1
+        try:
+            float(header[0])
+        except ValueError:
+            rows = rows[1:]
+
+    sums = {}
+    for r in rows:
+        try:
+            d, y = float(r[du]), float(r[rd])
+        except (ValueError, IndexError):
+            continue
+        s = sums.setdefault(d, [0.0, 0])
+        s[0] += y
+        s[1] += 1
+    if len(sums) < 2:
+        raise SystemExit(f"{path}: need readings at two or more duty levels")
+    return [(d, s[0] / s[1]) for d, s in sorted(sums.items())]
+
+
+def make_monotone(points):
+    """Pool adjacent violators: the closest non-decreasing reading curve."""
+    blocks = []                       # [sum, count, first index]
+    for i, (_, y) in enumerate(points):
+        blocks.append([y, 1, i])
+        while len(blocks) > 1 and blocks[-2][0] / blocks[-2][1] > blocks[-1][0] / blocks[-1][1]:
+            s, n, _ = blocks.pop()
+            blocks[-1][0] += s
+            blocks[-1][1] += n
+    out = []
+    for s, n, first in blocks:
+        for k in range(first, first + n):
+            out.append((points[k][0], s / n))
+    return out
+
+
+def duty_for(points, target):
+    """Smallest duty whose interpolated reading reaches target."""
+    for (d0, y0), (d1, y1) in zip(points, points[1:]):
+        if y1 >= target:
+            if y1 == y0:
+                return d0
+            t = max(0.0, (target - y0) / (y1 - y0))
+            return d0 + t * (d1 - d0)
+    return points[-1][0]
+
+
+def build(points):
+    points = make_monotone(points)
+    lo, hi = points[0], points[-1]
+    if hi[1] <= lo[1]:
+        raise SystemExit("calibration: the reading does not rise with duty")
+    # Map the calibrated duty range onto 0-100 % of the command
+    table = []
+    for i in range(SEGMENTS + 1):
+        target = lo[1] + (hi[1] - lo[1]) * i / SEGMENTS
+        duty = duty_for(points, target)
+        table.append(min(max(round(duty / 100.0 * Q16_ONE), 0), Q16_ONE))
+    table[0] = round(lo[0] / 100.0 * Q16_ONE)
+    table[-1] = round(hi[0] / 100.0 * Q16_ONE)
+    for i in range(1, len(table)):    # rounding must not break monotonicity
+        table[i] = max(table[i], table[i - 1])
+    return table, lo, hi
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="Generate led_gamma_table.h")
+    parser.add_argument("--cal", help="Calibration CSV (duty, reading); default: log model")
+    parser.add_argument("-o", "--output",
+                        default=os.path.join(here, "..", "Core", "Inc", "led_gamma_table.h"))
+    args = parser.parse_args()
+
+    if args.cal:
+        points = read_calibration(args.cal)
+        source = f"calibration {os.path.basename(args.cal)} ({len(points)} duty levels)"
+    else:
+        points = model_points()
+        source = f"log CdS model (U0={LOG_U0}, ambient {AMBIENT}, span {SPAN})"
+    table, lo, hi = build(points)
+    print(f"{source}: reading {lo[1]:.2f} .. {hi[1]:.2f} over duty {lo[0]:.1f} .. {hi[0]:.1f} %")
+
+    lines = [
+        "/**",
+        " * @file    led_gamma_table.h",
+        " * @brief   LED output linearisation curve, generated by",
+        " *          Tools/gen_gamma_lut.py – do not edit.",
+        " *",
+        f" * Source: {source}.",
+        " * Entry i is the duty (Q16, 65536 = 100 %) for a command of",
+        f" * i/{SEGMENTS} of full scale; see LedPwm_setCurve().",
+        " */",
+        "",
+        "#ifndef LED_GAMMA_TABLE_H",
+        "#define LED_GAMMA_TABLE_H",
+        "",
+        "#include <stdint.h>",
+        '#include "led_pwm.h"',
+        '#include "ramfunc.h"',
+        "",
+        f"#define LED_GAMMA_SEGMENTS  {SEGMENTS}u",
+        "",
+        "#if LED_GAMMA_SEGMENTS != LED_PWM_CURVE_SEGMENTS",
+        "#error \"led_gamma_table.h does not match LED_PWM_CURVE_SEGMENTS; regenerate it\"",
+        "#endif",
+        "",
+        "RAMDATA static const uint32_t led_gamma_table[LED_GAMMA_SEGMENTS + 1u] = {",
+    ]
+    for i in range(0, len(table), 8):
+        chunk = ", ".join(f"{v:5d}u" for v in table[i:i + 8])
+        lines.append(f"    {chunk},")
+    lines += ["};", "", "#endif /* LED_GAMMA_TABLE_H */", ""]
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(lines))
+    print(f"wrote {os.path.relpath(args.output)}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,59 @@
+# Post-build report of the symbols the linker placed in SRAM through the
+# RAMFUNC / RAMDATA attributes (see Core/Inc/ramfunc.h).
+#
+#   cmake -DNM=arm-none-eabi-nm -DELF=app.elf -P ramfunc_report.cmake
+#
+# The linker script brackets the two input sections with
+# __ramfunc_start/__ramfunc_end and __ramdata_start/__ramdata_end; every
+# sized symbol inside one of those ranges is listed with its size.
+
+if(NOT NM OR NOT ELF)
+    message(FATAL_ERROR "ramfunc_report: NM and ELF must be set")
+endif()
+
+execute_process(
+    COMMAND ${NM} --print-size --numeric-sort ${ELF}
+    OUTPUT_VARIABLE nm_out
+    RESULT_VARIABLE nm_result
+)
+if(NOT nm_result EQUAL 0)
+    message(FATAL_ERROR "ramfunc_report: ${NM} failed on ${ELF}")
+endif()
+
+string(REPLACE "\n" ";" nm_lines "${nm_out}")
+
+# Pass 1: section bounds
+foreach(line IN LISTS nm_lines)
+    if(line MATCHES "^([0-9a-fA-F]+) +[A-Za-z] +(__ram(func|data)_(start|end))$")
+        math(EXPR value "0x${CMAKE_MATCH_1}")
+        set(${CMAKE_MATCH_2} ${value})
+    endif()
+endforeach()
+
+if(NOT DEFINED __ramfunc_start OR NOT DEFINED __ramdata_start)
+    message(STATUS "ramfunc_report: no .RamFunc/.RamData bounds in ${ELF}")
+    return()
+endif()
+
+# Pass 2: sized symbols inside the bounds
+set(report "")
+foreach(kind func data)
+    set(total 0)
+    foreach(line IN LISTS nm_lines)
+        if(NOT line MATCHES "^([0-9a-fA-F]+) ([0-9a-fA-F]+) [A-Za-z] (.+)$")
+            continue()
+        endif()
+        set(name ${CMAKE_MATCH_3})
+        math(EXPR addr "0x${CMAKE_MATCH_1}")
+        math(EXPR size "0x${CMAKE_MATCH_2}")
+        if(addr GREATER_EQUAL ${__ram${kind}_start} AND addr LESS ${__ram${kind}_end})
+            math(EXPR total "${total} + ${size}")
+            string(APPEND report "  ram${kind}  ${size}\t${name}\n")
+        endif()
+    endforeach()
+    math(EXPR span "${__ram${kind}_end} - ${__ram${kind}_start}")
+    string(APPEND report "  ram${kind}  ${total}\ttotal (section ${span} bytes)\n")
+endforeach()
+
+get_filename_component(elf_name ${ELF} NAME)
+message("SRAM-placed symbols in ${elf_name}:\n${report}")
@@ -0,0 +1,463 @@
+/**
+ * @file    bench_main.c
+ * @brief   On-target cycle-count benchmark firmware for the control path.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * Bare-metal (no RTOS) image that shares its sources with 03-pi-control.
+ * Every case is executed BENCH_RUNS times; each run is timed on its own
+ * so min / median / max expose flash wait-state and cache effects.  The
+ * fixed cost of the timing harness (measured on an empty case) is
+ * subtracted.  Results are sent over USART2 (250000 8N1) as:
+ *
+ *     bench_begin,<core_hz>,<timer>,<placement>
+ *     budget,<name>,<cycles>
+ *     bench,<name>,<runs>,<min>,<median>,<max>
+ *     bench_end
+ *
+ * Every case is reported twice: warm, then as <name>_cold with the ART
+ * instruction/data caches flushed before each run.  <placement> is "ram"
+ * when RAMFUNC symbols run from SRAM (ramfunc.h) and "flash" when the
+ * image was built with RAMFUNC_DISABLE=1; compare the two builds to see
+ * what SRAM placement buys.  A budget line gives the cycle allowance of a
+ * case that has one (e.g. KALMAN_CYCLE_BUDGET); bench_collect.py flags
+ * cases whose max exceeds it.
+ *
+ * <timer> is "dwt" (DWT->CYCCNT, core cycles) on hardware.  Under
+ * qemu-system-arm, which does not model the DWT, the harness falls back
+ * to the 24-bit SysTick counter ("systick"); run with -icount shift=0 so
+ * those counts track executed instructions.  See Bench/README.md.
+ */
+
+#include "main.h"
+#include "pid.h"
+#include "looptime.h"
+#include "gainsched.h"
+#include "gain_schedule_table.h"
+#include "rls.h"
+#include "freqresp.h"
+#include "kalman.h"
+#include "mpc.h"
+#include "mpc_table.h"
+#include "waveform.h"
+#include "slew.h"
+#include "dwt.h"
+#include "ramfunc.h"
+#include <stdio.h>
+#include <string.h>
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------*/
+#ifndef BENCH_RUNS
+#define BENCH_RUNS        255u      /**< Timed runs per case (odd → true median) */
+#endif
+
+#ifndef BENCH_QEMU
+#define BENCH_QEMU        0         /**< 1: skip PLL setup, exit via semihosting */
+#endif
+
+UART_HandleTypeDef huart2;
+
+/* --------------------------------------------------------------------
+ * Time source
+ * ------------------------------------------------------------------*/
+static uint32_t timer_mask = 0xFFFFFFFFu;
+static const char *timer_name = "dwt";
+
+static uint32_t now_dwt(void)
+{
+    return DWT->CYCCNT;
+}
+
+static uint32_t now_systick(void)
+{
+    return 0x00FFFFFFu - SysTick->VAL;   /* make it count up */
+}
+
+static uint32_t (*bench_now)(void) = now_dwt;
+
+static void timer_init(void)
+{
+    dwt_init();
+    uint32_t a = DWT->CYCCNT;
+    __NOP(); __NOP(); __NOP(); __NOP();
+    if (DWT->CYCCNT != a) return;
+
+    /* No cycle counter (emulator): free-run SysTick without interrupts */
+    SysTick->CTRL = 0u;
+    SysTick->LOAD = 0x00FFFFFFu;
+    SysTick->VAL  = 0u;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    bench_now  = now_systick;
+    timer_mask = 0x00FFFFFFu;
+    timer_name = "systick";
+}
+
+/* --------------------------------------------------------------------
+ * Cases – each call performs exactly one operation
+ * ------------------------------------------------------------------*/
+static pid_t       bench_pid;
+static pid_t       bench_pid_vel;
+static pid_t       bench_pid_sched;
+static gainsched_t bench_sched;
+static rls_t       bench_rls;
+static float       bench_y = 5.0f;
+static freqresp_t  bench_fr;
+static float       bench_fft_in[FREQRESP_NFFT];
+static float       bench_fft[FREQRESP_NFFT];
+static kalman_t    bench_kf;
+static kalman_t    bench_kf_ss;
+static mpc_t       bench_mpc;
+static waveform_t  bench_wf;
+static const waveform_point_t bench_wf_tri[] = {
+    { 0.0f, 10000u }, { 100.0f, 10000u }, { 0.0f, 0u } };
+static slew_t      bench_slew;
+static looptime_t  bench_lt;
+static uint32_t    bench_step;
+static volatile float    sink_f;
+
+__attribute__((noinline)) static void case_empty(void)
+{
+    __asm volatile ("" ::: "memory");
+}
+
+__attribute__((noinline)) static void case_pid_compute(void)
+{
+    sink_f = PID_COMPUTE(&bench_pid, (float)(bench_step++ & 127u));
+}
+
+__attribute__((noinline)) static void case_pid_velocity(void)
+{
+    sink_f = PID_COMPUTE(&bench_pid_vel, (float)(bench_step++ & 127u));
+}
+
+/* Operating point moves every call: lookup + bumpless retune + compute */
+__attribute__((noinline)) static void case_pid_scheduled(void)
+{
+    float x = (float)(bench_step++ & 127u);
+    gainsched_apply(&bench_sched, &bench_pid_sched, x);
+    sink_f = PID_COMPUTE(&bench_pid_sched, x);
+}
+
+/* One estimator update on a first-order response to a square wave */
+__attribute__((noinline)) static void case_rls_update(void)
+{
+    float u = (bench_step++ & 32u) ? 60.0f : 40.0f;
+    bench_y += 0.2f * (5.0f + 0.8f * u - bench_y);
+    sink_f = rls_update(&bench_rls, u, bench_y);
+}
+
+/* One FREQRESP_NFFT-point real FFT, including a copy of its input */
+__attribute__((noinline)) static void case_freqresp_rfft(void)
+{
+    memcpy(bench_fft, bench_fft_in, sizeof(bench_fft));
+    freqresp_rfft(&bench_fr, bench_fft);
+}
+
+/* One filter update on a noisy reading of a square-wave response */
+__attribute__((noinline)) static void case_kalman_update(void)
+{
+    float u = (bench_step++ & 32u) ? 60.0f : 40.0f;
+    bench_y += 0.2f * (5.0f + 0.8f * u - bench_y);
+    sink_f = kalman_update(&bench_kf, u, bench_y + (float)(bench_step & 7u) * 0.5f);
+}
+
+__attribute__((noinline)) static void case_kalman_steady(void)
+{
+    float u = (bench_step++ & 32u) ? 60.0f : 40.0f;
+    bench_y += 0.2f * (5.0f + 0.8f * u - bench_y);
+    sink_f = kalman_update(&bench_kf_ss, u, bench_y + (float)(bench_step & 7u) * 0.5f);
+}
+
+__attribute__((noinline)) static void case_kalman_q16(void)
+{
+    int32_t u = (bench_step++ & 32u) ? 60 * KALMAN_Q16_ONE : 40 * KALMAN_Q16_ONE;
+    int32_t z = (int32_t)(bench_step & 7u) * (KALMAN_Q16_ONE / 2) + 45 * KALMAN_Q16_ONE;
+    sink_f = (float)kalman_update_q16(&bench_kf_ss, u, z);
+}
+
+/* Operating point jumps every call, so most calls search the table */
+__attribute__((noinline)) static void case_mpc_compute(void)
+{
+    uint32_t i  = bench_step++;
+    float level = (float)(i & 127u) * 0.75f;
+    float rate  = (float)((int32_t)((i * 37u) & 255u) - 128) * 8.0f;
+    sink_f = mpc_compute(&bench_mpc, level, rate, 40.0f);
+}
+
+/* One DMA half-transfer interrupt: WAVEFORM_HALF_LEN samples of a ramp */
+__attribute__((noinline)) static void case_waveform_refill(void)
+{
+    waveform_refill(&bench_wf, bench_step++ & 1u);
+}
+
+/* Target jumps every call, so the stage is always limiting */
+__attribute__((noinline)) static void case_slew_step(void)
+{
+    float target = (bench_step++ & 64u) ? 90.0f : 10.0f;
+    sink_f = slew_step(&bench_slew, target);
+}
+
+__attribute__((noinline)) static void case_looptime(void)
+{
+    uint32_t t = bench_step++ * 1800000u;
+    looptime_begin(&bench_lt, t);
+    looptime_mark(&bench_lt, LOOPTIME_SENSE,   t + 100u);
+    looptime_mark(&bench_lt, LOOPTIME_COMPUTE, t + 180u);
+    looptime_mark(&bench_lt, LOOPTIME_ACTUATE, t + 260u);
+}
+
+typedef struct
+{
+    const char *name;
+    void      (*fn)(void);
+    uint32_t    budget;             /**< Cycle allowance, 0 = none */
+} bench_case_t;
+
+static const bench_case_t cases[] = {
+    { "pid_compute",     case_pid_compute,      0u                  },
+    { "pid_velocity",    case_pid_velocity,     0u                  },
+    { "pid_scheduled",   case_pid_scheduled,    0u                  },
+    { "rls_update",      case_rls_update,       0u                  },
+    { "freqresp_rfft",   case_freqresp_rfft,    0u                  },
+    { "kalman_update",   case_kalman_update,    KALMAN_CYCLE_BUDGET },
+    { "kalman_steady",   case_kalman_steady,    KALMAN_CYCLE_BUDGET },
+    { "kalman_q16",      case_kalman_q16,       KALMAN_CYCLE_BUDGET },
+    { "mpc_compute",     case_mpc_compute,      MPC_CYCLE_BUDGET    },
+    { "waveform_refill", case_waveform_refill,  0u                  },
+    { "slew_step",       case_slew_step,        0u                  },
+    { "looptime_update", case_looptime,         0u                  },
+};
+
+/* --------------------------------------------------------------------
+ * Harness
+ * ------------------------------------------------------------------*/
+static uint32_t samples[BENCH_RUNS];
+
+static void sort_u32(uint32_t *v, uint32_t n)
+{
+    for (uint32_t i = 1; i < n; i++)
+    {
+        uint32_t x = v[i];
+        uint32_t j = i;
+        while (j > 0u && v[j - 1u] > x)
+        {
+            v[j] = v[j - 1u];
+            j--;
+        }
+        v[j] = x;
+    }
+}
+
+/* Drop everything the ART accelerator holds so the next fetch hits flash */
+static void art_flush(void)
+{
+    __HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+    __HAL_FLASH_DATA_CACHE_DISABLE();
+    __HAL_FLASH_INSTRUCTION_CACHE_RESET();
+    __HAL_FLASH_DATA_CACHE_RESET();
+    __HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+    __HAL_FLASH_DATA_CACHE_ENABLE();
+    __DSB();
+    __ISB();
+}
+
+static void measure(void (*fn)(void), uint32_t overhead, bool cold)
+{
+    for (uint32_t i = 0; i < BENCH_RUNS; i++)
+    {
+        __disable_irq();
+        if (cold) art_flush();
+        uint32_t t0 = bench_now();
+        fn();
+        uint32_t t1 = bench_now();
+        __enable_irq();
+
+        uint32_t dt = (t1 - t0) & timer_mask;
+        samples[i] = (dt > overhead) ? (dt - overhead) : 0u;
+    }
+    sort_u32(samples, BENCH_RUNS);
+}
+
+static void uart_puts(const char *s)
+{
+    HAL_UART_Transmit(&huart2, (const uint8_t *)s, (uint16_t)strlen(s), HAL_MAX_DELAY);
+}
+
+static void run_all(void)
+{
+    char line[96];
+
+    pid_init(&bench_pid, 1.2f, 0.05f, 60.0f, 0.0f, 100.0f);
+    pid_init(&bench_pid_vel, 1.2f, 0.05f, 60.0f, 0.0f, 100.0f);
+    pid_set_form(&bench_pid_vel, PID_FORM_VELOCITY);
+    pid_init(&bench_pid_sched, 1.2f, 0.05f, 60.0f, 0.0f, 100.0f);
+    gainsched_init(&bench_sched, GAIN_SCHEDULE_X0, GAIN_SCHEDULE_DX,
+                   GAIN_SCHEDULE_POINTS, gain_schedule_table);
+    rls_init(&bench_rls, RLS_LAMBDA, RLS_P0);
+    freqresp_init(&bench_fr, FREQRESP_PRBS, 200.0f, 50.0f, 20.0f, 0.2f, 60.0f);
+    for (uint32_t n = 0; n < FREQRESP_NFFT; n++) bench_fft_in[n] = (float)(n & 63u);
+    kalman_init_led(&bench_kf, 0.01f, 0.045f, 0.020f, 0.8f, 5.0f, 5.0e5f, 3.0f);
+    kalman_init_led(&bench_kf_ss, 0.01f, 0.045f, 0.020f, 0.8f, 5.0f, 5.0e5f, 3.0f);
+    kalman_make_steady(&bench_kf_ss, 1000u);
+    mpc_init(&bench_mpc, mpc_table, MPC_TABLE_REGIONS, MPC_TABLE_U_MIN, MPC_TABLE_U_MAX);
+    waveform_init(&bench_wf, 1000u, 1u);
+    waveform_load_pwl(&bench_wf, bench_wf_tri, 3u, true);
+    slew_init(&bench_slew, 200.0f, 4000.0f, 0.01f, 0.0f);
+    looptime_init(&bench_lt, 1800000u, 360000u);
+
+    snprintf(line, sizeof(line), "bench_begin,%lu,%s,%s\r\n",
+             (unsigned long)SystemCoreClock, timer_name,
+             RAMFUNC_DISABLE ? "flash" : "ram");
+    uart_puts(line);
+
+    for (uint32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        if (cases[c].budget == 0u) continue;
+        snprintf(line, sizeof(line), "budget,%s,%lu\r\n",
+                 cases[c].name, (unsigned long)cases[c].budget);
+        uart_puts(line);
+    }
+
+    for (uint32_t pass = 0; pass < 2u; pass++)
+    {
+        bool cold = (pass == 1u);
+        measure(case_empty, 0u, cold);
+        uint32_t overhead = samples[0];
+
+        for (uint32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+        {
+            measure(cases[c].fn, overhead, cold);
+            snprintf(line, sizeof(line), "bench,%s%s,%lu,%lu,%lu,%lu\r\n",
+                     cases[c].name, cold ? "_cold" : "",
+                     (unsigned long)BENCH_RUNS,
+                     (unsigned long)samples[0],
+                     (unsigned long)samples[BENCH_RUNS / 2u],
+                     (unsigned long)samples[BENCH_RUNS - 1u]);
+            uart_puts(line);
+        }
+    }
+
+    uart_puts("bench_end\r\n");
+}
+
+/* --------------------------------------------------------------------
+ * Board bring-up (same clock tree as the application: 180 MHz, 5 WS)
+ * ------------------------------------------------------------------*/
+static void SystemClock_Config(void)
+{
+    RCC_OscInitTypeDef RCC_OscInitStruct = {0};
+    RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE1);
+
+    RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+    RCC_OscInitStruct.HSEState = RCC_HSE_ON;
+    RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+    RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+    RCC_OscInitStruct.PLL.PLLM = 4;
+    RCC_OscInitStruct.PLL.PLLN = 180;
+    RCC_OscInitStruct.PLL.PLLP = RCC_PLLP_DIV2;
+    RCC_OscInitStruct.PLL.PLLQ = 2;
+    RCC_OscInitStruct.PLL.PLLR = 2;
+    if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    if (HAL_PWREx_EnableOverDrive() != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
+                                |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
+    RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+    RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+    RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV4;
+    RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV2;
+    if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_5) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+static void MX_USART2_UART_Init(void)
+{
+    huart2.Instance = USART2;
+    huart2.Init.BaudRate = 250000;
+    huart2.Init.WordLength = UART_WORDLENGTH_8B;
+    huart2.Init.StopBits = UART_STOPBITS_1;
+    huart2.Init.Parity = UART_PARITY_NONE;
+    huart2.Init.Mode = UART_MODE_TX_RX;
+    huart2.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    huart2.Init.OverSampling = UART_OVERSAMPLING_16;
+    if (HAL_UART_Init(&huart2) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+/* Polled UART only: no DMA, unlike the application's MSP */
+void HAL_UART_MspInit(UART_HandleTypeDef *huart)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    if (huart->Instance == USART2)
+    {
+        __HAL_RCC_USART2_CLK_ENABLE();
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+        GPIO_InitStruct.Pin = USART_TX_Pin|USART_RX_Pin;
+        GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+        GPIO_InitStruct.Pull = GPIO_NOPULL;
+        GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+        GPIO_InitStruct.Alternate = GPIO_AF7_USART2;
+        HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+    }
+}
+
+void SysTick_Handler(void)
+{
+    HAL_IncTick();
+}
+
+void Error_Handler(void)
+{
+    __disable_irq();
+    while (1)
+    {
+    }
+}
+
+#if BENCH_QEMU
+/* Semihosting SYS_EXIT (ADP_Stopped_ApplicationExit) so qemu terminates */
+static void bench_exit(void)
+{
+    register uint32_t r0 __asm__("r0") = 0x18u;
+    register uint32_t r1 __asm__("r1") = 0x20026u;
+    __asm volatile ("bkpt 0xAB" : : "r"(r0), "r"(r1) : "memory");
+}
+#endif
+
+int main(void)
+{
+    HAL_Init();
+#if !BENCH_QEMU
+    SystemClock_Config();
+#else
+    SystemCoreClockUpdate();
+#endif
+    MX_USART2_UART_Init();
+
+    timer_init();
+    run_all();
+
+#if BENCH_QEMU
+    bench_exit();
+#endif
+    while (1)
+    {
+    }
+}
@@ -0,0 +1,28 @@
+#!/usr/bin/env sh
+# Run the benchmark firmware under qemu-system-arm when no board is present.
+#
+#   Bench/run_qemu.sh build/Bench/PI-Control_CMake_CMSIS_Bench.elf [results.json]
+#
+# netduinoplus2 is an STM32F405 (Cortex-M4F) with USART2 on the second
+# serial port.  -icount shift=0 makes virtual time advance one tick per
+# executed instruction, so the SysTick-based counts the firmware reports
+# are instruction counts rather than host-speed dependent wall time.
+set -eu
+
+ELF=${1:?usage: run_qemu.sh <bench.elf> [results.json]}
+OUT=${2:-}
+HERE=$(dirname "$0")
+
+run() {
+    qemu-system-arm -M netduinoplus2 -nographic -monitor none \
+        -icount shift=0 \
+        -semihosting-config enable=on,target=native \
+        -serial null -serial stdio \
+        -kernel "$ELF"
+}
+
+if [ -n "$OUT" ]; then
+    run | python3 "$HERE/../../uart_plotter/bench_collect.py" --json "$OUT"
+else
+    run
+fi
@@ -0,0 +1,181 @@
+/**
+ * @file    freqresp.h
+ * @brief   On-device frequency-response measurement of the LED/CdS plant.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * A measurement run excites the PWM duty with a logarithmic chirp or a
+ * PRBS around an operating point, records duty u and reading y into RAM,
+ * and then estimates the plant's frequency response with Welch's method:
+ * the record is cut into half-overlapping Hann-windowed segments of
+ * FREQRESP_NFFT samples, and
+ *
+ *     H(f) = S_yu(f) / S_uu(f)          γ²(f) = |S_yu|² / (S_uu · S_yy)
+ *
+ * are formed from the averaged cross- and auto-spectra.  The coherence γ²
+ * tells which frequencies were excited well enough to trust (close to 1)
+ * and which are dominated by noise or nonlinearity.
+ *
+ * The real FFT is in-house: an N/2-point complex radix-2 FFT followed by
+ * the usual split step, with twiddles and window computed once by
+ * freqresp_init().  Its output uses the same packing as CMSIS-DSP's
+ * arm_rfft_fast_f32(), which can be used instead by defining
+ * FREQRESP_USE_CMSIS_RFFT=1 – that needs the CMSIS-DSP common tables
+ * (arm_common_tables.c), which this tree does not vendor.
+ *
+ * Usage (see StartPIDTask() with FREQRESP_MODE=1):
+ *     static freqresp_t fr;                    // large: keep it static
+ *     freqresp_init(&fr, FREQRESP_CHIRP, 200.0f, 50.0f, 20.0f, 0.2f, 40.0f);
+ *     for (;;) {                               // every 1/fs
+ *         float u = freqresp_excitation(&fr);
+ *         set_pwm_duty(u);
+ *         if (freqresp_record(&fr, u, read_sensor())) break;
+ *     }
+ *     freqresp_compute(&fr);
+ *     for (uint32_t k = 1; k < FREQRESP_BINS; k++) {
+ *         freqresp_format(&fr, k, buf, sizeof buf);   // "bode,<f>,<dB>,<deg>,<γ²>"
+ *         uart_send(buf);
+ *     }
+ */
+
+#ifndef FREQRESP_H
+#define FREQRESP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifndef FREQRESP_USE_CMSIS_RFFT
+#define FREQRESP_USE_CMSIS_RFFT  0  /**< 1: arm_rfft_fast_f32() instead of the in-house FFT */
+#endif
+
+#if FREQRESP_USE_CMSIS_RFFT
+#include "arm_math.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef FREQRESP_NFFT
+#define FREQRESP_NFFT        512u    /**< Segment / FFT length (power of 2, ≥ 16) */
+#endif
+
+#ifndef FREQRESP_RECORD_LEN
+#define FREQRESP_RECORD_LEN  2048u   /**< Samples recorded per run (≥ NFFT)      */
+#endif
+
+#ifndef FREQRESP_SETTLE
+#define FREQRESP_SETTLE      64u     /**< Excited samples dropped before recording */
+#endif
+
+#define FREQRESP_BINS        (FREQRESP_NFFT / 2u + 1u)   /**< DC … Nyquist */
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef enum
+{
+    FREQRESP_CHIRP = 0,   /**< Logarithmic sine sweep f0 → f1 over the record */
+    FREQRESP_PRBS         /**< ±amplitude maximal-length sequence (9 bit)     */
+} freqresp_signal_t;
+
+typedef struct
+{
+    /* Excitation */
+    freqresp_signal_t signal;
+    float    fs;               /**< Sample rate (Hz)                       */
+    float    offset;           /**< Operating-point duty (%)               */
+    float    amplitude;        /**< Excitation amplitude (%)               */
+    float    f0, f1;           /**< Chirp start / end frequency (Hz)       */
+    uint32_t lfsr;             /**< PRBS state                             */
+    uint32_t tick;             /**< Excitation samples generated           */
+
+    /* Record */
+    uint32_t count;            /**< Samples recorded                       */
+    float    u[FREQRESP_RECORD_LEN];
+    float    y[FREQRESP_RECORD_LEN];
+
+    /* Averaged spectra, one entry per bin */
+    float    Suu[FREQRESP_BINS];
+    float    Syy[FREQRESP_BINS];
+    float    Syu_re[FREQRESP_BINS];
+    float    Syu_im[FREQRESP_BINS];
+    uint32_t segments;         /**< Segments averaged by freqresp_compute() */
+
+    /* FFT work area */
+    float    window[FREQRESP_NFFT];
+    float    bu[FREQRESP_NFFT];
+    float    by[FREQRESP_NFFT];
+#if FREQRESP_USE_CMSIS_RFFT
+    float    scratch[FREQRESP_NFFT];
+    arm_rfft_fast_instance_f32 rfft;
+#else
+    float    twiddle[FREQRESP_NFFT];   /**< cos/sin of -2πk/N, k < N/2 */
+#endif
+} freqresp_t;
+
+typedef struct
+{
+    float freq_hz;
+    float mag_db;
+    float phase_deg;
+    float coherence;
+} freqresp_point_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Prepare a run and precompute window and twiddles.
+ * @param  signal     Chirp or PRBS
+ * @param  fs         Sample rate in Hz (call rate of the two functions below)
+ * @param  offset     Operating-point duty in %
+ * @param  amplitude  Excitation amplitude in %; keep offset ± amplitude in range
+ * @param  f0, f1     Chirp band in Hz (ignored for PRBS, which is white up to ~fs/3)
+ */
+void freqresp_init(freqresp_t *fr, freqresp_signal_t signal, float fs,
+                   float offset, float amplitude, float f0, float f1);
+
+/**
+ * @brief  Duty to apply for the next sample; the offset once the record is full.
+ */
+float freqresp_excitation(freqresp_t *fr);
+
+/**
+ * @brief  Store the duty that was applied and the reading it produced.
+ * @return true once the record is full
+ */
+bool freqresp_record(freqresp_t *fr, float u, float y);
+
+/**
+ * @brief  Estimate S_uu, S_yy and S_yu from the record (run outside the loop).
+ */
+void freqresp_compute(freqresp_t *fr);
+
+/**
+ * @brief  Bode point of bin k (0 … FREQRESP_BINS-1) after freqresp_compute().
+ */
+void freqresp_point(const freqresp_t *fr, uint32_t k, freqresp_point_t *p);
+
+/**
+ * @brief  Format bin k as "bode,<f_hz>,<mag_db>,<phase_deg>,<coherence>".
+ * @return Characters written (excluding the terminator), as snprintf()
+ */
+size_t freqresp_format(const freqresp_t *fr, uint32_t k, char *buf, size_t len);
+
+/**
+ * @brief  Real FFT of FREQRESP_NFFT samples in place, arm_rfft_fast_f32 packing:
+ *         buf[0] = X[0], buf[1] = X[N/2], buf[2k], buf[2k+1] = Re, Im X[k].
+ */
+void freqresp_rfft(freqresp_t *fr, float *buf);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* FREQRESP_H */
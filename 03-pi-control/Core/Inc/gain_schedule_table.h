@@ -0,0 +1,39 @@
+/**
+ * @file    gain_schedule_table.h
+ * @brief   PI gain schedule over the setpoint, generated by
+ *          Tools/gen_gain_schedule.py – do not edit.
+ *
+ * Plant: log CdS curve (U0=5.0), tau rise/fall 0.03/0.06 s,
+ * ADC RC 0.02 s; tuned for min ITAE of a 5.0 % step at Ts=0.01 s.
+ */
+
+#ifndef GAIN_SCHEDULE_TABLE_H
+#define GAIN_SCHEDULE_TABLE_H
+
+#include "ramfunc.h"
+
+#define GAIN_SCHEDULE_X0      10.0f
+#define GAIN_SCHEDULE_DX      5.0000f
+#define GAIN_SCHEDULE_POINTS  16u
+
+/* { Kp, Ki (1/s), Kd (s) } per breakpoint */
+RAMDATA static const float gain_schedule_table[GAIN_SCHEDULE_POINTS][3] = {
+    { 0.16508f,   4.1270f, 0.0f },  /* setpoint  10.0 */
+    { 0.13626f,   4.1270f, 0.0f },  /* setpoint  15.0 */
+    { 0.20000f,   5.0000f, 0.0f },  /* setpoint  20.0 */
+    { 0.24231f,   6.0576f, 0.0f },  /* setpoint  25.0 */
+    { 0.29356f,   7.3390f, 0.0f },  /* setpoint  30.0 */
+    { 0.35566f,   8.8914f, 0.0f },  /* setpoint  35.0 */
+    { 0.43089f,  10.7722f, 0.0f },  /* setpoint  40.0 */
+    { 0.52203f,  13.0508f, 0.0f },  /* setpoint  45.0 */
+    { 0.63246f,  15.8114f, 0.0f },  /* setpoint  50.0 */
+    { 0.76624f,  19.1559f, 0.0f },  /* setpoint  55.0 */
+    { 0.92832f,  23.2079f, 0.0f },  /* setpoint  60.0 */
+    { 1.12468f,  28.1171f, 0.0f },  /* setpoint  65.0 */
+    { 1.36258f,  34.0646f, 0.0f },  /* setpoint  70.0 */
+    { 1.65081f,  41.2702f, 0.0f },  /* setpoint  75.0 */
+    { 2.00000f,  50.0000f, 0.0f },  /* setpoint  80.0 */
+    { 2.42306f,  60.5764f, 0.0f },  /* setpoint  85.0 */
+};
+
+#endif /* GAIN_SCHEDULE_TABLE_H */
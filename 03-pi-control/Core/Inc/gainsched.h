@@ -0,0 +1,89 @@
+/**
+ * @file    gainsched.h
+ * @brief   Gain scheduling from a uniform-grid table with linear interpolation.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * The CdS cell's response is roughly logarithmic in light, so the loop
+ * gain is several times higher near the dark end than near full scale
+ * and a single PI tuning is either sluggish at the top or oscillatory at
+ * the bottom.  A schedule stores {Kp, Ki, Kd} at evenly spaced values of
+ * a scheduling variable (setpoint or measurement).  Because the grid is
+ * uniform, the segment index is computed directly – one multiply, one
+ * conversion and no search – and the gains are interpolated between its
+ * two rows, so the cost per step is constant whatever the table size.
+ *
+ * The table itself is generated offline by Tools/gen_gain_schedule.py,
+ * which tunes each breakpoint on a closed-loop simulation of the plant,
+ * and checked in as gain_schedule_table.h (placed in SRAM via RAMDATA).
+ *
+ * Usage:
+ *     #include "gainsched.h"
+ *     #include "gain_schedule_table.h"
+ *     gainsched_t sched;
+ *     gainsched_init(&sched, GAIN_SCHEDULE_X0, GAIN_SCHEDULE_DX,
+ *                    GAIN_SCHEDULE_POINTS, gain_schedule_table);
+ *     …
+ *     gainsched_apply(&sched, &ctrl, ctrl.setpoint);  // each tick
+ *     float u = PID_COMPUTE(&ctrl, measured_value);
+ *
+ * gainsched_apply() hands the gains to pid_set_gains(), so a change of
+ * operating point never bumps the output, and skips the update while the
+ * scheduling variable is unchanged.
+ */
+
+#ifndef GAINSCHED_H
+#define GAINSCHED_H
+
+#include <stdint.h>
+#include "pid.h"
+#include "ramfunc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef struct
+{
+    float              x0;       /**< Scheduling variable at row 0        */
+    float              inv_dx;   /**< 1 / grid spacing                    */
+    uint32_t           n;        /**< Number of rows (≥ 2)                */
+    const float      (*gains)[3];/**< Rows of { Kp, Ki, Kd }              */
+    float              last_x;   /**< Variable of the last applied update */
+} gainsched_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Attach a table to a schedule.
+ * @param  sched  Schedule instance
+ * @param  x0     Scheduling variable at the first row
+ * @param  dx     Spacing of the rows (> 0)
+ * @param  n      Number of rows (≥ 2)
+ * @param  gains  n rows of { Kp, Ki (1/s), Kd (s) }
+ */
+void gainsched_init(gainsched_t *sched, float x0, float dx, uint32_t n,
+                    const float (*gains)[3]);
+
+/**
+ * @brief  Interpolated gains at x; x outside the grid uses the end rows.
+ * @param  out  { Kp, Ki, Kd }
+ */
+RAMFUNC void gainsched_lookup(const gainsched_t *sched, float x, float out[3]);
+
+/**
+ * @brief  Retune the controller for operating point x (bumpless).
+ * @return true if the gains were updated, false if x was unchanged
+ */
+bool gainsched_apply(gainsched_t *sched, pid_t *pid, float x);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* GAINSCHED_H */
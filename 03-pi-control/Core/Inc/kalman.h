@@ -0,0 +1,156 @@
+/**
+ * @file    kalman.h
+ * @brief   Two-state Kalman filter for the photocell reading (level and rate).
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * readSensor() delivers single noisy ADC samples.  Averaging them costs
+ * lag the loop cannot afford; the Kalman filter instead predicts the next
+ * reading from a model of the plant and the duty that was actually
+ * applied, and corrects the prediction with each sample.  The state is
+ *
+ *     x = [ level (%), rate (%/s) ]
+ *     x[k+1] = A·x[k] + B·u[k] + c + w,   z[k] = C·x[k] + v
+ *
+ * kalman_init_led() builds A, B and c from the two lags of the LED → CdS
+ * → ADC chain (a second-order system, exactly discretised for the sample
+ * period); kalman_init() takes any model of this shape.  Q is the process
+ * noise (model error, mostly on the rate), R the ADC noise variance.
+ *
+ * Two float variants:
+ *   - time-varying: propagates the covariance P every update, written
+ *     with the CMSIS-DSP matrix kernels (arm_mat_mult_f32, …);
+ *   - steady-state: kalman_make_steady() runs the same recursion to
+ *     convergence once, after which each update only applies the fixed
+ *     gain K – eight multiply-adds, written out.
+ * With KALMAN_FIXED_POINT=1 the steady-state filter is also available in
+ * Q16.16 (kalman_update_q16()), for callers that keep the loop in
+ * integers.  The cost of each variant is measured by the on-target bench
+ * against KALMAN_CYCLE_BUDGET.
+ *
+ * Usage:
+ *     #include "kalman.h"
+ *     kalman_t kf;
+ *     kalman_init_led(&kf, 0.01f, 0.045f, 0.020f, 0.8f, 5.0f, 5.0e5f, 3.0f);
+ *     kalman_make_steady(&kf, 1000u);                   // optional
+ *     kalman_reset(&kf, readSensor(&cell));
+ *     …
+ *     float y = kalman_update(&kf, duty_applied_last_tick, readSensor(&cell));
+ *     float u = PID_COMPUTE(&ctrl, y);
+ */
+
+#ifndef KALMAN_H
+#define KALMAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "arm_math.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef KALMAN_FIXED_POINT
+#define KALMAN_FIXED_POINT   0        /**< 1: also build the Q16.16 steady-state filter */
+#endif
+
+#ifndef KALMAN_CYCLE_BUDGET
+#define KALMAN_CYCLE_BUDGET  1500u    /**< Cycles per update (any variant) at 180 MHz */
+#endif
+
+#define KALMAN_Q16_ONE       65536    /**< 1.0 in Q16.16 */
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef struct
+{
+    /* Model, row-major */
+    float A[4];
+    float At[4];             /**< Aᵀ, precomputed                    */
+    float B[2];
+    float c[2];              /**< Constant input (ambient light)     */
+    float C[2];              /**< Measurement row                    */
+    float Q[4];              /**< Process noise covariance           */
+    float R;                 /**< Measurement noise variance         */
+
+    /* Estimate */
+    float x[2];              /**< [level, rate]                      */
+    float P[4];              /**< Error covariance                   */
+    float K[2];              /**< Last (or steady-state) gain        */
+    bool  steady;            /**< Fixed gain, P no longer propagated */
+
+    /* Scratch */
+    float t2a[2], t2b[2], t4a[4], t4b[4];
+
+    /* CMSIS matrix views on the buffers above */
+    arm_matrix_instance_f32 mA, mAt, mB, mc, mC, mCt, mQ, mX, mP, mK;
+    arm_matrix_instance_f32 mT2a, mT2aT, mT2b, mT4a, mT4b;
+
+#if KALMAN_FIXED_POINT
+    int32_t Aq[4], Bq[2], cq[2], Kq[2];  /**< Steady-state model, Q16.16 */
+    int32_t xq[2];                       /**< State, Q16.16              */
+#endif
+} kalman_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Set up the filter for a given model; measures C = [1 0].
+ * @param  A, Q  2×2 row-major
+ * @param  B, c  2×1
+ * @param  R     Measurement noise variance (reading %²)
+ */
+void kalman_init(kalman_t *kf, const float A[4], const float B[2], const float c[2],
+                 const float Q[4], float R);
+
+/**
+ * @brief  Model of the LED → CdS → ADC chain: two first-order lags in series.
+ * @param  ts       Sample period (s)
+ * @param  tau1     CdS time constant (s)
+ * @param  tau2     ADC filter time constant (s)
+ * @param  gain     Static gain (% reading per % duty)
+ * @param  ambient  Reading with the LED off (%)
+ * @param  q_rate   Process noise spectral density on the rate ((%/s)²·s)
+ * @param  r        ADC noise variance (%²)
+ */
+void kalman_init_led(kalman_t *kf, float ts, float tau1, float tau2, float gain,
+                     float ambient, float q_rate, float r);
+
+/**
+ * @brief  Restart at a known level with zero rate and the initial covariance.
+ */
+void kalman_reset(kalman_t *kf, float level);
+
+/**
+ * @brief  Iterate the Riccati recursion to a constant gain and switch to it.
+ * @return Iterations needed, or max_iter if it did not converge (still switched)
+ */
+uint32_t kalman_make_steady(kalman_t *kf, uint32_t max_iter);
+
+/**
+ * @brief  Predict with the duty of the last tick, correct with the new reading.
+ * @param  u  Duty applied during the last tick (%)
+ * @param  z  Reading at the end of that tick (%)
+ * @return Filtered level (%)
+ */
+float kalman_update(kalman_t *kf, float u, float z);
+
+#if KALMAN_FIXED_POINT
+/**
+ * @brief  Steady-state update in Q16.16 (kalman_make_steady() first).
+ * @return Filtered level, Q16.16
+ */
+int32_t kalman_update_q16(kalman_t *kf, int32_t u, int32_t z);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* KALMAN_H */
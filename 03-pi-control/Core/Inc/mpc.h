@@ -0,0 +1,112 @@
+/**
+ * @file    mpc.h
+ * @brief   Explicit model-predictive control of the LED loop.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * A PI controller only learns about the duty limits after the fact: the
+ * output is clamped and the integrator has to be stopped from winding
+ * up.  MPC plans the next ticks with the limits as constraints, so it
+ * brakes before the setpoint instead of overshooting it.
+ *
+ * Solving the constrained QP every tick is not needed.  Its solution is
+ * a piecewise-affine function of the parameter [level, rate, setpoint]:
+ * the parameter space splits into polyhedral regions, and within each
+ * one the duty is one affine map.  Tools/gen_mpc_table.py computes the
+ * regions offline and writes them to mpc_table.h (placed in SRAM via
+ * RAMDATA).  On the target, mpc_compute() finds the region that holds
+ * the parameter and applies its map.  It searches the region of the
+ * previous tick first, so a settled loop costs one region test.  The
+ * worst case is a scan of all MPC_TABLE_REGIONS regions.
+ *
+ * The level and rate come from the Kalman filter (kalman.h), whose model
+ * the table was built on.
+ *
+ * Usage:
+ *     #include "mpc.h"
+ *     #include "mpc_table.h"
+ *     kalman_t kf;
+ *     mpc_t    mpc;
+ *     kalman_init_led(&kf, 0.01f, 0.045f, 0.020f, 0.8f, 5.0f, 5.0e5f, 3.0f);
+ *     mpc_init(&mpc, mpc_table, MPC_TABLE_REGIONS, MPC_TABLE_U_MIN, MPC_TABLE_U_MAX);
+ *     …
+ *     kalman_update(&kf, u, readSensor(&cell));
+ *     u = mpc_compute(&mpc, kf.x[0], kf.x[1], setpoint);
+ *
+ * The duty limits are part of the table.  To change out_min/out_max,
+ * regenerate the table with --u-min/--u-max.
+ */
+
+#ifndef MPC_H
+#define MPC_H
+
+#include <stdint.h>
+#include "ramfunc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef MPC_MAX_INEQ
+#define MPC_MAX_INEQ      6u        /**< Rows per region (2 × input blocks) */
+#endif
+
+#ifndef MPC_EPS
+#define MPC_EPS           1e-5f     /**< Slack on a row, in units of the parameter span */
+#endif
+
+#ifndef MPC_CYCLE_BUDGET
+#define MPC_CYCLE_BUDGET  3000u     /**< Cycles per mpc_compute() at 180 MHz */
+#endif
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef struct
+{
+    uint32_t n_ineq;                /**< Rows in use                          */
+    float    ineq[MPC_MAX_INEQ][4]; /**< a·[level, rate, r] + b ≤ 0 per row    */
+    float    law[4];                /**< u = k·[level, rate, r] + k0           */
+} mpc_region_t;
+
+typedef struct
+{
+    const mpc_region_t *regions;    /**< Generated table                      */
+    uint32_t            n;          /**< Number of regions                    */
+    uint32_t            last;       /**< Region of the previous call          */
+    float               u_min;      /**< Duty limits the table was built for  */
+    float               u_max;
+} mpc_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Attach a generated table.
+ * @param  u_min, u_max  The limits of the table (MPC_TABLE_U_MIN/MAX);
+ *                       the result is kept inside them against rounding
+ */
+void mpc_init(mpc_t *mpc, const mpc_region_t *regions, uint32_t n,
+              float u_min, float u_max);
+
+/**
+ * @brief  Duty for the next tick.
+ * @param  level     Estimated reading (%)
+ * @param  rate      Estimated rate of change (%/s)
+ * @param  setpoint  Target reading (%)
+ * @return Duty (%), within [u_min, u_max]
+ *
+ * Between regions (rounding, or outside the sampled range) the region
+ * with the smallest violation is used.
+ */
+RAMFUNC float mpc_compute(mpc_t *mpc, float level, float rate, float setpoint);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* MPC_H */
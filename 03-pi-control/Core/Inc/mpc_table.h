@@ -0,0 +1,161 @@
+/**
+ * @file    mpc_table.h
+ * @brief   Explicit MPC law for the LED loop, generated by
+ *          Tools/gen_mpc_table.py – do not edit.
+ *
+ * Model: gain 0.8, ambient 5.0 %, lags 0.045/0.02 s at Ts=0.01 s.
+ * Horizon 30 ticks in blocks 1/2/27, rho=0.002,
+ * duty in [0, 100] %; 21 of 27 active sets reached.
+ */
+
+#ifndef MPC_TABLE_H
+#define MPC_TABLE_H
+
+#include "mpc.h"
+#include "ramfunc.h"
+
+#define MPC_TABLE_TS       0.01f
+#define MPC_TABLE_U_MIN    0.0f
+#define MPC_TABLE_U_MAX    100.0f
+#define MPC_TABLE_REGIONS  21u
+
+#if MPC_MAX_INEQ < 6
+#error "mpc_table.h needs a larger MPC_MAX_INEQ"
+#endif
+
+/* { rows, { a·[level, rate, r] + b <= 0 }, u = k·[level, rate, r] + k0 },
+   most-visited region first */
+RAMDATA static const mpc_region_t mpc_table[MPC_TABLE_REGIONS] = {
+    { 4u, {  /* min/min/free, 30.1 % */
+        { -6.272515e-03f, -9.116159e-05f,  9.115248e-03f, -1.421367e-02f },
+        { -5.882551e-03f, -9.684312e-05f,  9.433555e-03f, -1.775502e-02f },
+        { -8.111055e-04f, -1.541316e-05f,  1.244540e-02f, -9.339775e-01f },
+        {  8.111055e-04f,  1.541316e-05f, -1.244540e-02f,  5.817147e-02f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  0.000000e+00f } },
+    { 4u, {  /* max/max/free, 24.4 % */
+        {  6.272515e-03f,  9.116159e-05f, -9.115248e-03f,  2.416323e-01f },
+        {  5.882551e-03f,  9.684312e-05f, -9.433555e-03f,  3.018354e-01f },
+        { -8.111055e-04f, -1.541316e-05f,  1.244540e-02f, -9.889150e-01f },
+        {  8.111055e-04f,  1.541316e-05f, -1.244540e-02f,  1.131090e-01f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  1.000000e+02f } },
+    { 5u, {  /* min/free/free, 13.0 % */
+        { -7.274611e-03f, -7.419829e-05f,  8.112990e-03f, -4.191896e-03f },
+        { -5.882551e-03f, -9.684312e-05f,  9.433555e-03f, -2.113517e-01f },
+        {  5.882551e-03f,  9.684312e-05f, -9.433555e-03f,  1.775502e-02f },
+        {  4.741964e-04f,  5.358266e-06f,  1.248432e-02f, -1.105635e+00f },
+        { -4.741964e-04f, -5.358266e-06f, -1.248432e-02f,  6.479259e-02f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  0.000000e+00f } },
+    { 5u, {  /* max/free/free, 11.1 % */
+        {  7.274611e-03f,  7.419829e-05f, -8.112990e-03f,  7.126222e-02f },
+        { -5.882551e-03f, -9.684312e-05f,  9.433555e-03f, -3.018354e-01f },
+        {  5.882551e-03f,  9.684312e-05f, -9.433555e-03f,  1.082387e-01f },
+        {  4.741964e-04f,  5.358266e-06f,  1.248432e-02f, -1.101474e+00f },
+        { -4.741964e-04f, -5.358266e-06f, -1.248432e-02f,  6.063149e-02f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  1.000000e+02f } },
+    { 3u, {  /* min/min/min, 6.4 % */
+        { -4.878770e-03f, -7.202590e-05f,  1.057183e-02f, -2.846528e-02f },
+        { -3.980707e-03f, -6.642252e-05f,  1.119314e-02f, -3.606214e-02f },
+        { -8.111055e-04f, -1.541316e-05f,  1.244540e-02f, -5.817147e-02f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  0.000000e+00f } },
+    { 6u, {  /* free/free/free, 6.2 % */
+        { -7.274611e-03f, -7.419829e-05f,  8.112990e-03f, -7.126222e-02f },
+        {  7.274611e-03f,  7.419829e-05f, -8.112990e-03f,  4.191896e-03f },
+        {  9.555399e-03f,  7.915494e-06f, -3.673801e-03f, -4.999359e-01f },
+        { -9.555399e-03f, -7.915494e-06f,  3.673801e-03f,  2.940799e-02f },
+        {  2.201479e-05f,  7.265951e-07f,  1.249994e-02f, -1.064366e+00f },
+        { -2.201479e-05f, -7.265951e-07f, -1.249994e-02f,  6.260977e-02f },
+      }, { -1.084624e+01f, -1.106276e-01f,  1.209624e+01f, -6.250000e+00f } },
+    { 3u, {  /* max/max/max, 5.6 % */
+        {  4.878770e-03f,  7.202590e-05f, -1.057183e-02f,  4.839097e-01f },
+        {  3.980707e-03f,  6.642252e-05f, -1.119314e-02f,  6.130564e-01f },
+        {  8.111055e-04f,  1.541316e-05f, -1.244540e-02f,  9.889150e-01f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  1.000000e+02f } },
+    { 5u, {  /* free/max/free, 1.0 % */
+        { -6.272515e-03f, -9.116159e-05f,  9.115248e-03f, -2.416323e-01f },
+        {  6.272515e-03f,  9.116159e-05f, -9.115248e-03f,  1.570561e-01f },
+        { -9.555399e-03f, -7.915494e-06f,  3.673801e-03f,  4.999359e-01f },
+        {  3.576480e-04f,  1.011482e-06f,  1.249195e-02f, -1.092215e+00f },
+        { -3.576480e-04f, -1.011482e-06f, -1.249195e-02f,  8.076476e-02f },
+      }, { -7.416411e+00f, -1.077864e-01f,  1.077756e+01f, -1.856979e+02f } },
+    { 5u, {  /* free/min/free, 0.7 % */
+        { -6.272515e-03f, -9.116159e-05f,  9.115248e-03f, -9.878982e-02f },
+        {  6.272515e-03f,  9.116159e-05f, -9.115248e-03f,  1.421367e-02f },
+        {  9.555399e-03f,  7.915494e-06f, -3.673801e-03f, -2.940799e-02f },
+        {  3.576480e-04f,  1.011482e-06f,  1.249195e-02f, -1.075699e+00f },
+        { -3.576480e-04f, -1.011482e-06f, -1.249195e-02f,  6.424797e-02f },
+      }, { -7.416411e+00f, -1.077864e-01f,  1.077756e+01f, -1.680576e+01f } },
+    { 4u, {  /* min/free/max, 0.4 % */
+        { -8.580115e-03f, -8.767646e-05f,  5.514637e-03f,  3.396067e-01f },
+        { -3.980707e-03f, -6.642252e-05f,  1.119314e-02f, -5.506887e-01f },
+        {  3.980707e-03f,  6.642252e-05f, -1.119314e-02f,  4.140155e-01f },
+        { -4.741964e-04f, -5.358266e-06f, -1.248432e-02f,  1.105635e+00f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  0.000000e+00f } },
+    { 4u, {  /* free/max/max, 0.3 % */
+        { -4.878770e-03f, -7.202590e-05f,  1.057183e-02f, -4.839097e-01f },
+        {  4.878770e-03f,  7.202590e-05f, -1.057183e-02f,  4.168358e-01f },
+        { -4.540285e-03f, -4.490575e-06f, -1.113607e-02f,  1.332490e+00f },
+        { -3.576480e-04f, -1.011482e-06f, -1.249195e-02f,  1.092215e+00f },
+      }, { -7.273720e+00f, -1.073828e-01f,  1.576145e+01f, -6.214572e+02f } },
+    { 5u, {  /* free/free/min, 0.2 % */
+        { -8.580115e-03f, -8.767646e-05f,  5.514637e-03f, -6.371370e-02f },
+        {  8.580115e-03f,  8.767646e-05f, -5.514637e-03f, -1.532739e-02f },
+        {  4.540285e-03f,  4.490575e-06f,  1.113607e-02f, -3.008385e-01f },
+        { -4.540285e-03f, -4.490575e-06f, -1.113607e-02f,  7.838176e-02f },
+        {  2.201479e-05f,  7.265951e-07f,  1.249994e-02f, -6.260977e-02f },
+      }, { -1.085526e+01f, -1.109252e-01f,  6.976925e+00f,  1.939167e+01f } },
+    { 5u, {  /* free/free/max, 0.2 % */
+        { -8.580115e-03f, -8.767646e-05f,  5.514637e-03f,  2.605656e-01f },
+        {  8.580115e-03f,  8.767646e-05f, -5.514637e-03f, -3.396067e-01f },
+        {  4.540285e-03f,  4.490575e-06f,  1.113607e-02f, -1.332490e+00f },
+        { -4.540285e-03f, -4.490575e-06f, -1.113607e-02f,  1.110033e+00f },
+        { -2.201479e-05f, -7.265951e-07f, -1.249994e-02f,  1.064366e+00f },
+      }, { -1.085526e+01f, -1.109252e-01f,  6.976925e+00f,  4.296584e+02f } },
+    { 4u, {  /* free/min/min, 0.2 % */
+        { -4.878770e-03f, -7.202590e-05f,  1.057183e-02f, -9.553921e-02f },
+        {  4.878770e-03f,  7.202590e-05f, -1.057183e-02f,  2.846528e-02f },
+        {  4.540285e-03f,  4.490575e-06f,  1.113607e-02f, -7.838176e-02f },
+        {  3.576480e-04f,  1.011482e-06f,  1.249195e-02f, -6.424797e-02f },
+      }, { -7.273720e+00f, -1.073828e-01f,  1.576145e+01f, -4.243866e+01f } },
+    { 4u, {  /* max/free/min, 0.1 % */
+        {  8.580115e-03f,  8.767646e-05f, -5.514637e-03f,  6.371370e-02f },
+        { -3.980707e-03f, -6.642252e-05f,  1.119314e-02f, -2.351030e-01f },
+        {  3.980707e-03f,  6.642252e-05f, -1.119314e-02f,  9.842981e-02f },
+        {  4.741964e-04f,  5.358266e-06f,  1.248432e-02f, -6.063149e-02f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  1.000000e+02f } },
+    { 4u, {  /* min/max/free, 0.1 % */
+        { -6.272515e-03f, -9.116159e-05f,  9.115248e-03f, -1.570561e-01f },
+        {  5.882551e-03f,  9.684312e-05f, -9.433555e-03f,  2.113517e-01f },
+        { -8.111055e-04f, -1.541316e-05f,  1.244540e-02f, -9.738027e-01f },
+        {  8.111055e-04f,  1.541316e-05f, -1.244540e-02f,  9.799668e-02f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  0.000000e+00f } },
+    { 4u, {  /* max/min/free, 0.0 % */
+        {  6.272515e-03f,  9.116159e-05f, -9.115248e-03f,  9.878982e-02f },
+        { -5.882551e-03f, -9.684312e-05f,  9.433555e-03f, -1.082387e-01f },
+        { -8.111055e-04f, -1.541316e-05f,  1.244540e-02f, -9.490898e-01f },
+        {  8.111055e-04f,  1.541316e-05f, -1.244540e-02f,  7.328376e-02f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  1.000000e+02f } },
+    { 3u, {  /* min/max/max, 0.0 % */
+        { -4.878770e-03f, -7.202590e-05f,  1.057183e-02f, -4.168358e-01f },
+        {  3.980707e-03f,  6.642252e-05f, -1.119314e-02f,  5.506887e-01f },
+        {  8.111055e-04f,  1.541316e-05f, -1.244540e-02f,  9.738027e-01f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  0.000000e+00f } },
+    { 4u, {  /* min/free/min, 0.0 % */
+        { -8.580115e-03f, -8.767646e-05f,  5.514637e-03f,  1.532739e-02f },
+        { -3.980707e-03f, -6.642252e-05f,  1.119314e-02f, -1.727354e-01f },
+        {  3.980707e-03f,  6.642252e-05f, -1.119314e-02f,  3.606214e-02f },
+        {  4.741964e-04f,  5.358266e-06f,  1.248432e-02f, -6.479259e-02f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  0.000000e+00f } },
+    { 4u, {  /* max/free/max, 0.0 % */
+        {  8.580115e-03f,  8.767646e-05f, -5.514637e-03f, -2.605656e-01f },
+        { -3.980707e-03f, -6.642252e-05f,  1.119314e-02f, -6.130564e-01f },
+        {  3.980707e-03f,  6.642252e-05f, -1.119314e-02f,  4.763832e-01f },
+        { -4.741964e-04f, -5.358266e-06f, -1.248432e-02f,  1.101474e+00f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  1.000000e+02f } },
+    { 3u, {  /* max/min/min, 0.0 % */
+        {  4.878770e-03f,  7.202590e-05f, -1.057183e-02f,  9.553921e-02f },
+        { -3.980707e-03f, -6.642252e-05f,  1.119314e-02f, -9.842981e-02f },
+        { -8.111055e-04f, -1.541316e-05f,  1.244540e-02f, -7.328376e-02f },
+      }, {  0.000000e+00f,  0.000000e+00f,  0.000000e+00f,  1.000000e+02f } },
+};
+
+#endif /* MPC_TABLE_H */
@@ -0,0 +1,103 @@
+/**
+ * @file    parambox.h
+ * @brief   Lock-free single-writer parameter hand-over (seqlock latch).
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * A command handler publishes a new parameter block while the control
+ * task keeps running; the control task polls the box at the start of
+ * each tick and applies the block only if it was read untorn.  The box
+ * keeps two copies and a sequence counter (a "latch" seqlock): while the
+ * writer updates one copy the sequence steers readers to the other, so
+ * a reader that is never interrupted by the writer (higher-priority task
+ * or ISR on a single core) always succeeds at the first attempt.  A
+ * reader that does race the writer retries a bounded number of times
+ * and otherwise keeps its current parameters until the next tick – it
+ * never blocks and never spins on the writer.
+ *
+ * Usage:
+ *     #include "parambox.h"
+ *     parambox_t box;
+ *     parambox_init(&box, &params, sizeof params);
+ *     …
+ *     parambox_publish(&box, &new_params);             // command task
+ *     …
+ *     static uint32_t seen;
+ *     if (parambox_poll(&box, &params, &seen))         // control tick
+ *         pid_apply_params(&ctrl, &params);
+ *
+ * Only one context may publish.  Several writers need a mutex around
+ * parambox_publish(); the reader side stays lock-free either way.
+ */
+
+#ifndef PARAMBOX_H
+#define PARAMBOX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef PARAMBOX_MAX_SIZE
+#define PARAMBOX_MAX_SIZE    64u    /**< Largest payload in bytes */
+#endif
+
+#ifndef PARAMBOX_READ_TRIES
+#define PARAMBOX_READ_TRIES  2u     /**< Attempts per poll before giving up */
+#endif
+
+#define PARAMBOX_WORDS       ((PARAMBOX_MAX_SIZE + 3u) / 4u)
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef struct
+{
+    _Atomic uint32_t seq;       /**< 2·version, odd while copy 0 is written */
+    uint32_t         size;      /**< Payload size in bytes                  */
+    _Atomic uint32_t data[2][PARAMBOX_WORDS];  /**< The two copies         */
+} parambox_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Initialise the box with a first payload (version 0).
+ * @param  box      Box instance
+ * @param  initial  Initial payload
+ * @param  size     Payload size in bytes, at most PARAMBOX_MAX_SIZE
+ */
+void parambox_init(parambox_t *box, const void *initial, size_t size);
+
+/**
+ * @brief  Publish a new payload.  Single writer only; never blocks.
+ */
+void parambox_publish(parambox_t *box, const void *payload);
+
+/**
+ * @brief  Copy out the newest payload if it is newer than *last_version.
+ * @param  box           Box instance
+ * @param  out           Destination, written only on success
+ * @param  last_version  Version the caller holds; updated on success
+ * @return true if a new, consistent payload was copied to out
+ */
+bool parambox_poll(parambox_t *box, void *out, uint32_t *last_version);
+
+/**
+ * @brief  Version of the most recently started publication.
+ */
+uint32_t parambox_version(parambox_t *box);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PARAMBOX_H */
@@ -1,6 +1,6 @@
 /**
  * @file    pid.h
- * @brief   Tiny PI controller suitable for embedded targets.
+ * @brief   Tiny PI(D) controller suitable for embedded targets.
  *
  * Copyright (c) 2025 Kevin Fox
  * SPDX-License-Identifier: MIT
@@ -12,6 +12,39 @@
  *     …
  *     float u = PID_COMPUTE(&ctrl, measured_value);
  *     set_pwm_duty(u);                 // clamp already handled inside PID_COMPUTE
+ *
+ * Anti-windup: while the output sits at a limit the integrator must not
+ * keep growing, or the loop overshoots for a long time once the limit is
+ * released.  pid_set_antiwindup() selects the strategy.  pid_compute()
+ * has no data-dependent branches, so its execution time depends on the
+ * mode only: none and clamping take a short path, conditional integration
+ * and back-calculation share one straight-line update.
+ *
+ * Sample time: Ki and Kt are continuous-time gains (1/s) and Ts is the
+ * sample period in seconds.  pid_set_sample_time() picks the integrator
+ * discretisation and precomputes its coefficients, so the same tuning
+ * holds at 100 Hz and at 10 kHz.  With the default Ts = 1 the gains are
+ * simply "per call".  Loops without a fixed rate can pass the measured
+ * interval to pid_compute_dt() instead:
+ *
+ *     pid_set_sample_time(&ctrl, 0.001f, PID_DISC_TUSTIN);   // 1 kHz
+ *     u = pid_compute_dt(&ctrl, y, (now - last) / (float)SystemCoreClock);
+ *
+ * Derivative: pid_set_derivative() adds Kd·s / (Tf·s + 1) acting on the
+ * measurement, not on the error, so a setpoint step causes no derivative
+ * kick.  The low-pass filter is discretised with a backward difference,
+ * which is stable for any Tf ≥ 0; the coefficients are precomputed, so
+ * the term costs two multiply-adds per step.  Kd defaults to 0 (PI).
+ *
+ * Velocity form: pid_set_form(&ctrl, PID_FORM_VELOCITY) computes Δu from
+ * the last two errors and accumulates the clamped output instead of an
+ * integral, so there is nothing to wind up.  In either form,
+ * pid_set_gains() retunes online without an output bump, and
+ * pid_track() keeps the controller aligned with a manually commanded
+ * output so the switch back to automatic is bumpless:
+ *
+ *     if (manual) u = pid_track(&ctrl, y, u_manual);
+ *     else        u = PID_COMPUTE(&ctrl, y);
  */
 
 #ifndef PID_H
@@ -19,6 +52,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <float.h>
+#include "ramfunc.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +72,14 @@ extern "C" {
 #define PID_KI            0.0f      /**< Integral gain */
 #endif
 
+#ifndef PID_KD
+#define PID_KD            0.0f      /**< Derivative gain in s (0: PI only) */
+#endif
+
+#ifndef PID_TF
+#define PID_TF            0.0f      /**< Derivative filter time constant in s */
+#endif
+
 #ifndef PID_SETPOINT
 #define PID_SETPOINT      100.0f    /**< Desired process value */
 #endif
@@ -49,19 +92,101 @@ extern "C" {
 #define PID_OUT_MAX       100.0f    /**< Upper clamp for controller output */
 #endif
 
+#ifndef PID_TS
+#define PID_TS            1.0f      /**< Sample period in s (1: gains per call) */
+#endif
+
+#ifndef PID_DISCRETIZATION
+#define PID_DISCRETIZATION PID_DISC_BACKWARD  /**< Integrator discretisation */
+#endif
+
+#ifndef PID_FORM
+#define PID_FORM          PID_FORM_POSITIONAL  /**< Controller algorithm form */
+#endif
+
+#ifndef PID_ANTIWINDUP
+#define PID_ANTIWINDUP    PID_AW_CLAMP  /**< Default anti-windup strategy */
+#endif
+
+#ifndef PID_KT
+#define PID_KT            0.5f      /**< Back-calculation tracking gain (1/s, Kt·Ts ≤ 1) */
+#endif
+
 /* --------------------------------------------------------------------
  * Data structure
  * ------------------------------------------------------------------*/
+typedef enum
+{
+    PID_DISC_FORWARD = 0,  /**< I += Ki·Ts·e[k-1]            (explicit Euler) */
+    PID_DISC_BACKWARD,     /**< I += Ki·Ts·e[k]              (implicit Euler) */
+    PID_DISC_TUSTIN        /**< I += Ki·Ts·(e[k]+e[k-1])/2   (trapezoidal)    */
+} pid_disc_t;
+
+typedef enum
+{
+    PID_FORM_POSITIONAL = 0, /**< u = P + I + D                            */
+    PID_FORM_VELOCITY        /**< u += ΔP + ΔI + ΔD, u clamped each step   */
+} pid_form_t;
+
+typedef enum
+{
+    PID_AW_NONE = 0,     /**< Integrate unconditionally (winds up)             */
+    PID_AW_CLAMP,        /**< Clamp the integral term to [out_min, out_max]    */
+    PID_AW_CONDITIONAL,  /**< Freeze integration while it would deepen saturation */
+    PID_AW_BACKCALC      /**< Bleed off integral by Kt × (saturated − raw output) */
+} pid_antiwindup_t;
+
 typedef struct
 {
     float Kp;          /**< Proportional gain                  */
-    float Ki;          /**< Integral gain                      */
+    float Ki;          /**< Integral gain (1/s)                */
     float setpoint;    /**< Target value                       */
-    float integral;    /**< Accumulated integral term          */
+    float integral;    /**< Integral term, in output units     */
     float out_min;     /**< Minimum allowed controller output  */
     float out_max;     /**< Maximum allowed controller output  */
+
+    /* Discretisation, derived by pid_set_sample_time() */
+    float Ts;          /**< Sample period (s)                              */
+    pid_disc_t disc;   /**< Integrator discretisation                      */
+    float disc_w0;     /**< Weight of e[k] in the integral increment       */
+    float disc_w1;     /**< Weight of e[k-1] in the integral increment     */
+    float ki_b0;       /**< Ki·Ts·disc_w0                                  */
+    float ki_b1;       /**< Ki·Ts·disc_w1                                  */
+    float e_prev;      /**< Error of the previous sample                   */
+
+    /* Filtered derivative on measurement, see pid_set_derivative() */
+    float Kd;          /**< Derivative gain (s)                            */
+    float Tf;          /**< Filter time constant (s)                       */
+    float d_a;         /**< Filter pole: Tf / (Tf + Ts)                    */
+    float d_b;         /**< Kd / (Tf + Ts)                                 */
+    float deriv;       /**< Derivative term, in output units               */
+    float y_prev;      /**< Measurement of the previous sample             */
+    float d_primed;    /**< 0 until y_prev holds a real sample, then 1     */
+
+    pid_form_t form;   /**< Positional or velocity algorithm               */
+    float out;         /**< Last output (the velocity-form accumulator)    */
+
+    /* Anti-windup constants, derived by pid_set_antiwindup() */
+    pid_antiwindup_t aw;   /**< Selected strategy                         */
+    float aw_min;      /**< Integral lower bound (-FLT_MAX if unclamped)   */
+    float aw_max;      /**< Integral upper bound (+FLT_MAX if unclamped)   */
+    float aw_gate;     /**< Weight of di in saturation (0: conditional)    */
+    float aw_kt;       /**< Back-calculation gain, 1/s (0 when not selected) */
+    float aw_kt_ts;    /**< aw_kt·Ts                                       */
 } pid_t;
 
+/* Run-time tunable subset, e.g. handed over through a parambox_t */
+typedef struct
+{
+    float Kp;          /**< Proportional gain                  */
+    float Ki;          /**< Integral gain (1/s)                */
+    float Kd;          /**< Derivative gain (s)                */
+    float Tf;          /**< Derivative filter time constant (s) */
+    float setpoint;    /**< Target value                       */
+    float out_min;     /**< Minimum allowed controller output  */
+    float out_max;     /**< Maximum allowed controller output  */
+} pid_params_t;
+
 /* Macro that yields a fully-initialised instance using the
  * default #defines above.  Example:
  *     pid_t led_ctrl = PID_DEFAULTS;
@@ -73,18 +198,46 @@ typedef struct
     .setpoint  = PID_SETPOINT, \
     .integral  = 0.0f,         \
     .out_min   = PID_OUT_MIN,  \
-    .out_max   = PID_OUT_MAX   \
+    .out_max   = PID_OUT_MAX,  \
+    .Ts        = PID_TS,       \
+    .disc      = PID_DISCRETIZATION, \
+    .disc_w0   = PID_DISC_W0(PID_DISCRETIZATION), \
+    .disc_w1   = PID_DISC_W1(PID_DISCRETIZATION), \
+    .ki_b0     = PID_KI * PID_TS * PID_DISC_W0(PID_DISCRETIZATION), \
+    .ki_b1     = PID_KI * PID_TS * PID_DISC_W1(PID_DISCRETIZATION), \
+    .e_prev    = 0.0f,         \
+    .Kd        = PID_KD,       \
+    .Tf        = PID_TF,       \
+    .d_a       = PID_TF / (PID_TF + PID_TS), \
+    .d_b       = PID_KD / (PID_TF + PID_TS), \
+    .deriv     = 0.0f,         \
+    .y_prev    = 0.0f,         \
+    .d_primed  = 0.0f,         \
+    .form      = PID_FORM,     \
+    .out       = 0.0f,         \
+    .aw        = PID_ANTIWINDUP, \
+    .aw_min    = (PID_ANTIWINDUP == PID_AW_CLAMP) ? PID_OUT_MIN : -FLT_MAX, \
+    .aw_max    = (PID_ANTIWINDUP == PID_AW_CLAMP) ? PID_OUT_MAX :  FLT_MAX, \
+    .aw_gate   = (PID_ANTIWINDUP == PID_AW_CONDITIONAL) ? 0.0f : 1.0f,   \
+    .aw_kt     = (PID_ANTIWINDUP == PID_AW_BACKCALC) ? PID_KT : 0.0f,     \
+    .aw_kt_ts  = (PID_ANTIWINDUP == PID_AW_BACKCALC) ? PID_KT * PID_TS : 0.0f \
 }
 
+/* Integrator weights of e[k] / e[k-1] for a pid_disc_t (constant expressions) */
+#define PID_DISC_W0(d)  ((d) == PID_DISC_FORWARD ? 0.0f : (d) == PID_DISC_TUSTIN ? 0.5f : 1.0f)
+#define PID_DISC_W1(d)  ((d) == PID_DISC_FORWARD ? 1.0f : (d) == PID_DISC_TUSTIN ? 0.5f : 0.0f)
+
 /* --------------------------------------------------------------------
  * API
  * ------------------------------------------------------------------*/
 
 /**
  * @brief  Initialise (or re-initialise) a controller at run time.
+ *         Sample time is set to PID_TS with PID_DISCRETIZATION, and
+ *         anti-windup to PID_ANTIWINDUP with tracking gain PID_KT.
  * @param  pid       Pointer to controller instance
  * @param  kp        Proportional gain
- * @param  ki        Integral gain
+ * @param  ki        Integral gain (1/s; per call while Ts = 1)
  * @param  setpoint  Desired process value
  * @param  out_min   Lower saturation limit
  * @param  out_max   Upper saturation limit
@@ -96,14 +249,111 @@ void pid_init(pid_t *pid,
               float  out_min,
               float  out_max);
 
+/**
+ * @brief  Set the sample period and integrator discretisation, and
+ *         precompute the coefficients used by pid_compute().
+ *         Call again after changing Ki directly.
+ * @param  pid   Pointer to controller instance
+ * @param  ts    Sample period in seconds
+ * @param  disc  Discretisation method
+ */
+void pid_set_sample_time(pid_t *pid, float ts, pid_disc_t disc);
+
+/**
+ * @brief  Set the derivative gain and its filter time constant.  The
+ *         term acts on -d(measured)/dt and is recomputed for Ts by
+ *         pid_set_sample_time().
+ * @param  pid   Pointer to controller instance
+ * @param  kd    Derivative gain in s (0 disables the term)
+ * @param  tf    Low-pass time constant in s, typically Kd/Kp / 5…20
+ */
+void pid_set_derivative(pid_t *pid, float kd, float tf);
+
+/**
+ * @brief  Change the gains online without a jump in the output.
+ *         In positional form the change in P and D is absorbed into the
+ *         integral, kept within the anti-windup bounds; the velocity
+ *         form is bumpless by construction.
+ * @param  pid   Pointer to controller instance
+ * @param  kp    Proportional gain
+ * @param  ki    Integral gain (1/s)
+ * @param  kd    Derivative gain (s), filter time constant unchanged
+ */
+void pid_set_gains(pid_t *pid, float kp, float ki, float kd);
+
+/**
+ * @brief  Apply a parameter block at a tick boundary: gains change
+ *         bumplessly (pid_set_gains()), limits and setpoint take effect
+ *         with the next pid_compute().
+ */
+void pid_apply_params(pid_t *pid, const pid_params_t *params);
+
+/**
+ * @brief  Read the current tunable parameters back.
+ */
+void pid_get_params(const pid_t *pid, pid_params_t *params);
+
+/**
+ * @brief  Switch between positional and velocity form, continuing from
+ *         the last output.
+ */
+void pid_set_form(pid_t *pid, pid_form_t form);
+
+/**
+ * @brief  Manual mode: report the externally commanded output so that
+ *         the controller state follows it.  The next pid_compute()
+ *         continues from u without a bump.
+ * @param  pid       Pointer to controller instance
+ * @param  measured  Current process value
+ * @param  u         Output applied in manual mode
+ * @return float     u clamped to [out_min, out_max]
+ */
+float pid_track(pid_t *pid, float measured, float u);
+
+/**
+ * @brief  A stage after the controller (slew.h, …) applied u instead of
+ *         the last pid_compute() output: rebuild the integral so that
+ *         output would have been u.  Unlike pid_track() it does not take
+ *         a new sample, so call it in the same tick, after pid_compute().
+ *         The integrator then never winds up against the stage.  Use it
+ *         with PID_AW_CLAMP or PID_AW_BACKCALC.  PID_AW_CONDITIONAL keeps
+ *         the tracked integral frozen while P alone exceeds the limit.
+ * @param  pid  Pointer to controller instance
+ * @param  u    Output actually applied
+ */
+RAMFUNC void pid_track_applied(pid_t *pid, float u);
+
+/**
+ * @brief  Select the anti-windup strategy (positional form only; the
+ *         velocity form clamps its accumulated output instead).
+ * @param  pid   Pointer to controller instance
+ * @param  mode  Strategy, see pid_antiwindup_t
+ * @param  kt    Tracking gain in 1/s for PID_AW_BACKCALC (ignored
+ *               otherwise); Kt·Ts = 1 snaps the integral back to the
+ *               limit in one step
+ */
+void pid_set_antiwindup(pid_t *pid, pid_antiwindup_t mode, float kt);
+
 /**
  * @brief  Return the control effort for the current measurement.
- *         Output is clamped to [out_min, out_max].
+ *         Output is clamped to [out_min, out_max].  Constant-time: no
+ *         data-dependent branches.
+ * @param  pid       Pointer to controller instance
+ * @param  measured  Current process value
+ * @return float     Controller output
+ */
+RAMFUNC float pid_compute(pid_t *pid, float measured);
+
+/**
+ * @brief  Like pid_compute(), but for a measured interval instead of Ts.
+ *         The integrator coefficients are formed from dt on the fly.
  * @param  pid       Pointer to controller instance
  * @param  measured  Current process value
+ * @param  dt        Seconds since the previous sample; for dt <= 0 the
+ *                   state is left alone and the last output returned
  * @return float     Controller output
  */
-float pid_compute(pid_t *pid, float measured);
+RAMFUNC float pid_compute_dt(pid_t *pid, float measured, float dt);
 
 /* -------------- Convenience macro (computes in-place) -------------- */
 #define PID_COMPUTE(pid_ptr, meas)  pid_compute((pid_ptr), (meas))
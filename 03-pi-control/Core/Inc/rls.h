@@ -0,0 +1,128 @@
+/**
+ * @file    rls.h
+ * @brief   Online recursive-least-squares fit of an ARX model of the plant.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * Runs next to the controller and fits, once per tick, the model
+ *
+ *     y[k] = -a1·y[k-1] - a2·y[k-2] + b1·u[k-1] + b2·u[k-2] + c
+ *
+ * from the applied duty u (%) and the photocell reading y (%).  Two poles
+ * cover the CdS lag and the ADC filter; c absorbs the ambient light.  The
+ * update is standard exponentially-weighted RLS,
+ *
+ *     K = P·φ / (λ + φᵀ·P·φ)      θ += K·(y - φᵀ·θ)      P = (P - K·φᵀ·P) / λ
+ *
+ * written with the CMSIS-DSP matrix kernels (arm_mat_mult_f32, …) on
+ * fixed-size buffers, so every update executes the same operations and
+ * its cost is bounded.  No matrix inverse is needed: the gain divides by
+ * a scalar.  While the loop sits still, forgetting would make P grow
+ * without bound ("covariance wind-up"); the update therefore stops
+ * forgetting once trace(P) reaches RLS_TRACE_MAX.
+ *
+ * Usage:
+ *     #include "rls.h"
+ *     rls_t id;
+ *     rls_init(&id, RLS_LAMBDA, RLS_P0);
+ *     …
+ *     rls_update(&id, duty_applied_last_tick, reading);   // each tick
+ *     float k = rls_dc_gain(&id);                         // % reading / % duty
+ *     ctrl_kp = kp_nominal * (k_nominal / k);             // adaptive gain
+ *
+ * The estimate is in id.theta[RLS_A1 … RLS_C]; rls_dc_gain() and
+ * id.err (last a-priori prediction error) are meant for telemetry.
+ */
+
+#ifndef RLS_H
+#define RLS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "arm_math.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef RLS_LAMBDA
+#define RLS_LAMBDA        0.995f    /**< Forgetting factor (memory ≈ 1/(1-λ) ticks) */
+#endif
+
+#ifndef RLS_P0
+#define RLS_P0            1000.0f   /**< Initial covariance (diagonal)          */
+#endif
+
+#ifndef RLS_TRACE_MAX
+#define RLS_TRACE_MAX     1.0e4f    /**< trace(P) above which forgetting stops  */
+#endif
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef enum
+{
+    RLS_A1 = 0,       /**< Output coefficients                 */
+    RLS_A2,
+    RLS_B1,           /**< Input coefficients                  */
+    RLS_B2,
+    RLS_C,            /**< Offset (ambient light)              */
+    RLS_N             /**< Number of parameters                */
+} rls_param_t;
+
+typedef struct
+{
+    float lambda;                  /**< Forgetting factor                  */
+    float theta[RLS_N];            /**< Estimate, indexed by rls_param_t   */
+    float P[RLS_N * RLS_N];        /**< Covariance, row-major              */
+    float phi[RLS_N];              /**< Regressor of the next update       */
+    float Pphi[RLS_N];             /**< P·φ                                */
+    float dtheta[RLS_N];           /**< Correction K·e                     */
+    float outer[RLS_N * RLS_N];    /**< (P·φ)·(P·φ)ᵀ scratch               */
+    float err;                     /**< Last a-priori prediction error     */
+    uint32_t updates;              /**< Number of updates so far           */
+
+    /* CMSIS matrix views on the buffers above */
+    arm_matrix_instance_f32 mP, mTheta, mPhi, mPhiT, mPphi, mPphiT, mDtheta, mOuter;
+} rls_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Reset the estimate to zero and P to p0·I.
+ * @param  lambda  Forgetting factor in (0, 1]
+ * @param  p0      Initial covariance; large means "no prior knowledge"
+ */
+void rls_init(rls_t *rls, float lambda, float p0);
+
+/**
+ * @brief  One RLS step with the newest sample.
+ * @param  u  Duty applied during the last tick (%)
+ * @param  y  Reading at the end of that tick (%)
+ * @return A-priori prediction error y - φᵀ·θ
+ *
+ * The first two calls only fill the regressor.
+ */
+float rls_update(rls_t *rls, float u, float y);
+
+/**
+ * @brief  One-step prediction of the next reading for duty u.
+ */
+float rls_predict(const rls_t *rls, float u);
+
+/**
+ * @brief  Static gain of the fitted model, (b1 + b2) / (1 + a1 + a2).
+ * @return Gain in % reading per % duty, 0 while the model is degenerate
+ */
+float rls_dc_gain(const rls_t *rls);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* RLS_H */
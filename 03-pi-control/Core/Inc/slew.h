@@ -0,0 +1,94 @@
+/**
+ * @file    slew.h
+ * @brief   Rate- and jerk-limiting stage between controller and actuator.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * The controller output is clamped to [out_min, out_max] and nothing
+ * else, so a setpoint step slams the duty from one end to the other in
+ * one tick.  The LED flashes, and the slow CdS cell is driven far past
+ * its final value.  slew_step() moves the applied duty towards the
+ * controller output by at most `rate` per second.  With `jerk` set, that
+ * speed itself changes by at most `jerk` per second², and the stage
+ * brakes early enough to stop on the target without overshooting it.
+ *
+ * Each channel has its own slew_t, so stages compose: controller →
+ * slew → actuator per output.  The update is straight-line code (selects,
+ * one square root), so its cycle count does not depend on the state.
+ *
+ * The integrator must learn what was really applied, or it winds up
+ * while the stage lags and the loop overshoots afterwards.
+ * pid_track_applied() feeds the limited output back into the controller
+ * through its anti-windup:
+ *
+ *     #include "slew.h"
+ *     slew_t slew;
+ *     slew_init(&slew, 200.0f, 4000.0f, 0.01f, 0.0f);  // 200 %/s, 4000 %/s², 100 Hz
+ *     …
+ *     float u = PID_COMPUTE(&ctrl, y);
+ *     u = slew_step(&slew, u);
+ *     pid_track_applied(&ctrl, u);
+ *     set_pwm_duty(u);
+ */
+
+#ifndef SLEW_H
+#define SLEW_H
+
+#include "ramfunc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef struct
+{
+    float rate;        /**< Speed limit (units/s), 0: none             */
+    float jerk;        /**< Acceleration limit (units/s²), 0: none     */
+    float ts;          /**< Sample period (s)                          */
+
+    /* Derived by slew_set_limits() */
+    float dv_max;      /**< rate·Ts: largest step                      */
+    float dd_max;      /**< jerk·Ts²: largest change of the step       */
+    float jerk_on;     /**< 1 with a jerk limit, else 0                */
+
+    float out;         /**< Applied output                             */
+    float step;        /**< Last change of the output (speed·Ts)       */
+} slew_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Initialise a stage at rest on u0.
+ * @param  rate  Speed limit in output units per second (0: unlimited)
+ * @param  jerk  Limit on the change of speed, units/s² (0: rate only)
+ * @param  ts    Sample period in seconds
+ */
+void slew_init(slew_t *s, float rate, float jerk, float ts, float u0);
+
+/**
+ * @brief  Change the limits; the output continues from where it is.
+ */
+void slew_set_limits(slew_t *s, float rate, float jerk);
+
+/**
+ * @brief  Jump to u and stop (e.g. when the loop is re-enabled).
+ */
+void slew_reset(slew_t *s, float u);
+
+/**
+ * @brief  Move towards the controller output.
+ * @param  target  Requested output
+ * @return Output to apply this tick
+ */
+RAMFUNC float slew_step(slew_t *s, float target);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SLEW_H */
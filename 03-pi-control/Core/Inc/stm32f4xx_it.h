@@ -58,6 +58,7 @@ void ADC_IRQHandler(void);
 void USART2_IRQHandler(void);
 void TIM6_DAC_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void DMA1_Stream1_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -0,0 +1,59 @@
+/**
+ * @file    timebase.h
+ * @brief   Free-running 32-bit time base on TIM5 that keeps counting in sleep.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * DWT CYCCNT stops with the core clock in WFI, so periods that span a
+ * sleep come up short.  TIM5 counts the APB1 timer clock (90 MHz here:
+ * PCLK1 is 45 MHz and doubled because APB1 is divided), which sleep does
+ * not gate while RCC_APB1LPENR.TIM5LPEN is set, as it is from reset.  It
+ * wraps every ~47.7 s; always take differences with unsigned arithmetic.
+ */
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Start TIM5 from zero, unprescaled, over the full 32-bit range. */
+static inline void timebase_init(void)
+{
+    __HAL_RCC_TIM5_CLK_ENABLE();
+    TIM5->CR1 = 0u;
+    TIM5->PSC = 0u;
+    TIM5->ARR = 0xFFFFFFFFu;
+    TIM5->CNT = 0u;
+    TIM5->EGR = TIM_EGR_UG;             /* load PSC */
+    TIM5->CR1 = TIM_CR1_CEN;
+}
+
+/** Current count. */
+static inline uint32_t timebase_ticks(void)
+{
+    return TIM5->CNT;
+}
+
+/** Counting rate in Hz: PCLK1, doubled when APB1 is divided. */
+static inline uint32_t timebase_hz(void)
+{
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    return ((RCC->CFGR & RCC_CFGR_PPRE1) == RCC_CFGR_PPRE1_DIV1) ? pclk1 : 2u * pclk1;
+}
+
+/** Convert microseconds to ticks. */
+static inline uint32_t timebase_us_to_ticks(uint32_t us)
+{
+    return (timebase_hz() / 1000000u) * us;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* TIMEBASE_H */
@@ -0,0 +1,171 @@
+/**
+ * @file    waveform.h
+ * @brief   Duty-cycle waveforms streamed into the PWM compare register.
+ *
+ * Copyright (c) 2025 Kevin Fox
+ * SPDX-License-Identifier: MIT
+ *
+ * A sweep written from a task moves the duty once per wake-up.  Every
+ * step costs a context switch, and the step lands wherever the scheduler
+ * lets it.  Here the duty profile is rendered into a buffer of compare
+ * values instead.  On every timer update event DMA copies the next one
+ * into CCR2, so the output changes exactly on the PWM period boundary
+ * and the CPU does no work per sample.
+ *
+ * The buffer is one circular DMA transfer of two halves.  While DMA
+ * plays one half, the half-/full-transfer interrupt calls
+ * waveform_refill() to render the next WAVEFORM_HALF_LEN samples into the
+ * other half.  At 1 kHz PWM that leaves the interrupt 64 ms per refill.
+ *
+ * A profile is either piecewise linear (ramps, triangle sweeps and
+ * calibration staircases) or a linear sine chirp.  Each sample is held
+ * for `hold` update events, so the sample rate is the PWM rate / hold.
+ *
+ * The module only renders buffers and runs unchanged on the host.  The
+ * DMA stream (TIM2_UP: DMA1 Stream 1, channel 3) is set up in main.c.
+ *
+ * Usage:
+ *     #include "waveform.h"
+ *     static const waveform_point_t tri[] = {
+ *         { 0.0f, 10000u }, { 100.0f, 10000u }, { 0.0f, 0u } };
+ *     static waveform_t wf;
+ *     waveform_init(&wf, htim2.Init.Period + 1u, 1u);
+ *     waveform_load_pwl(&wf, tri, 3u, true);
+ *     waveform_prime(&wf);                        // both halves
+ *     HAL_DMA_Start_IT(&hdma_tim2_up, (uint32_t)wf.buf,
+ *                      (uint32_t)&TIM2->CCR2, WAVEFORM_BUF_LEN);
+ *     __HAL_TIM_ENABLE_DMA(&htim2, TIM_DMA_UPDATE);
+ *     …
+ *     half-transfer callback:  waveform_refill(&wf, 0u);
+ *     transfer-complete cb:    waveform_refill(&wf, 1u);
+ */
+
+#ifndef WAVEFORM_H
+#define WAVEFORM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ramfunc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --------------------------------------------------------------------
+ * Compile-time configuration
+ * ------------------------------------------------------------------*/
+#ifndef WAVEFORM_HALF_LEN
+#define WAVEFORM_HALF_LEN     64u     /**< Samples rendered per refill */
+#endif
+
+#define WAVEFORM_BUF_LEN      (2u * WAVEFORM_HALF_LEN)
+
+/* --------------------------------------------------------------------
+ * Data structure
+ * ------------------------------------------------------------------*/
+typedef enum
+{
+    WAVEFORM_PWL = 0,       /**< Linear segments between points   */
+    WAVEFORM_CHIRP          /**< Sine, frequency swept linearly   */
+} waveform_kind_t;
+
+/**
+ * One breakpoint.  The segment to the next point lasts `samples`
+ * samples; zero makes the next point a step.  The last point's
+ * `samples` is ignored.
+ */
+typedef struct
+{
+    float    duty;          /**< Duty at this point (%)            */
+    uint32_t samples;       /**< Length of the following segment   */
+} waveform_point_t;
+
+typedef struct
+{
+    uint32_t buf[WAVEFORM_BUF_LEN]; /**< DMA source: compare values (32-bit CCR) */
+
+    uint32_t counts;        /**< Compare value of 100 % duty (ARR + 1)  */
+    uint32_t hold;          /**< Update events per sample               */
+    waveform_kind_t kind;
+    bool     loop;          /**< Restart at the end instead of holding  */
+
+    /* Piecewise linear */
+    const waveform_point_t *points;
+    uint32_t n_points;
+    uint32_t seg;           /**< Current segment (start point index)    */
+
+    /* Chirp */
+    float    offset;        /**< Centre duty (%)                        */
+    float    amplitude;     /**< Peak deviation (%)                     */
+    float    phase;         /**< Radians, wrapped to [0, 2π)            */
+    float    dphase;        /**< Phase step of the current sample       */
+    float    ddphase;       /**< Change of the step per sample          */
+    float    dphase0;       /**< Step at the start of the sweep         */
+    uint32_t length;        /**< Samples per sweep                      */
+
+    uint32_t pos;           /**< Sample index in segment / sweep        */
+    uint32_t rep;           /**< Update events left on the last sample  */
+    uint32_t value;         /**< Compare value of the last sample       */
+    volatile uint32_t refills;  /**< Halves rendered since prime        */
+    volatile bool done;     /**< A one-shot profile has ended           */
+} waveform_t;
+
+/* --------------------------------------------------------------------
+ * API
+ * ------------------------------------------------------------------*/
+
+/**
+ * @brief  Set the output scale and sample rate.
+ * @param  counts  Compare value for 100 % duty (Period + 1)
+ * @param  hold    Timer update events per sample, ≥ 1
+ *
+ * Until a profile is loaded the output is 0 %.
+ */
+void waveform_init(waveform_t *wf, uint32_t counts, uint32_t hold);
+
+/**
+ * @brief  Play a piecewise-linear profile.
+ * @param  points  Breakpoints, kept by reference (static storage)
+ * @param  n       Number of points, ≥ 1
+ * @param  loop    true: restart after the last segment; false: hold
+ *                 the last point and set `done`
+ *
+ * Starts from the next rendered sample.  Load while the DMA interrupt
+ * is masked or the stream stopped.  A looping profile should end on its
+ * first point, or the wrap is a step.  A single point is a constant.
+ */
+void waveform_load_pwl(waveform_t *wf, const waveform_point_t *points,
+                       uint32_t n, bool loop);
+
+/**
+ * @brief  Play a sine whose frequency moves linearly from f0 to f1.
+ * @param  offset, amplitude  Duty = offset + amplitude·sin (%)
+ * @param  fs      Sample rate (PWM rate / hold, Hz)
+ * @param  length  Samples per sweep
+ * @param  loop    Repeat the sweep; otherwise hold `offset` at the end
+ *
+ * Same rules as waveform_load_pwl() for when it takes effect.
+ */
+void waveform_load_chirp(waveform_t *wf, float offset, float amplitude,
+                         float f0, float f1, float fs, uint32_t length, bool loop);
+
+/**
+ * @brief  Render both halves of the buffer (before the DMA starts).
+ */
+void waveform_prime(waveform_t *wf);
+
+/**
+ * @brief  Render the next samples into one half (DMA interrupt).
+ * @param  half  0 from the half-transfer callback, 1 from transfer complete
+ */
+RAMFUNC void waveform_refill(waveform_t *wf, uint32_t half);
+
+/**
+ * @brief  Duty of a compare value, for reporting what is playing (%).
+ */
+float waveform_duty(const waveform_t *wf, uint32_t compare);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* WAVEFORM_H */
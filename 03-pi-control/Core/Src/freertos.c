@@ -24,6 +24,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "stm32f4xx_hal.h"
 
 /* USER CODE END Includes */
 
@@ -44,6 +45,8 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN Variables */
+static volatile uint32_t sleep_ticks;        /* Ticks slept in tickless idle  */
+static uint32_t idle_window_start;           /* Tick count at last ratio read */
 
 /* USER CODE END Variables */
 
@@ -52,6 +55,27 @@
 
 /* USER CODE END FunctionPrototypes */
 
+/* Pre/Post sleep processing prototypes */
+void PreSleepProcessing(uint32_t ulExpectedIdleTime);
+void PostSleepProcessing(uint32_t ulExpectedIdleTime);
+
+/* Hook prototypes */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName);
+
+/* USER CODE BEGIN 4 */
+/**
+  * @brief  A task ran past its stack (checked at every context switch).
+  *         Stop here, as configASSERT does: pcTaskName names the task.
+  */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
+{
+  (void)xTask;
+  (void)pcTaskName;
+  taskDISABLE_INTERRUPTS();
+  for( ;; );
+}
+/* USER CODE END 4 */
+
 /* GetIdleTaskMemory prototype (linked to static allocation support) */
 void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize );
 
@@ -68,7 +92,65 @@ void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackTy
 }
 /* USER CODE END GET_IDLE_TASK_MEMORY */
 
+/* USER CODE BEGIN PREPOSTSLEEP */
+void PreSleepProcessing(uint32_t ulExpectedIdleTime)
+{
+  /* The TIM6 HAL time base would otherwise wake the core every 1 ms.
+     HAL_GetTick() follows the kernel tick while the scheduler runs, so no
+     time is lost while it is stopped. */
+  (void)ulExpectedIdleTime;
+  HAL_SuspendTick();
+}
+
+void PostSleepProcessing(uint32_t ulExpectedIdleTime)
+{
+  (void)ulExpectedIdleTime;
+  HAL_ResumeTick();
+}
+/* USER CODE END PREPOSTSLEEP */
+
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
 
+/**
+  * @brief  Called from vTaskStepTick() with the number of ticks slept.
+  */
+void App_NoteSleepTicks(uint32_t ulTicks)
+{
+  sleep_ticks += ulTicks;
+}
+
+/**
+  * @brief  Fraction of time spent in tickless sleep since the previous call.
+  * @retval Idle ratio in 1/1000 (0 = never slept, 1000 = always asleep)
+  */
+uint32_t App_GetIdlePermille(void)
+{
+  taskENTER_CRITICAL();
+  uint32_t now   = xTaskGetTickCount();
+  uint32_t slept = sleep_ticks;
+  uint32_t span  = now - idle_window_start;
+  sleep_ticks       = 0u;
+  idle_window_start = now;
+  taskEXIT_CRITICAL();
+
+  if (span == 0u) return 0u;
+  uint32_t permille = (uint32_t)(((uint64_t)slept * 1000u) / span);
+  return (permille > 1000u) ? 1000u : permille;
+}
+
+/**
+  * @brief  HAL time base that survives tickless idle.
+  *         Once the scheduler runs, the kernel tick (which is stepped forward
+  *         after each sleep) is the authoritative millisecond counter.
+  */
+uint32_t HAL_GetTick(void)
+{
+  if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)
+  {
+    return uwTick;
+  }
+  return (__get_IPSR() != 0u) ? xTaskGetTickCountFromISR() : xTaskGetTickCount();
+}
+
 /* USER CODE END Application */
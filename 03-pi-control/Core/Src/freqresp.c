@@ -0,0 +1,241 @@
+/**
+ * @file    freqresp.c
+ * @brief   Implementation of the chirp/PRBS frequency-response measurement.
+ *
+ * Real FFT of N samples x[n] through one complex FFT of M = N/2 points:
+ *     z[n] = x[2n] + j·x[2n+1],   Z = FFT_M(z)
+ *     X[k] = E[k] + W^k·O[k],  E = (Z[k] + Z*[M-k]) / 2,  O = (Z[k] - Z*[M-k]) / 2j
+ * with W = e^(-2πj/N), and X[M-k] = conj(E[k] - W^k·O[k]) from the same
+ * pair, so the split runs in place.  All twiddles are W^k for k < N/2;
+ * the M-point FFT uses every second one.
+ */
+
+#include "freqresp.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FR_PI  3.14159265358979f
+
+/* ----------------------------- Helpers ----------------------------- */
+#if !FREQRESP_USE_CMSIS_RFFT
+/* In-place radix-2 complex FFT of m interleaved points; tw = W_N^k with
+ * n = 2m, so W_len^j = tw[j · n/len]. */
+static void cfft(const float *tw, float *buf, uint32_t m)
+{
+    /* Bit-reversal permutation */
+    for (uint32_t i = 1, j = 0; i < m; i++)
+    {
+        uint32_t bit = m >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if (i < j)
+        {
+            float tr = buf[2u * i], ti = buf[2u * i + 1u];
+            buf[2u * i]      = buf[2u * j];
+            buf[2u * i + 1u] = buf[2u * j + 1u];
+            buf[2u * j]      = tr;
+            buf[2u * j + 1u] = ti;
+        }
+    }
+
+    for (uint32_t len = 2u; len <= m; len <<= 1)
+    {
+        uint32_t half = len >> 1;
+        uint32_t step = (2u * m) / len;
+        for (uint32_t i = 0; i < m; i += len)
+        {
+            for (uint32_t j = 0; j < half; j++)
+            {
+                float wr = tw[2u * j * step], wi = tw[2u * j * step + 1u];
+                float *a = &buf[2u * (i + j)];
+                float *b = &buf[2u * (i + j + half)];
+                float br = b[0] * wr - b[1] * wi;
+                float bi = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - br;
+                b[1] = a[1] - bi;
+                a[0] += br;
+                a[1] += bi;
+            }
+        }
+    }
+}
+#endif
+
+static uint32_t prbs9(uint32_t *state)
+{
+    uint32_t s = *state;
+    uint32_t bit = ((s >> 8) ^ (s >> 4)) & 1u;   /* x^9 + x^5 + 1 */
+    *state = ((s << 1) | bit) & 0x1FFu;
+    return bit;
+}
+
+/* --------------------------- Public API ---------------------------- */
+void freqresp_init(freqresp_t *fr, freqresp_signal_t signal, float fs,
+                   float offset, float amplitude, float f0, float f1)
+{
+    fr->signal    = signal;
+    fr->fs        = fs;
+    fr->offset    = offset;
+    fr->amplitude = amplitude;
+    fr->f0        = f0;
+    fr->f1        = f1;
+    fr->lfsr      = 0x1FFu;
+    fr->tick      = 0u;
+    fr->count     = 0u;
+    fr->segments  = 0u;
+
+    for (uint32_t n = 0; n < FREQRESP_NFFT; n++)
+    {
+        fr->window[n] = 0.5f - 0.5f * cosf(2.0f * FR_PI * (float)n / (float)FREQRESP_NFFT);
+    }
+
+#if FREQRESP_USE_CMSIS_RFFT
+    arm_rfft_fast_init_f32(&fr->rfft, FREQRESP_NFFT);
+#else
+    for (uint32_t k = 0; k < FREQRESP_NFFT / 2u; k++)
+    {
+        float a = -2.0f * FR_PI * (float)k / (float)FREQRESP_NFFT;
+        fr->twiddle[2u * k]      = cosf(a);
+        fr->twiddle[2u * k + 1u] = sinf(a);
+    }
+#endif
+}
+
+float freqresp_excitation(freqresp_t *fr)
+{
+    if (fr->count >= FREQRESP_RECORD_LEN) return fr->offset;
+
+    float s;
+    if (fr->signal == FREQRESP_PRBS)
+    {
+        s = prbs9(&fr->lfsr) ? 1.0f : -1.0f;
+    }
+    else
+    {
+        /* Exponential sweep: instantaneous frequency f0·e^(βt) */
+        float T    = (float)(FREQRESP_RECORD_LEN + FREQRESP_SETTLE) / fr->fs;
+        float beta = logf(fr->f1 / fr->f0) / T;
+        float t    = (float)fr->tick / fr->fs;
+        s = sinf(2.0f * FR_PI * fr->f0 * (expf(beta * t) - 1.0f) / beta);
+    }
+    fr->tick++;
+    return fr->offset + fr->amplitude * s;
+}
+
+bool freqresp_record(freqresp_t *fr, float u, float y)
+{
+    if (fr->count >= FREQRESP_RECORD_LEN) return true;
+    if (fr->tick <= FREQRESP_SETTLE) return false;      /* transient of the onset */
+
+    fr->u[fr->count] = u;
+    fr->y[fr->count] = y;
+    fr->count++;
+    return fr->count >= FREQRESP_RECORD_LEN;
+}
+
+void freqresp_rfft(freqresp_t *fr, float *buf)
+{
+#if FREQRESP_USE_CMSIS_RFFT
+    arm_rfft_fast_f32(&fr->rfft, buf, fr->scratch, 0u);
+    memcpy(buf, fr->scratch, sizeof(fr->scratch));
+#else
+    const uint32_t m = FREQRESP_NFFT / 2u;
+    const float *tw  = fr->twiddle;
+
+    cfft(tw, buf, m);
+
+    float z0r = buf[0], z0i = buf[1];
+    buf[0] = z0r + z0i;                 /* X[0]   */
+    buf[1] = z0r - z0i;                 /* X[N/2] */
+
+    for (uint32_t k = 1; k <= m / 2u; k++)
+    {
+        float *a = &buf[2u * k];
+        float *b = &buf[2u * (m - k)];
+        float er = 0.5f * (a[0] + b[0]), ei = 0.5f * (a[1] - b[1]);
+        float xr = 0.5f * (a[1] + b[1]), xi = 0.5f * (b[0] - a[0]);
+        float wr = tw[2u * k], wi = tw[2u * k + 1u];
+        float tr = wr * xr - wi * xi;
+        float ti = wr * xi + wi * xr;
+        a[0] = er + tr;
+        a[1] = ei + ti;
+        b[0] = er - tr;
+        b[1] = ti - ei;
+    }
+#endif
+}
+
+void freqresp_compute(freqresp_t *fr)
+{
+    const uint32_t hop = FREQRESP_NFFT / 2u;
+
+    memset(fr->Suu, 0, sizeof(fr->Suu));
+    memset(fr->Syy, 0, sizeof(fr->Syy));
+    memset(fr->Syu_re, 0, sizeof(fr->Syu_re));
+    memset(fr->Syu_im, 0, sizeof(fr->Syu_im));
+    fr->segments = 0u;
+
+    for (uint32_t start = 0; start + FREQRESP_NFFT <= fr->count; start += hop)
+    {
+        /* Remove the segment mean (operating point, ambient) and window */
+        float mu = 0.0f, my = 0.0f;
+        for (uint32_t n = 0; n < FREQRESP_NFFT; n++)
+        {
+            mu += fr->u[start + n];
+            my += fr->y[start + n];
+        }
+        mu /= (float)FREQRESP_NFFT;
+        my /= (float)FREQRESP_NFFT;
+        for (uint32_t n = 0; n < FREQRESP_NFFT; n++)
+        {
+            fr->bu[n] = (fr->u[start + n] - mu) * fr->window[n];
+            fr->by[n] = (fr->y[start + n] - my) * fr->window[n];
+        }
+
+        freqresp_rfft(fr, fr->bu);
+        freqresp_rfft(fr, fr->by);
+
+        /* DC and Nyquist are packed as real values in slots 0 and 1 */
+        fr->Suu[0]      += fr->bu[0] * fr->bu[0];
+        fr->Syy[0]      += fr->by[0] * fr->by[0];
+        fr->Syu_re[0]   += fr->by[0] * fr->bu[0];
+        fr->Suu[hop]    += fr->bu[1] * fr->bu[1];
+        fr->Syy[hop]    += fr->by[1] * fr->by[1];
+        fr->Syu_re[hop] += fr->by[1] * fr->bu[1];
+
+        for (uint32_t k = 1; k < hop; k++)
+        {
+            float ur = fr->bu[2u * k], ui = fr->bu[2u * k + 1u];
+            float yr = fr->by[2u * k], yi = fr->by[2u * k + 1u];
+            fr->Suu[k]    += ur * ur + ui * ui;
+            fr->Syy[k]    += yr * yr + yi * yi;
+            fr->Syu_re[k] += yr * ur + yi * ui;     /* Y · conj(U) */
+            fr->Syu_im[k] += yi * ur - yr * ui;
+        }
+        fr->segments++;
+    }
+}
+
+void freqresp_point(const freqresp_t *fr, uint32_t k, freqresp_point_t *p)
+{
+    float re = fr->Syu_re[k], im = fr->Syu_im[k];
+    float cross2 = re * re + im * im;
+    float suu = fr->Suu[k], syy = fr->Syy[k];
+
+    p->freq_hz   = (float)k * fr->fs / (float)FREQRESP_NFFT;
+    p->mag_db    = (suu > 0.0f && cross2 > 0.0f)
+                 ? 10.0f * log10f(cross2) - 20.0f * log10f(suu) : -INFINITY;
+    p->phase_deg = atan2f(im, re) * (180.0f / FR_PI);
+    p->coherence = (suu > 0.0f && syy > 0.0f) ? cross2 / (suu * syy) : 0.0f;
+}
+
+size_t freqresp_format(const freqresp_t *fr, uint32_t k, char *buf, size_t len)
+{
+    freqresp_point_t p;
+    freqresp_point(fr, k, &p);
+    int n = snprintf(buf, len, "bode,%.3f,%.2f,%.1f,%.3f",
+                     (double)p.freq_hz, (double)p.mag_db,
+                     (double)p.phase_deg, (double)p.coherence);
+    return (n < 0) ? 0u : (size_t)n;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file    gainsched.c
+ * @brief   Implementation of the uniform-grid gain schedule.
+ */
+
+#include "gainsched.h"
+#include <math.h>
+
+/* --------------------------- Public API ---------------------------- */
+void gainsched_init(gainsched_t *sched, float x0, float dx, uint32_t n,
+                    const float (*gains)[3])
+{
+    sched->x0     = x0;
+    sched->inv_dx = 1.0f / dx;
+    sched->n      = n;
+    sched->gains  = gains;
+    sched->last_x = NAN;            /* first apply always updates */
+}
+
+RAMFUNC void gainsched_lookup(const gainsched_t *sched, float x, float out[3])
+{
+    /* Position in rows, clamped to the table; the last segment also
+     * serves t == n-1 so that row i+1 always exists. */
+    float t    = (x - sched->x0) * sched->inv_dx;
+    float tmax = (float)(sched->n - 1u);
+    t = (t < 0.0f) ? 0.0f : t;
+    t = (t > tmax) ? tmax : t;
+
+    uint32_t i = (uint32_t)t;
+    i = (i > sched->n - 2u) ? sched->n - 2u : i;
+    float f = t - (float)i;
+
+    const float *a = sched->gains[i];
+    const float *b = sched->gains[i + 1u];
+    out[0] = a[0] + f * (b[0] - a[0]);
+    out[1] = a[1] + f * (b[1] - a[1]);
+    out[2] = a[2] + f * (b[2] - a[2]);
+}
+
+bool gainsched_apply(gainsched_t *sched, pid_t *pid, float x)
+{
+    if (x == sched->last_x) return false;
+    sched->last_x = x;
+
+    float g[3];
+    gainsched_lookup(sched, x, g);
+    pid_set_gains(pid, g[0], g[1], g[2]);
+    return true;
+}
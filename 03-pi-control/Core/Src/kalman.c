@@ -0,0 +1,211 @@
+/**
+ * @file    kalman.c
+ * @brief   Implementation of the two-state Kalman filter.
+ *
+ * Time-varying update (u = duty of the last tick, z = new reading):
+ *     x = A·x + B·u + c               P = A·P·Aᵀ + Q
+ *     K = P·Cᵀ / (C·P·Cᵀ + R)          x += K·(z - C·x)      P -= K·(P·Cᵀ)ᵀ
+ * P·Cᵀ lives in a 2×1 buffer that is also viewed as 1×2, so every product
+ * is an arm_mat_mult_f32() call.  Once the gain is steady the covariance
+ * no longer depends on the data and only the state equations remain.
+ */
+
+#include "kalman.h"
+#include <math.h>
+#include <string.h>
+
+#define KALMAN_TAYLOR_TERMS  16u      /* e^(A·Ts) series; |A·Ts| < 1 for this plant */
+
+/* ----------------------------- Helpers ----------------------------- */
+static void mat2_mul(const float *a, const float *b, float *out)
+{
+    float r[4];
+    r[0] = a[0] * b[0] + a[1] * b[2];
+    r[1] = a[0] * b[1] + a[1] * b[3];
+    r[2] = a[2] * b[0] + a[3] * b[2];
+    r[3] = a[2] * b[1] + a[3] * b[3];
+    memcpy(out, r, sizeof(r));
+}
+
+#if KALMAN_FIXED_POINT
+static int32_t q16(float v)
+{
+    return (int32_t)lrintf(v * (float)KALMAN_Q16_ONE);
+}
+
+static int32_t q16_mul(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b + (KALMAN_Q16_ONE / 2)) >> 16);
+}
+#endif
+
+/* --------------------------- Public API ---------------------------- */
+void kalman_init(kalman_t *kf, const float A[4], const float B[2], const float c[2],
+                 const float Q[4], float R)
+{
+    memcpy(kf->A, A, sizeof(kf->A));
+    memcpy(kf->B, B, sizeof(kf->B));
+    memcpy(kf->c, c, sizeof(kf->c));
+    memcpy(kf->Q, Q, sizeof(kf->Q));
+    kf->R    = R;
+    kf->C[0] = 1.0f;
+    kf->C[1] = 0.0f;
+
+    arm_mat_init_f32(&kf->mA,    2u, 2u, kf->A);
+    arm_mat_init_f32(&kf->mAt,   2u, 2u, kf->At);
+    arm_mat_init_f32(&kf->mB,    2u, 1u, kf->B);
+    arm_mat_init_f32(&kf->mc,    2u, 1u, kf->c);
+    arm_mat_init_f32(&kf->mC,    1u, 2u, kf->C);
+    arm_mat_init_f32(&kf->mCt,   2u, 1u, kf->C);
+    arm_mat_init_f32(&kf->mQ,    2u, 2u, kf->Q);
+    arm_mat_init_f32(&kf->mX,    2u, 1u, kf->x);
+    arm_mat_init_f32(&kf->mP,    2u, 2u, kf->P);
+    arm_mat_init_f32(&kf->mK,    2u, 1u, kf->K);
+    arm_mat_init_f32(&kf->mT2a,  2u, 1u, kf->t2a);
+    arm_mat_init_f32(&kf->mT2aT, 1u, 2u, kf->t2a);
+    arm_mat_init_f32(&kf->mT2b,  2u, 1u, kf->t2b);
+    arm_mat_init_f32(&kf->mT4a,  2u, 2u, kf->t4a);
+    arm_mat_init_f32(&kf->mT4b,  2u, 2u, kf->t4b);
+    arm_mat_trans_f32(&kf->mA, &kf->mAt);
+
+    kf->K[0]   = 0.0f;
+    kf->K[1]   = 0.0f;
+    kf->steady = false;
+    kalman_reset(kf, 0.0f);
+}
+
+void kalman_init_led(kalman_t *kf, float ts, float tau1, float tau2, float gain,
+                     float ambient, float q_rate, float r)
+{
+    /* y'' + (1/τ1 + 1/τ2)·y' + y/(τ1·τ2) = (gain·u + ambient)/(τ1·τ2) */
+    float w  = 1.0f / (tau1 * tau2);
+    float Ac[4] = { 0.0f, 1.0f, -w, -(tau1 + tau2) * w };
+
+    /* Zero-order hold: A = Σ (Ac·Ts)^k / k!,  Γ = Σ Ac^k·Ts^(k+1) / (k+1)! */
+    float A[4]     = { 1.0f, 0.0f, 0.0f, 1.0f };
+    float gamma[4] = { ts, 0.0f, 0.0f, ts };
+    float term[4]  = { 1.0f, 0.0f, 0.0f, 1.0f };
+    for (uint32_t k = 1; k <= KALMAN_TAYLOR_TERMS; k++)
+    {
+        mat2_mul(term, Ac, term);
+        for (uint32_t i = 0; i < 4u; i++)
+        {
+            term[i] *= ts / (float)k;             /* (Ac·Ts)^k / k!        */
+            A[i]     += term[i];
+            gamma[i] += term[i] * ts / (float)(k + 1u);
+        }
+    }
+
+    /* Inputs enter the rate equation only: Γ·[0; w] = w·(second column of Γ) */
+    float B[2] = { gamma[1] * gain * w,    gamma[3] * gain * w };
+    float c[2] = { gamma[1] * ambient * w, gamma[3] * ambient * w };
+
+    /* Continuous white noise on the rate, discretised */
+    float Q[4] = { q_rate * ts * ts * ts / 3.0f, q_rate * ts * ts / 2.0f,
+                   q_rate * ts * ts / 2.0f,      q_rate * ts };
+
+    kalman_init(kf, A, B, c, Q, r);
+}
+
+void kalman_reset(kalman_t *kf, float level)
+{
+    kf->x[0] = level;
+    kf->x[1] = 0.0f;
+    kf->P[0] = kf->R;                 /* one sample's worth of certainty  */
+    kf->P[1] = 0.0f;
+    kf->P[2] = 0.0f;
+    kf->P[3] = 1.0e4f;                /* rate unknown: ±100 %/s           */
+#if KALMAN_FIXED_POINT
+    kf->xq[0] = q16(level);
+    kf->xq[1] = 0;
+#endif
+}
+
+uint32_t kalman_make_steady(kalman_t *kf, uint32_t max_iter)
+{
+    float x[2];
+    memcpy(x, kf->x, sizeof(x));      /* the recursion must not move the state */
+    kf->steady = false;
+
+    uint32_t it;
+    for (it = 0; it < max_iter; it++)
+    {
+        float k0 = kf->K[0], k1 = kf->K[1];
+        kalman_update(kf, 0.0f, kf->x[0]);
+        if (it > 0u && fabsf(kf->K[0] - k0) < 1e-7f && fabsf(kf->K[1] - k1) < 1e-7f) break;
+    }
+
+    memcpy(kf->x, x, sizeof(x));
+    kf->steady = true;
+#if KALMAN_FIXED_POINT
+    for (uint32_t i = 0; i < 4u; i++) kf->Aq[i] = q16(kf->A[i]);
+    for (uint32_t i = 0; i < 2u; i++)
+    {
+        kf->Bq[i] = q16(kf->B[i]);
+        kf->cq[i] = q16(kf->c[i]);
+        kf->Kq[i] = q16(kf->K[i]);
+        kf->xq[i] = q16(kf->x[i]);
+    }
+#endif
+    return it;
+}
+
+float kalman_update(kalman_t *kf, float u, float z)
+{
+    if (kf->steady)
+    {
+        /* Fixed gain: the covariance recursion has converged */
+        float x0 = kf->A[0] * kf->x[0] + kf->A[1] * kf->x[1] + kf->B[0] * u + kf->c[0];
+        float x1 = kf->A[2] * kf->x[0] + kf->A[3] * kf->x[1] + kf->B[1] * u + kf->c[1];
+        float e  = z - x0;
+        kf->x[0] = x0 + kf->K[0] * e;
+        kf->x[1] = x1 + kf->K[1] * e;
+        return kf->x[0];
+    }
+
+    /* Predict: x = A·x + B·u + c */
+    arm_mat_mult_f32(&kf->mA, &kf->mX, &kf->mT2a);
+    arm_mat_scale_f32(&kf->mB, u, &kf->mT2b);
+    arm_mat_add_f32(&kf->mT2a, &kf->mT2b, &kf->mX);
+    arm_mat_add_f32(&kf->mX, &kf->mc, &kf->mX);
+
+    /* P = A·P·Aᵀ + Q */
+    arm_mat_mult_f32(&kf->mA, &kf->mP, &kf->mT4a);
+    arm_mat_mult_f32(&kf->mT4a, &kf->mAt, &kf->mT4b);
+    arm_mat_add_f32(&kf->mT4b, &kf->mQ, &kf->mP);
+
+    /* Gain: K = P·Cᵀ / (C·P·Cᵀ + R) */
+    float s;
+    arm_matrix_instance_f32 mS;
+    arm_mat_init_f32(&mS, 1u, 1u, &s);
+    arm_mat_mult_f32(&kf->mP, &kf->mCt, &kf->mT2a);    /* P·Cᵀ */
+    arm_mat_mult_f32(&kf->mC, &kf->mT2a, &mS);
+    arm_mat_scale_f32(&kf->mT2a, 1.0f / (s + kf->R), &kf->mK);
+
+    /* Correct: x += K·(z - C·x) */
+    float cx;
+    arm_mat_init_f32(&mS, 1u, 1u, &cx);
+    arm_mat_mult_f32(&kf->mC, &kf->mX, &mS);
+    arm_mat_scale_f32(&kf->mK, z - cx, &kf->mT2b);
+    arm_mat_add_f32(&kf->mX, &kf->mT2b, &kf->mX);
+
+    /* P -= K·(P·Cᵀ)ᵀ */
+    arm_mat_mult_f32(&kf->mK, &kf->mT2aT, &kf->mT4a);
+    arm_mat_sub_f32(&kf->mP, &kf->mT4a, &kf->mP);
+
+    return kf->x[0];
+}
+
+#if KALMAN_FIXED_POINT
+int32_t kalman_update_q16(kalman_t *kf, int32_t u, int32_t z)
+{
+    int32_t x0 = q16_mul(kf->Aq[0], kf->xq[0]) + q16_mul(kf->Aq[1], kf->xq[1])
+               + q16_mul(kf->Bq[0], u) + kf->cq[0];
+    int32_t x1 = q16_mul(kf->Aq[2], kf->xq[0]) + q16_mul(kf->Aq[3], kf->xq[1])
+               + q16_mul(kf->Bq[1], u) + kf->cq[1];
+    int32_t e  = z - x0;
+    kf->xq[0] = x0 + q16_mul(kf->Kq[0], e);
+    kf->xq[1] = x1 + q16_mul(kf->Kq[1], e);
+    return kf->xq[0];
+}
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file    looptime.c
+ * @brief   Implementation of control-loop timing instrumentation.
+ */
+
+#include "looptime.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ----------------------------- Helpers ----------------------------- */
+RAMFUNC_INLINE uint32_t lt_max(uint32_t a, uint32_t b)
+{
+    return (a > b) ? a : b;
+}
+
+/* --------------------------- Public API ---------------------------- */
+void looptime_init(looptime_t *lt, uint32_t period, uint32_t deadline)
+{
+    memset(lt, 0, sizeof(*lt));
+    lt->period     = period;
+    lt->deadline   = deadline;
+    lt->period_min = UINT32_MAX;
+}
+
+uint32_t looptime_bucket(uint32_t jitter)
+{
+    if (jitter == 0u) return 0u;
+    uint32_t b = 32u - (uint32_t)__builtin_clz(jitter);
+    return (b < LOOPTIME_HIST_BUCKETS) ? b : (LOOPTIME_HIST_BUCKETS - 1u);
+}
+
+RAMFUNC void looptime_begin(looptime_t *lt, uint32_t now)
+{
+    if (lt->started)
+    {
+        /* Unsigned subtraction handles CYCCNT wrap (~23 s at 180 MHz) */
+        uint32_t period = now - lt->t_begin;
+        uint32_t jitter = (period > lt->period) ? (period - lt->period)
+                                                : (lt->period - period);
+
+        lt->hist[looptime_bucket(jitter)]++;
+        if (period < lt->period_min) lt->period_min = period;
+        if (period > lt->period_max) lt->period_max = period;
+        if (period > lt->period + lt->deadline) lt->late_periods++;
+    }
+
+    lt->started = 1u;
+    lt->t_begin = now;
+    lt->t_last  = now;
+}
+
+RAMFUNC void looptime_mark(looptime_t *lt, looptime_phase_t phase, uint32_t now)
+{
+    uint32_t dt = now - lt->t_last;
+    lt->phase_max[phase] = lt_max(lt->phase_max[phase], dt);
+    lt->t_last = now;
+
+    if (phase == LOOPTIME_ACTUATE)
+    {
+        uint32_t exec = now - lt->t_begin;
+        lt->exec_max = lt_max(lt->exec_max, exec);
+        if (exec > lt->deadline) lt->overruns++;
+        lt->iterations++;
+    }
+}
+
+size_t looptime_format(const looptime_t *lt, char *buf, size_t len)
+{
+    /* Work on a copy so an update racing with the report (e.g. report from
+     * a lower-priority context) yields a consistent-enough snapshot. */
+    looptime_t s;
+    memcpy(&s, lt, sizeof(s));
+
+    int n = snprintf(buf, len,
+                     "looptime,n=%lu,overrun=%lu,late=%lu,pmin=%lu,pmax=%lu,"
+                     "exec=%lu,sense=%lu,compute=%lu,actuate=%lu\n",
+                     (unsigned long)s.iterations,
+                     (unsigned long)s.overruns,
+                     (unsigned long)s.late_periods,
+                     (unsigned long)(s.period_min == UINT32_MAX ? 0u : s.period_min),
+                     (unsigned long)s.period_max,
+                     (unsigned long)s.exec_max,
+                     (unsigned long)s.phase_max[LOOPTIME_SENSE],
+                     (unsigned long)s.phase_max[LOOPTIME_COMPUTE],
+                     (unsigned long)s.phase_max[LOOPTIME_ACTUATE]);
+    if (n < 0 || (size_t)n >= len) return (n < 0) ? 0u : len - 1u;
+
+    /* Histogram, trimmed after the last populated bucket */
+    int last = -1;
+    for (int i = 0; i < LOOPTIME_HIST_BUCKETS; i++)
+    {
+        if (s.hist[i]) last = i;
+    }
+
+    size_t used = (size_t)n;
+    n = snprintf(buf + used, len - used, "loophist");
+    used += (n > 0) ? (size_t)n : 0u;
+    for (int i = 0; i <= last && used < len; i++)
+    {
+        n = snprintf(buf + used, len - used, ",%lu", (unsigned long)s.hist[i]);
+        if (n < 0) break;
+        used += (size_t)n;
+    }
+    if (used < len)
+    {
+        n = snprintf(buf + used, len - used, "\n");
+        if (n > 0) used += (size_t)n;
+    }
+    return (used < len) ? used : len - 1u;
+}
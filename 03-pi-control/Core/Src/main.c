@@ -32,7 +32,19 @@
 #include "uart_driver.h"
 #include "pwm.h"
 #include "photocell.h"
+#include "looptime.h"
+#include "freqresp.h"
+#include "waveform.h"
+#include "pid.h"
+#include "parambox.h"
+#include "gainsched.h"
+#include "rls.h"
+#include "kalman.h"
+#include "mpc.h"
+#include "slew.h"
+#include "timebase.h"
 #include <stdint.h>
+#include <math.h>
 
 /* USER CODE END Includes */
 
@@ -43,7 +55,84 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+#define PID_TASK_PERIOD_MS    100u    /* osDelay() between iterations   */
+#define PID_TASK_DEADLINE_US  5000u   /* Execution budget per iteration */
+#define LOOPTIME_REPORT_EVERY 50u     /* Iterations between reports     */
+
+#ifndef FREQRESP_MODE
+#define FREQRESP_MODE         0       /* 1: measure the frequency response first */
+#endif
+#define FREQRESP_PERIOD_MS    5u      /* Measurement tick (200 Hz)      */
+
+#ifndef CLOSED_LOOP_MODE
+#define CLOSED_LOOP_MODE      0       /* 1: PI loop on the photocell instead of the sweep */
+#endif
+#define CONTROL_PERIOD_MS     10u     /* Closed-loop tick (100 Hz, the Ts of the tunings) */
+#define CONTROL_REPORT_EVERY  10u     /* Ticks between "loop,sp,y,u,kp" records */
+#define CONTROL_KP            0.63f   /* Nominal PI tuning at 50 % (gain_schedule_table.h) */
+#define CONTROL_KI            15.8f
+#define SETPOINT_LOW          10.0f   /* Staircase walked by the setpoint task (%) */
+#define SETPOINT_HIGH         85.0f
+#define SETPOINT_STEP         5.0f
+#define SETPOINT_HOLD_MS      2000u
+
+#ifndef GAINSCHED_MODE
+#define GAINSCHED_MODE        0       /* 1: closed loop retuned over the setpoint */
+#endif
+#if GAINSCHED_MODE && !CLOSED_LOOP_MODE
+#error "GAINSCHED_MODE schedules the closed loop: set CLOSED_LOOP_MODE"
+#endif
+
+#ifndef RLS_MODE
+#define RLS_MODE              0       /* 1: fit the plant online, scale the PI gains by it */
+#endif
+#define RLS_K_NOMINAL         1.11f   /* Plant gain at 50 % the nominal tuning assumes */
+#define RLS_WARMUP            200u    /* Updates before the fit may retune */
+#define RLS_SCALE_MIN         0.25f   /* Bounds of the gain correction */
+#define RLS_SCALE_MAX         4.0f
+#if RLS_MODE && (!CLOSED_LOOP_MODE || GAINSCHED_MODE)
+#error "RLS_MODE adapts the closed loop's gains: set CLOSED_LOOP_MODE, clear GAINSCHED_MODE"
+#endif
+
+#ifndef KALMAN_MODE
+#define KALMAN_MODE           0       /* 1: the closed loop sees the Kalman-filtered reading */
+#endif
+#define KALMAN_STEADY_ITER    1000u   /* Riccati iterations for the fixed gain */
+#if KALMAN_MODE && !CLOSED_LOOP_MODE
+#error "KALMAN_MODE filters the closed loop's input: set CLOSED_LOOP_MODE"
+#endif
+
+#ifndef MPC_MODE
+#define MPC_MODE              0       /* 1: explicit MPC drives the duty instead of the PI */
+#endif
+#if MPC_MODE && (!KALMAN_MODE || GAINSCHED_MODE || RLS_MODE)
+#error "MPC_MODE plans from the Kalman state: set KALMAN_MODE, clear GAINSCHED_MODE and RLS_MODE"
+#endif
+
+#ifndef SLEW_MODE
+#define SLEW_MODE             0       /* 1: rate/jerk-limit the duty, the PI tracks what was applied */
+#endif
+#define SLEW_RATE             200.0f  /* Duty speed limit (%/s) */
+#define SLEW_JERK             4000.0f /* Limit on its change (%/s²) */
+/* #if cannot compare enums: paste the name PID_ANTIWINDUP holds instead */
+#define SLEW_AW_PID_AW_CONDITIONAL 1
+#define SLEW_AW_(aw)          SLEW_AW_##aw
+#define SLEW_AW(aw)           SLEW_AW_(aw)
+#if SLEW_MODE && !CLOSED_LOOP_MODE
+#error "SLEW_MODE limits the closed loop's duty: set CLOSED_LOOP_MODE"
+#endif
+#if SLEW_MODE && SLEW_AW(PID_ANTIWINDUP)
+#error "SLEW_MODE needs PID_AW_CLAMP or PID_AW_BACKCALC: a conditional integrator stays frozen behind the stage"
+#endif
+
+#ifndef WAVEFORM_SWEEP
+#define WAVEFORM_SWEEP        (!CLOSED_LOOP_MODE)  /* 1: DMA plays the sweep, 0: task steps it */
+#endif
+#if CLOSED_LOOP_MODE && WAVEFORM_SWEEP
+#error "WAVEFORM_SWEEP drives the duty open loop: disable it for CLOSED_LOOP_MODE"
+#endif
+/* One sample per 1 kHz PWM period: the same 20 s triangle as the task sweep */
+#define SWEEP_RAMP_SAMPLES    (100u * PID_TASK_PERIOD_MS)
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -62,6 +151,10 @@ DMA_HandleTypeDef hdma_usart2_tx;
 
 osThreadId pidTaskHandle;
 /* USER CODE BEGIN PV */
+DMA_HandleTypeDef hdma_tim2_up;
+#if CLOSED_LOOP_MODE
+osThreadId setpointTaskHandle;
+#endif
 
 /* USER CODE END PV */
 
@@ -83,6 +176,40 @@ void StartPIDTask(void const * argument);
 uart_drv_t shared_driver;
 PwmChannel_t led_dimmer_handle;
 photoCell_t photocell_handle;
+looptime_t loop_timing;
+#if FREQRESP_MODE
+static freqresp_t freq_response;      /* ~30 KB record and work area */
+#endif
+#if CLOSED_LOOP_MODE
+static pid_t        loop_ctrl;
+static pid_params_t loop_params;      /* Control task's copy, applied  */
+static uint32_t     loop_version;     /* Box version held by loop_params */
+static parambox_t   loop_box;         /* Setpoint task → control task  */
+static float        loop_u;           /* Duty applied over the current tick */
+#endif
+#if RLS_MODE
+static rls_t        loop_id;
+#endif
+#if KALMAN_MODE
+static kalman_t     loop_kf;
+#endif
+#if MPC_MODE
+#include "mpc_table.h"                /* Defines the table: this file only */
+static mpc_t        loop_mpc;
+#endif
+#if GAINSCHED_MODE
+#include "gain_schedule_table.h"      /* Defines the table: this file only */
+static gainsched_t  loop_sched;
+#endif
+#if SLEW_MODE
+static slew_t       loop_slew;
+#endif
+#if WAVEFORM_SWEEP
+static waveform_t led_waveform;
+static const waveform_point_t sweep_profile[] = {
+  { 0.0f, SWEEP_RAMP_SAMPLES }, { 100.0f, SWEEP_RAMP_SAMPLES }, { 0.0f, 0u }
+};
+#endif
 
 /* USER CODE END 0 */
 
@@ -142,7 +269,7 @@ int main(void)
 
   /* Create the thread(s) */
   /* definition and creation of pidTask */
-  osThreadDef(pidTask, StartPIDTask, osPriorityNormal, 0, 256);
+  osThreadDef(pidTask, StartPIDTask, osPriorityNormal, 0, 512);
   pidTaskHandle = osThreadCreate(osThread(pidTask), NULL);
 
   /* USER CODE BEGIN RTOS_THREADS */
@@ -412,6 +539,267 @@ static void MX_GPIO_Init(void)
 
 /* USER CODE BEGIN 4 */
 
+#if !CLOSED_LOOP_MODE
+static void sweep_report(float photocell_value)
+{
+  log_write(LOG_LEVEL_INFO, "Photocell Value: %f", photocell_value);
+
+  if (loop_timing.iterations % LOOPTIME_REPORT_EVERY == 0u)
+  {
+    static char buf[256];             /* pidTask only: off its stack */
+    looptime_format(&loop_timing, buf, sizeof(buf));
+    log_write(LOG_LEVEL_INFO, "%s", buf);
+    log_write(LOG_LEVEL_INFO, "idle,permille=%lu", (unsigned long)App_GetIdlePermille());
+  }
+}
+#endif
+
+#if WAVEFORM_SWEEP
+/* The DMA has played one half of the buffer: render its next samples */
+RAMFUNC_ISR static void waveform_half_cplt(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  waveform_refill(&led_waveform, 0u);
+}
+
+RAMFUNC_ISR static void waveform_cplt(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  waveform_refill(&led_waveform, 1u);
+}
+
+/* Hand CCR2 to the DMA: every TIM2 update event (1 kHz) copies the next
+ * compare value, so the sweep needs no task wake-ups at all */
+static void waveform_stream_start(void)
+{
+  waveform_init(&led_waveform, htim2.Init.Period + 1u, 1u);
+  waveform_load_pwl(&led_waveform, sweep_profile,
+                    sizeof(sweep_profile) / sizeof(sweep_profile[0]), true);
+  waveform_prime(&led_waveform);
+
+  HAL_DMA_RegisterCallback(&hdma_tim2_up, HAL_DMA_XFER_HALFCPLT_CB_ID, waveform_half_cplt);
+  HAL_DMA_RegisterCallback(&hdma_tim2_up, HAL_DMA_XFER_CPLT_CB_ID, waveform_cplt);
+  if (HAL_DMA_Start_IT(&hdma_tim2_up, (uint32_t)led_waveform.buf,
+                       (uint32_t)&htim2.Instance->CCR2, WAVEFORM_BUF_LEN) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  __HAL_TIM_ENABLE_DMA(&htim2, TIM_DMA_UPDATE);
+}
+
+/* One instrumented sample of the streamed sweep; the DMA actuates */
+static void stream_step(void)
+{
+  looptime_begin(&loop_timing, timebase_ticks());
+
+  float photocell_value = readSensor(&photocell_handle);
+  looptime_mark(&loop_timing, LOOPTIME_SENSE, timebase_ticks());
+  looptime_mark(&loop_timing, LOOPTIME_COMPUTE, timebase_ticks());
+  looptime_mark(&loop_timing, LOOPTIME_ACTUATE, timebase_ticks());
+
+  sweep_report(photocell_value);
+}
+#elif !CLOSED_LOOP_MODE
+/* One instrumented sense → actuate iteration of the sweep */
+static void sweep_step(float pwm_percent)
+{
+  looptime_begin(&loop_timing, timebase_ticks());
+
+  float photocell_value = readSensor(&photocell_handle);
+  looptime_mark(&loop_timing, LOOPTIME_SENSE, timebase_ticks());
+  looptime_mark(&loop_timing, LOOPTIME_COMPUTE, timebase_ticks());
+
+  Pwm_setDuty(&led_dimmer_handle, pwm_percent);
+  looptime_mark(&loop_timing, LOOPTIME_ACTUATE, timebase_ticks());
+
+  sweep_report(photocell_value);
+}
+#endif
+
+#if CLOSED_LOOP_MODE
+/* The command side of the loop, one priority below the control task:
+ * walks the setpoint up and down a staircase and hands each new
+ * parameter block over through loop_box.  The control task never waits
+ * for it; a block is applied whole at the start of a tick. */
+static void StartSetpointTask(void const * argument)
+{
+  (void)argument;
+  pid_params_t params = loop_params;  /* Writer's own copy */
+  float step = SETPOINT_STEP;
+  uint32_t wake = osKernelSysTick();
+
+  params.setpoint = SETPOINT_LOW;
+  for(;;)
+  {
+    parambox_publish(&loop_box, &params);
+    osDelayUntil(&wake, SETPOINT_HOLD_MS);
+
+    if (params.setpoint + step > SETPOINT_HIGH || params.setpoint + step < SETPOINT_LOW)
+    {
+      step = -step;
+    }
+    params.setpoint += step;
+  }
+}
+
+static void control_start(void)
+{
+  pid_init(&loop_ctrl, CONTROL_KP, CONTROL_KI, SETPOINT_LOW, 0.0f, 100.0f);
+  pid_set_sample_time(&loop_ctrl, CONTROL_PERIOD_MS / 1000.0f, PID_DISC_TUSTIN);
+  pid_get_params(&loop_ctrl, &loop_params);
+  parambox_init(&loop_box, &loop_params, sizeof(loop_params));
+#if RLS_MODE
+  rls_init(&loop_id, RLS_LAMBDA, RLS_P0);
+#endif
+#if KALMAN_MODE
+  /* The LED → CdS → ADC model the MPC table was also built on */
+  kalman_init_led(&loop_kf, CONTROL_PERIOD_MS / 1000.0f, 0.045f, 0.020f, 0.8f,
+                  5.0f, 5.0e5f, 3.0f);
+  kalman_make_steady(&loop_kf, KALMAN_STEADY_ITER);
+  kalman_reset(&loop_kf, readSensor(&photocell_handle));
+#endif
+#if MPC_MODE
+  mpc_init(&loop_mpc, mpc_table, MPC_TABLE_REGIONS, MPC_TABLE_U_MIN, MPC_TABLE_U_MAX);
+#endif
+#if GAINSCHED_MODE
+  gainsched_init(&loop_sched, GAIN_SCHEDULE_X0, GAIN_SCHEDULE_DX,
+                 GAIN_SCHEDULE_POINTS, gain_schedule_table);
+#endif
+#if SLEW_MODE
+  slew_init(&loop_slew, SLEW_RATE, SLEW_JERK, CONTROL_PERIOD_MS / 1000.0f, 0.0f);
+#endif
+
+  osThreadDef(setpointTask, StartSetpointTask, osPriorityBelowNormal, 0, 128);
+  setpointTaskHandle = osThreadCreate(osThread(setpointTask), NULL);
+}
+
+#if RLS_MODE
+/* Scale the published gains by nominal / fitted plant gain, which keeps
+ * the loop gain Kp·k where the nominal tuning put it */
+static void control_adapt(void)
+{
+  float k = rls_dc_gain(&loop_id);
+  if (loop_id.updates < RLS_WARMUP || !(k > 0.0f))
+  {
+    return;
+  }
+
+  float s = RLS_K_NOMINAL / k;
+  s = (s < RLS_SCALE_MIN) ? RLS_SCALE_MIN : (s > RLS_SCALE_MAX) ? RLS_SCALE_MAX : s;
+  pid_set_gains(&loop_ctrl, loop_params.Kp * s, loop_params.Ki * s, loop_params.Kd);
+}
+#endif
+
+/* One sense → compute → actuate tick; new parameters only at its start */
+static void control_step(void)
+{
+  looptime_begin(&loop_timing, timebase_ticks());
+  if (parambox_poll(&loop_box, &loop_params, &loop_version))
+  {
+    pid_apply_params(&loop_ctrl, &loop_params);
+#if GAINSCHED_MODE
+    loop_sched.last_x = NAN;          /* the block carried the nominal gains */
+#endif
+  }
+#if GAINSCHED_MODE
+  gainsched_apply(&loop_sched, &loop_ctrl, loop_ctrl.setpoint);
+#endif
+
+  float z = readSensor(&photocell_handle);
+#if KALMAN_MODE
+  float y = kalman_update(&loop_kf, loop_u, z);
+#else
+  float y = z;
+#endif
+  looptime_mark(&loop_timing, LOOPTIME_SENSE, timebase_ticks());
+
+#if RLS_MODE
+  rls_update(&loop_id, loop_u, z);            /* fit the plant, not the filter */
+  if (loop_timing.iterations % CONTROL_REPORT_EVERY == 0u)
+  {
+    control_adapt();
+  }
+#endif
+#if MPC_MODE
+  /* The limits are in the table; the PI only tracks, ready to take over */
+  float u = mpc_compute(&loop_mpc, loop_kf.x[0], loop_kf.x[1], loop_ctrl.setpoint);
+  pid_track(&loop_ctrl, y, u);
+#else
+  float u = PID_COMPUTE(&loop_ctrl, y);
+#endif
+#if SLEW_MODE
+  u = slew_step(&loop_slew, u);
+  pid_track_applied(&loop_ctrl, u);           /* the integral follows the limited duty */
+#endif
+  loop_u = u;
+  looptime_mark(&loop_timing, LOOPTIME_COMPUTE, timebase_ticks());
+
+  Pwm_setDuty(&led_dimmer_handle, u);
+  looptime_mark(&loop_timing, LOOPTIME_ACTUATE, timebase_ticks());
+
+  if (loop_timing.iterations % CONTROL_REPORT_EVERY == 0u)
+  {
+    log_write(LOG_LEVEL_INFO, "loop,%f,%f,%f,%f", loop_ctrl.setpoint, y, u, loop_ctrl.Kp);
+#if KALMAN_MODE
+    log_write(LOG_LEVEL_INFO, "kalman,%f,%f,%f", z, loop_kf.x[0], loop_kf.x[1]);
+#endif
+#if RLS_MODE
+    log_write(LOG_LEVEL_INFO, "rls,%f,%f,%f,%f,%f,%f,%f",
+              loop_id.theta[RLS_A1], loop_id.theta[RLS_A2], loop_id.theta[RLS_B1],
+              loop_id.theta[RLS_B2], loop_id.theta[RLS_C], rls_dc_gain(&loop_id), loop_id.err);
+#endif
+  }
+  if (loop_timing.iterations % (LOOPTIME_REPORT_EVERY * CONTROL_REPORT_EVERY) == 0u)
+  {
+    static char buf[256];             /* pidTask only: off its stack */
+    looptime_format(&loop_timing, buf, sizeof(buf));
+    log_write(LOG_LEVEL_INFO, "%s", buf);
+  }
+}
+#endif
+
+#if FREQRESP_MODE
+/* Chirp the duty around mid scale, then stream the Bode data:
+ *     bode_begin,<fs_hz>,<segments>
+ *     bode,<f_hz>,<mag_db>,<phase_deg>,<coherence>     (one per bin)
+ *     bode_end
+ * Each sample pairs the duty applied over a tick with the reading at its
+ * end.  No raw samples leave the board. */
+static void freqresp_run(uint32_t *wake)
+{
+  char buf[64];
+  const float fs = 1000.0f / (float)FREQRESP_PERIOD_MS;
+
+  freqresp_init(&freq_response, FREQRESP_CHIRP, fs, 50.0f, 20.0f, 0.2f, 0.3f * fs);
+  Pwm_setDuty(&led_dimmer_handle, 50.0f);
+  osDelay(500);                        /* settle at the operating point */
+  *wake = osKernelSysTick();
+
+  bool full = false;
+  while (!full)
+  {
+    float u = freqresp_excitation(&freq_response);
+    Pwm_setDuty(&led_dimmer_handle, u);
+    osDelayUntil(wake, FREQRESP_PERIOD_MS);
+    full = freqresp_record(&freq_response, u, readSensor(&photocell_handle));
+  }
+  Pwm_setDuty(&led_dimmer_handle, freqresp_excitation(&freq_response));
+
+  freqresp_compute(&freq_response);
+
+  log_write(LOG_LEVEL_INFO, "bode_begin,%lu,%lu", (unsigned long)fs,
+            (unsigned long)freq_response.segments);
+  for (uint32_t k = 1; k < FREQRESP_BINS; k++)
+  {
+    freqresp_format(&freq_response, k, buf, sizeof(buf));
+    log_write(LOG_LEVEL_INFO, "%s", buf);
+    osDelay(5);                        /* let the UART drain */
+  }
+  log_write(LOG_LEVEL_INFO, "bode_end");
+  *wake = osKernelSysTick();
+}
+#endif
+
 /* USER CODE END 4 */
 
 /* USER CODE BEGIN Header_StartPIDTask */
@@ -435,31 +823,51 @@ void StartPIDTask(void const * argument)
   Pwm_init(&led_dimmer_handle, &htim2, TIM_CHANNEL_2);
   Pwm_start(&led_dimmer_handle);
 
-  float photocell_value = 0.0f;
+  timebase_init();                    /* counts through tickless idle, unlike CYCCNT */
+  looptime_init(&loop_timing,
+                timebase_us_to_ticks((CLOSED_LOOP_MODE ? CONTROL_PERIOD_MS : PID_TASK_PERIOD_MS) * 1000u),
+                timebase_us_to_ticks(PID_TASK_DEADLINE_US));
+
+  /* Absolute wake times: the tickless idle sleeps right up to the next
+     sample instead of drifting by the execution time of each step. */
+  uint32_t wake = osKernelSysTick();
+
+#if FREQRESP_MODE
+  freqresp_run(&wake);
+#endif
+
+#if CLOSED_LOOP_MODE
+  control_start();
+
+  for(;;)
+  {
+    control_step();
+    osDelayUntil(&wake, CONTROL_PERIOD_MS);
+  }
+#elif WAVEFORM_SWEEP
+  waveform_stream_start();
 
+  /* Only the readings are taken from the task */
+  for(;;)
+  {
+    stream_step();
+    osDelayUntil(&wake, PID_TASK_PERIOD_MS);
+  }
+#else
   /* Infinite loop */
   for(;;)
   {
     for (int pwm_percent = 0; pwm_percent < 100; pwm_percent += 1) {
-
-      Pwm_setDuty(&led_dimmer_handle, (float)pwm_percent);
-
-      photocell_value = readSensor(&photocell_handle);
-      log_write(LOG_LEVEL_INFO, "Photocell Value: %f", photocell_value);
-
-      osDelay(100); // Adjust delay as needed
+      sweep_step((float)pwm_percent);
+      osDelayUntil(&wake, PID_TASK_PERIOD_MS); // Adjust delay as needed
     }
 
     for (int pwm_percent = 100; pwm_percent >= 0; pwm_percent -= 1) {
-
-      Pwm_setDuty(&led_dimmer_handle, (float)pwm_percent);
-
-      photocell_value = readSensor(&photocell_handle);
-      log_write(LOG_LEVEL_INFO, "Photocell Value: %f", photocell_value);
-
-      osDelay(100); // Adjust delay as needed
+      sweep_step((float)pwm_percent);
+      osDelayUntil(&wake, PID_TASK_PERIOD_MS); // Adjust delay as needed
     }
   }
+#endif
   /* USER CODE END 5 */
 }
 
@@ -0,0 +1,56 @@
+/**
+ * @file    mpc.c
+ * @brief   Implementation of the explicit MPC region search.
+ */
+
+#include "mpc.h"
+
+/* ----------------------------- Helpers ----------------------------- */
+/* Largest row value of a region; ≤ 0 inside it */
+RAMFUNC_INLINE float region_violation(const mpc_region_t *reg, float level, float rate,
+                                      float setpoint)
+{
+    float worst = -1.0f;
+    for (uint32_t i = 0; i < reg->n_ineq; i++)
+    {
+        const float *q = reg->ineq[i];
+        float v = q[0] * level + q[1] * rate + q[2] * setpoint + q[3];
+        worst = (v > worst) ? v : worst;
+    }
+    return worst;
+}
+
+/* --------------------------- Public API ---------------------------- */
+void mpc_init(mpc_t *mpc, const mpc_region_t *regions, uint32_t n,
+              float u_min, float u_max)
+{
+    mpc->regions = regions;
+    mpc->n       = n;
+    mpc->last    = 0u;              /* the most visited region */
+    mpc->u_min   = u_min;
+    mpc->u_max   = u_max;
+}
+
+RAMFUNC float mpc_compute(mpc_t *mpc, float level, float rate, float setpoint)
+{
+    /* Previous region first, then the table in order of visit frequency */
+    uint32_t best = mpc->last;
+    float best_v  = region_violation(&mpc->regions[best], level, rate, setpoint);
+    for (uint32_t r = 0; r < mpc->n && best_v > MPC_EPS; r++)
+    {
+        if (r == mpc->last) continue;
+        float v = region_violation(&mpc->regions[r], level, rate, setpoint);
+        if (v < best_v)
+        {
+            best   = r;
+            best_v = v;
+        }
+    }
+    mpc->last = best;
+
+    const float *k = mpc->regions[best].law;
+    float u = k[0] * level + k[1] * rate + k[2] * setpoint + k[3];
+    u = (u < mpc->u_min) ? mpc->u_min : u;
+    u = (u > mpc->u_max) ? mpc->u_max : u;
+    return u;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file    parambox.c
+ * @brief   Implementation of the single-writer parameter latch.
+ *
+ * Writer:  seq = 2n+1, write copy 0, seq = 2n+2, write copy 1.
+ * Reader:  copy index = seq & 1 and version = seq >> 1, so copy 0 is read
+ *          only once it holds version n+1 and copy 1 (still version n)
+ *          while copy 0 is being written.  The copy is valid if seq did
+ *          not change across it.
+ *
+ * Orderings follow the C11 seqlock pattern: the writer orders each seq
+ * store before the data stores that follow it with a release fence; the
+ * reader orders its data loads before the seq re-check with an acquire
+ * fence.  On the Cortex-M4 each fence is a single DMB.
+ */
+
+#include "parambox.h"
+#include <string.h>
+
+/* ----------------------------- Helpers ----------------------------- */
+static void store_copy(parambox_t *box, uint32_t idx, const uint32_t *w)
+{
+    for (uint32_t i = 0; i < PARAMBOX_WORDS; i++)
+    {
+        atomic_store_explicit(&box->data[idx][i], w[i], memory_order_relaxed);
+    }
+}
+
+/* --------------------------- Public API ---------------------------- */
+void parambox_init(parambox_t *box, const void *initial, size_t size)
+{
+    uint32_t w[PARAMBOX_WORDS] = {0};
+    if (size > PARAMBOX_MAX_SIZE) size = PARAMBOX_MAX_SIZE;
+    memcpy(w, initial, size);
+
+    box->size = (uint32_t)size;
+    store_copy(box, 0u, w);
+    store_copy(box, 1u, w);
+    atomic_store_explicit(&box->seq, 0u, memory_order_release);
+}
+
+void parambox_publish(parambox_t *box, const void *payload)
+{
+    uint32_t w[PARAMBOX_WORDS] = {0};
+    memcpy(w, payload, box->size);
+
+    uint32_t s = atomic_load_explicit(&box->seq, memory_order_relaxed);
+
+    atomic_store_explicit(&box->seq, s + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    store_copy(box, 0u, w);
+
+    atomic_store_explicit(&box->seq, s + 2u, memory_order_release);
+    atomic_thread_fence(memory_order_release);
+    store_copy(box, 1u, w);
+}
+
+bool parambox_poll(parambox_t *box, void *out, uint32_t *last_version)
+{
+    uint32_t w[PARAMBOX_WORDS];
+
+    for (uint32_t attempt = 0; attempt < PARAMBOX_READ_TRIES; attempt++)
+    {
+        uint32_t s = atomic_load_explicit(&box->seq, memory_order_acquire);
+        if ((s >> 1) == *last_version) return false;
+
+        uint32_t idx = s & 1u;
+        for (uint32_t i = 0; i < PARAMBOX_WORDS; i++)
+        {
+            w[i] = atomic_load_explicit(&box->data[idx][i], memory_order_relaxed);
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&box->seq, memory_order_relaxed) == s)
+        {
+            memcpy(out, w, box->size);
+            *last_version = s >> 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t parambox_version(parambox_t *box)
+{
+    return (atomic_load_explicit(&box->seq, memory_order_acquire) + 1u) >> 1;
+}
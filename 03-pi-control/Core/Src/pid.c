@@ -6,10 +6,12 @@
 #include "pid.h"
 
 /* ----------------------------- Helpers ----------------------------- */
-static inline float pid_clamp(float v, float lo, float hi)
+/* Written as selects so GCC emits predicated moves (IT + VMOV on the
+ * Cortex-M4) rather than branches. */
+RAMFUNC_INLINE float pid_clamp(float v, float lo, float hi)
 {
-    if (v > hi) return hi;
-    if (v < lo) return lo;
+    v = (v > hi) ? hi : v;
+    v = (v < lo) ? lo : v;
     return v;
 }
 
@@ -27,12 +29,194 @@ void pid_init(pid_t *pid,
     pid->integral  = 0.0f;
     pid->out_min   = out_min;
     pid->out_max   = out_max;
+    pid->e_prev    = 0.0f;
+    pid->Ts        = PID_TS;
+    pid->deriv     = 0.0f;
+    pid->y_prev    = 0.0f;
+    pid->d_primed  = 0.0f;
+    pid->Kd        = 0.0f;
+    pid->form      = PID_FORM;
+    pid->out       = 0.0f;
+    pid_set_antiwindup(pid, PID_ANTIWINDUP, PID_KT);
+    pid_set_derivative(pid, PID_KD, PID_TF);
+    pid_set_sample_time(pid, PID_TS, PID_DISCRETIZATION);
 }
 
-float pid_compute(pid_t *pid, float measured)
+void pid_set_derivative(pid_t *pid, float kd, float tf)
 {
-    float error = pid->setpoint - measured;
-    pid->integral += error;
-    float output = pid->Kp * error + pid->Ki * pid->integral;
-    return pid_clamp(output, pid->out_min, pid->out_max);
+    /* Keep the filtered derivative consistent with the new gain */
+    pid->deriv = (pid->Kd != 0.0f) ? pid->deriv * (kd / pid->Kd) : 0.0f;
+    pid->Kd  = kd;
+    pid->Tf  = tf;
+    pid->d_a = tf / (tf + pid->Ts);
+    pid->d_b = kd / (tf + pid->Ts);
+}
+
+void pid_set_sample_time(pid_t *pid, float ts, pid_disc_t disc)
+{
+    pid->Ts       = ts;
+    pid->disc     = disc;
+    pid->disc_w0  = PID_DISC_W0(disc);
+    pid->disc_w1  = PID_DISC_W1(disc);
+    pid->ki_b0    = pid->Ki * ts * pid->disc_w0;
+    pid->ki_b1    = pid->Ki * ts * pid->disc_w1;
+    pid->aw_kt_ts = pid->aw_kt * ts;
+    pid->d_a      = pid->Tf / (pid->Tf + ts);
+    pid->d_b      = pid->Kd / (pid->Tf + ts);
+}
+
+void pid_set_antiwindup(pid_t *pid, pid_antiwindup_t mode, float kt)
+{
+    pid->aw       = mode;
+    pid->aw_min   = (mode == PID_AW_CLAMP) ? pid->out_min : -FLT_MAX;
+    pid->aw_max   = (mode == PID_AW_CLAMP) ? pid->out_max :  FLT_MAX;
+    pid->aw_gate  = (mode == PID_AW_CONDITIONAL) ? 0.0f : 1.0f;
+    pid->aw_kt    = (mode == PID_AW_BACKCALC) ? kt : 0.0f;
+    pid->aw_kt_ts = pid->aw_kt * pid->Ts;
+}
+
+void pid_set_gains(pid_t *pid, float kp, float ki, float kd)
+{
+    /* Positional form: move the change of P and D into the integral so
+     * the next output continues from the last one, within the anti-windup
+     * bounds: a retune while saturated must not wind the integral past
+     * them.  The velocity form accumulates its output and needs no
+     * correction. */
+    float pd_old = pid->Kp * pid->e_prev + pid->deriv;
+
+    pid->Kp = kp;
+    pid->Ki = ki;
+    pid_set_derivative(pid, kd, pid->Tf);
+    pid_set_sample_time(pid, pid->Ts, pid->disc);
+
+    pid->integral = pid_clamp(pid->integral + pd_old - (kp * pid->e_prev + pid->deriv),
+                              pid->aw_min, pid->aw_max);
+}
+
+void pid_apply_params(pid_t *pid, const pid_params_t *params)
+{
+    pid->Tf       = params->Tf;
+    pid->setpoint = params->setpoint;
+    pid->out_min  = params->out_min;
+    pid->out_max  = params->out_max;
+    pid_set_antiwindup(pid, pid->aw, pid->aw_kt);   /* clamp bounds follow the limits */
+    pid_set_gains(pid, params->Kp, params->Ki, params->Kd);
+}
+
+void pid_get_params(const pid_t *pid, pid_params_t *params)
+{
+    params->Kp       = pid->Kp;
+    params->Ki       = pid->Ki;
+    params->Kd       = pid->Kd;
+    params->Tf       = pid->Tf;
+    params->setpoint = pid->setpoint;
+    params->out_min  = pid->out_min;
+    params->out_max  = pid->out_max;
+}
+
+void pid_set_form(pid_t *pid, pid_form_t form)
+{
+    /* Hand over through the last output: the velocity form continues from
+     * it, the positional form rebuilds its integral to reproduce it. */
+    pid->form     = form;
+    pid->integral = pid->out - (pid->Kp * pid->e_prev + pid->deriv);
+}
+
+float pid_track(pid_t *pid, float measured, float u)
+{
+    float error   = pid->setpoint - measured;
+    float dy      = (measured - pid->y_prev) * pid->d_primed;
+    pid->deriv    = pid->d_a * pid->deriv - pid->d_b * dy;
+    pid->y_prev   = measured;
+    pid->d_primed = 1.0f;
+    pid->e_prev   = error;
+
+    pid->out      = pid_clamp(u, pid->out_min, pid->out_max);
+    pid->integral = pid->out - (pid->Kp * error + pid->deriv);
+    return pid->out;
+}
+
+RAMFUNC void pid_track_applied(pid_t *pid, float u)
+{
+    /* e_prev and deriv still hold this tick's terms */
+    pid->out      = pid_clamp(u, pid->out_min, pid->out_max);
+    pid->integral = pid->out - (pid->Kp * pid->e_prev + pid->deriv);
+}
+
+/* Shared by the fixed-Ts and measured-dt entry points: b0/b1 weight the
+ * current and previous error in the integral increment, da/db are the
+ * derivative filter coefficients, kt is the per-sample back-calculation
+ * gain. */
+RAMFUNC_INLINE float pid_step(pid_t *pid, float measured,
+                              float b0, float b1, float da, float db, float kt)
+{
+    float error  = pid->setpoint - measured;
+    float e_prev = pid->e_prev;
+    float di     = b0 * error + b1 * e_prev;
+    pid->e_prev  = error;
+
+    /* D on measurement; the first sample has no predecessor to difference */
+    float dy      = (measured - pid->y_prev) * pid->d_primed;
+    float d_prev  = pid->deriv;
+    pid->y_prev   = measured;
+    pid->d_primed = 1.0f;
+    pid->deriv    = da * d_prev - db * dy;
+
+    if (pid->form == PID_FORM_VELOCITY)
+    {
+        /* Δu from the error difference; clamping the accumulated output
+         * is the whole anti-windup, there is no integrator to wind up */
+        float du = pid->Kp * (error - e_prev) + di + (pid->deriv - d_prev);
+        pid->out = pid_clamp(pid->out + du, pid->out_min, pid->out_max);
+        return pid->out;
+    }
+
+    float pd       = pid->Kp * error + pid->deriv;
+    float integral = pid->integral;
+
+    /* The mode is configuration, not data: no limit or a plain clamp needs
+     * none of the saturation terms below, and pid->integral feeds the next
+     * call, so every operation here adds to the loop-carried latency. */
+    if (pid->aw <= PID_AW_CLAMP)
+    {
+        pid->integral = pid_clamp(integral + di, pid->aw_min, pid->aw_max);
+        pid->out = pid_clamp(pd + pid->integral, pid->out_min, pid->out_max);
+        return pid->out;
+    }
+
+    /* Unlimited output if this sample were integrated as usual */
+    float raw = integral + (pd + di);
+    float sat = pid_clamp(raw, pid->out_min, pid->out_max);
+
+    /* Conditional integration: drop di while the error pushes further
+     * into the active limit.  Tested on raw, not on raw - sat, so the
+     * gate does not wait for the clamp. */
+    float side = (float)((raw > pid->out_max) - (raw < pid->out_min));
+    float gate = (side * error > 0.0f) ? pid->aw_gate : 1.0f;
+
+    /* One update covers both modes: gating and back-calculation are
+     * neutral unless enabled by pid_set_antiwindup(). */
+    integral = integral + di * gate - kt * (raw - sat);
+    pid->integral = pid_clamp(integral, pid->aw_min, pid->aw_max);
+
+    pid->out = pid_clamp(pd + pid->integral, pid->out_min, pid->out_max);
+    return pid->out;
+}
+
+RAMFUNC float pid_compute(pid_t *pid, float measured)
+{
+    return pid_step(pid, measured, pid->ki_b0, pid->ki_b1,
+                    pid->d_a, pid->d_b, pid->aw_kt_ts);
+}
+
+RAMFUNC float pid_compute_dt(pid_t *pid, float measured, float dt)
+{
+    /* A repeated (or backwards) time stamp: nothing to integrate, and
+     * 1 / (Tf + dt) would be infinite with Tf = 0 */
+    if (!(dt > 0.0f)) return pid->out;
+
+    float ki_dt = pid->Ki * dt;
+    float inv   = 1.0f / (pid->Tf + dt);
+    return pid_step(pid, measured, ki_dt * pid->disc_w0, ki_dt * pid->disc_w1,
+                    pid->Tf * inv, pid->Kd * inv, pid->aw_kt * dt);
 }
@@ -0,0 +1,100 @@
+/**
+ * @file    rls.c
+ * @brief   Implementation of the RLS ARX estimator on CMSIS-DSP matrices.
+ *
+ * Regressor before the update with y[k]:
+ *     φ = [ -y[k-1], -y[k-2], u[k-1], u[k-2], 1 ]
+ * φ and P·φ are each viewed both as a column (N×1) and as a row (1×N)
+ * matrix on the same buffer, so dot and outer products are plain
+ * arm_mat_mult_f32() calls.  Only the element-wise add, sub and scale
+ * run in place, which the CMSIS kernels allow.
+ */
+
+#include "rls.h"
+
+/* ----------------------------- Helpers ----------------------------- */
+static float dot(const arm_matrix_instance_f32 *row, const arm_matrix_instance_f32 *col)
+{
+    float r;
+    arm_matrix_instance_f32 m;
+    arm_mat_init_f32(&m, 1u, 1u, &r);
+    arm_mat_mult_f32(row, col, &m);
+    return r;
+}
+
+/* --------------------------- Public API ---------------------------- */
+void rls_init(rls_t *rls, float lambda, float p0)
+{
+    rls->lambda  = lambda;
+    rls->err     = 0.0f;
+    rls->updates = 0u;
+
+    for (uint32_t i = 0; i < RLS_N; i++)
+    {
+        rls->theta[i] = 0.0f;
+        rls->phi[i]   = 0.0f;
+        for (uint32_t j = 0; j < RLS_N; j++)
+        {
+            rls->P[i * RLS_N + j] = (i == j) ? p0 : 0.0f;
+        }
+    }
+    rls->phi[RLS_C] = 1.0f;
+
+    arm_mat_init_f32(&rls->mP,      RLS_N, RLS_N, rls->P);
+    arm_mat_init_f32(&rls->mTheta,  RLS_N, 1u,    rls->theta);
+    arm_mat_init_f32(&rls->mPhi,    RLS_N, 1u,    rls->phi);
+    arm_mat_init_f32(&rls->mPhiT,   1u,    RLS_N, rls->phi);
+    arm_mat_init_f32(&rls->mPphi,   RLS_N, 1u,    rls->Pphi);
+    arm_mat_init_f32(&rls->mPphiT,  1u,    RLS_N, rls->Pphi);
+    arm_mat_init_f32(&rls->mDtheta, RLS_N, 1u,    rls->dtheta);
+    arm_mat_init_f32(&rls->mOuter,  RLS_N, RLS_N, rls->outer);
+}
+
+float rls_update(rls_t *rls, float u, float y)
+{
+    rls->phi[RLS_B2] = rls->phi[RLS_B1];
+    rls->phi[RLS_B1] = u;
+
+    if (rls->updates >= 2u)
+    {
+        /* K = P·φ / (λ + φᵀ·P·φ); θ += K·e with e from the old θ */
+        arm_mat_mult_f32(&rls->mP, &rls->mPhi, &rls->mPphi);
+        float g = 1.0f / (rls->lambda + dot(&rls->mPhiT, &rls->mPphi));
+        rls->err = y - dot(&rls->mPhiT, &rls->mTheta);
+        arm_mat_scale_f32(&rls->mPphi, g * rls->err, &rls->mDtheta);
+        arm_mat_add_f32(&rls->mTheta, &rls->mDtheta, &rls->mTheta);
+
+        /* P = (P - K·φᵀ·P) / λ, with K·φᵀ·P = g·(P·φ)·(P·φ)ᵀ (P symmetric) */
+        arm_mat_mult_f32(&rls->mPphi, &rls->mPphiT, &rls->mOuter);
+        arm_mat_scale_f32(&rls->mOuter, g, &rls->mOuter);
+        arm_mat_sub_f32(&rls->mP, &rls->mOuter, &rls->mP);
+
+        float trace = 0.0f;
+        for (uint32_t i = 0; i < RLS_N; i++) trace += rls->P[i * RLS_N + i];
+        if (trace < RLS_TRACE_MAX)
+        {
+            arm_mat_scale_f32(&rls->mP, 1.0f / rls->lambda, &rls->mP);
+        }
+    }
+
+    rls->phi[RLS_A2] = rls->phi[RLS_A1];
+    rls->phi[RLS_A1] = -y;
+    rls->updates++;
+    return rls->err;
+}
+
+float rls_predict(const rls_t *rls, float u)
+{
+    const float *t = rls->theta;
+    return t[RLS_A1] * rls->phi[RLS_A1] + t[RLS_A2] * rls->phi[RLS_A2]
+         + t[RLS_B1] * u                + t[RLS_B2] * rls->phi[RLS_B1]
+         + t[RLS_C];
+}
+
+float rls_dc_gain(const rls_t *rls)
+{
+    const float *t = rls->theta;
+    float den = 1.0f + t[RLS_A1] + t[RLS_A2];
+    if (den > -1e-6f && den < 1e-6f) return 0.0f;
+    return (t[RLS_B1] + t[RLS_B2]) / den;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file    slew.c
+ * @brief   Implementation of the rate / jerk limiter.
+ *
+ * Per tick, with e the distance to the target, v the last step, Δ the
+ * largest step and a the largest change of the step:
+ *     v_stop = a·(√(1/4 + 2|e|/a) − 1/2)      fastest step that can still
+ *                                              brake to 0 within |e|
+ *     v_want = sign(e)·min(|e|, Δ, v_stop)
+ *     v      = clamp(v_want, v − a, v + a)
+ * Without a jerk limit a is FLT_MAX and v_stop is replaced by FLT_MAX.
+ */
+
+#include "slew.h"
+#include <float.h>
+#include <math.h>
+
+/* ----------------------------- Helpers ----------------------------- */
+/* Selects, so GCC emits predicated moves rather than branches */
+RAMFUNC_INLINE float slew_clamp(float v, float lo, float hi)
+{
+    v = (v > hi) ? hi : v;
+    v = (v < lo) ? lo : v;
+    return v;
+}
+
+/* --------------------------- Public API ---------------------------- */
+void slew_init(slew_t *s, float rate, float jerk, float ts, float u0)
+{
+    s->ts = ts;
+    slew_set_limits(s, rate, jerk);
+    slew_reset(s, u0);
+}
+
+void slew_set_limits(slew_t *s, float rate, float jerk)
+{
+    s->rate    = rate;
+    s->jerk    = jerk;
+    s->dv_max  = (rate > 0.0f) ? rate * s->ts : FLT_MAX;
+    s->dd_max  = (jerk > 0.0f) ? jerk * s->ts * s->ts : FLT_MAX;
+    s->jerk_on = (jerk > 0.0f) ? 1.0f : 0.0f;
+}
+
+void slew_reset(slew_t *s, float u)
+{
+    s->out  = u;
+    s->step = 0.0f;
+}
+
+RAMFUNC float slew_step(slew_t *s, float target)
+{
+    float e    = target - s->out;
+    float dist = fabsf(e);
+    float a    = s->dd_max;
+
+    float v_stop = a * (sqrtf(0.25f + 2.0f * dist / a) - 0.5f);
+    v_stop = (s->jerk_on != 0.0f) ? v_stop : FLT_MAX;
+
+    float v = fminf(fminf(dist, s->dv_max), v_stop);
+    v = copysignf(v, e);
+    v = slew_clamp(v, s->step - a, s->step + a);
+
+    s->step = v;
+    s->out += v;
+    return s->out;
+}
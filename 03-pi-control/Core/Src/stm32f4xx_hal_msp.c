@@ -58,6 +58,7 @@ extern DMA_HandleTypeDef hdma_usart2_tx;
 /* USER CODE END ExternalFunctions */
 
 /* USER CODE BEGIN 0 */
+extern DMA_HandleTypeDef hdma_tim2_up;
 
 /* USER CODE END 0 */
 
@@ -168,6 +169,26 @@ void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef* htim_pwm)
     __HAL_RCC_TIM2_CLK_ENABLE();
     /* USER CODE BEGIN TIM2_MspInit 1 */
 
+    /* TIM2_UP → CCR2 waveform stream (waveform.h) */
+    hdma_tim2_up.Instance = DMA1_Stream1;
+    hdma_tim2_up.Init.Channel = DMA_CHANNEL_3;
+    hdma_tim2_up.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_tim2_up.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_tim2_up.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_tim2_up.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma_tim2_up.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_tim2_up.Init.Mode = DMA_CIRCULAR;
+    hdma_tim2_up.Init.Priority = DMA_PRIORITY_HIGH;
+    hdma_tim2_up.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_tim2_up) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(htim_pwm,hdma[TIM_DMA_ID_UPDATE],hdma_tim2_up);
+
+    HAL_NVIC_SetPriority(DMA1_Stream1_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream1_IRQn);
     /* USER CODE END TIM2_MspInit 1 */
 
   }
@@ -216,6 +237,8 @@ void HAL_TIM_PWM_MspDeInit(TIM_HandleTypeDef* htim_pwm)
     /* Peripheral clock disable */
     __HAL_RCC_TIM2_CLK_DISABLE();
     /* USER CODE BEGIN TIM2_MspDeInit 1 */
+    HAL_NVIC_DisableIRQ(DMA1_Stream1_IRQn);
+    HAL_DMA_DeInit(htim_pwm->hdma[TIM_DMA_ID_UPDATE]);
 
     /* USER CODE END TIM2_MspDeInit 1 */
   }
@@ -24,6 +24,7 @@
 /* USER CODE BEGIN Includes */
 // Photocell interrupt support
 #include "photocell.h"
+#include "ramfunc.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -64,6 +65,7 @@ extern UART_HandleTypeDef huart2;
 extern TIM_HandleTypeDef htim6;
 
 /* USER CODE BEGIN EV */
+extern DMA_HandleTypeDef hdma_tim2_up;
 
 /* USER CODE END EV */
 
@@ -196,7 +198,7 @@ void DMA1_Stream6_IRQHandler(void)
 /**
   * @brief This function handles ADC1, ADC2 and ADC3 interrupts.
   */
-void ADC_IRQHandler(void)
+RAMFUNC_ISR void ADC_IRQHandler(void)
 {
   /* USER CODE BEGIN ADC_IRQn 0 */
 
@@ -237,10 +239,18 @@ void TIM6_DAC_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief DMA1 stream1 (TIM2_UP): waveform half / full transfer, refill.
+  */
+RAMFUNC_ISR void DMA1_Stream1_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_tim2_up);
+}
+
 /* USER CODE END 1 */
-// Photocell interrupt callback for ADC1
+// Photocell interrupt callback for ADC1 (SRAM, like the handler above)
 extern photoCell_t photocell_handle;
-void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
+RAMFUNC_ISR void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
   if (hadc->Instance == ADC1) {
     photoCell_handleInterrupt(&photocell_handle);
   }
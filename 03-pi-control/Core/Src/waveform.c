@@ -0,0 +1,145 @@
+/**
+ * @file    waveform.c
+ * @brief   Rendering of PWM duty profiles into the DMA buffer.
+ *
+ * Each refill renders WAVEFORM_HALF_LEN compare values.  A new sample is
+ * produced every `hold` values, so the per-sample cost (one segment
+ * interpolation or one sinf()) is paid at the sample rate, not the PWM
+ * rate.
+ */
+
+#include "waveform.h"
+#include <math.h>
+
+#define WAVEFORM_TWO_PI  6.28318531f
+
+/* ----------------------------- Helpers ----------------------------- */
+RAMFUNC_INLINE uint32_t duty_to_counts(const waveform_t *wf, float duty)
+{
+    duty = (duty < 0.0f) ? 0.0f : duty;
+    duty = (duty > 100.0f) ? 100.0f : duty;
+    return (uint32_t)(duty * (float)wf->counts * 0.01f + 0.5f);
+}
+
+RAMFUNC_INLINE float pwl_next(waveform_t *wf)
+{
+    const waveform_point_t *p = wf->points;
+    uint32_t last = wf->n_points - 1u;
+    if (wf->done) return p[last].duty;
+
+    /* Step over finished and zero-length segments (at most one lap) */
+    uint32_t laps = 0u;
+    while (wf->pos >= p[wf->seg].samples)
+    {
+        wf->pos = 0u;
+        if (++wf->seg < last) continue;
+        if (!wf->loop)
+        {
+            wf->done = true;
+            return p[last].duty;
+        }
+        wf->seg = 0u;
+        if (++laps > 1u) return p[0].duty;      /* every segment is empty */
+    }
+
+    float a = p[wf->seg].duty;
+    float b = p[wf->seg + 1u].duty;
+    float d = a + (b - a) * (float)wf->pos / (float)p[wf->seg].samples;
+    wf->pos++;
+    return d;
+}
+
+RAMFUNC_INLINE float chirp_next(waveform_t *wf)
+{
+    if (wf->pos >= wf->length)
+    {
+        if (!wf->loop)
+        {
+            wf->done = true;
+            return wf->offset;
+        }
+        wf->pos    = 0u;
+        wf->phase  = 0.0f;
+        wf->dphase = wf->dphase0;
+    }
+
+    float d = wf->offset + wf->amplitude * sinf(wf->phase);
+    wf->phase += wf->dphase;
+    wf->phase -= (wf->phase >= WAVEFORM_TWO_PI) ? WAVEFORM_TWO_PI : 0.0f;
+    wf->dphase += wf->ddphase;
+    wf->pos++;
+    return d;
+}
+
+static void restart(waveform_t *wf, waveform_kind_t kind, bool loop)
+{
+    wf->kind = kind;
+    wf->loop = loop;
+    wf->seg  = 0u;
+    wf->pos  = 0u;
+    wf->rep  = 0u;
+    wf->done = false;
+}
+
+/* --------------------------- Public API ---------------------------- */
+void waveform_init(waveform_t *wf, uint32_t counts, uint32_t hold)
+{
+    static const waveform_point_t off = { 0.0f, 0u };
+
+    wf->counts  = counts;
+    wf->hold    = (hold == 0u) ? 1u : hold;
+    wf->value   = 0u;
+    waveform_load_pwl(wf, &off, 1u, false);
+}
+
+void waveform_load_pwl(waveform_t *wf, const waveform_point_t *points,
+                       uint32_t n, bool loop)
+{
+    restart(wf, WAVEFORM_PWL, loop);
+    wf->points   = points;
+    wf->n_points = n;
+    wf->done     = (n < 2u);
+}
+
+void waveform_load_chirp(waveform_t *wf, float offset, float amplitude,
+                         float f0, float f1, float fs, uint32_t length, bool loop)
+{
+    restart(wf, WAVEFORM_CHIRP, loop);
+    wf->offset    = offset;
+    wf->amplitude = amplitude;
+    wf->phase     = 0.0f;
+    wf->dphase0   = WAVEFORM_TWO_PI * f0 / fs;
+    wf->dphase    = wf->dphase0;
+    wf->ddphase   = WAVEFORM_TWO_PI * (f1 - f0) / (fs * (float)length);
+    wf->length    = length;
+}
+
+void waveform_prime(waveform_t *wf)
+{
+    wf->refills = 0u;
+    waveform_refill(wf, 0u);
+    waveform_refill(wf, 1u);
+}
+
+RAMFUNC void waveform_refill(waveform_t *wf, uint32_t half)
+{
+    uint32_t *out = &wf->buf[half ? WAVEFORM_HALF_LEN : 0u];
+
+    for (uint32_t i = 0; i < WAVEFORM_HALF_LEN; i++)
+    {
+        if (wf->rep == 0u)
+        {
+            float d   = (wf->kind == WAVEFORM_CHIRP) ? chirp_next(wf) : pwl_next(wf);
+            wf->value = duty_to_counts(wf, d);
+            wf->rep   = wf->hold;
+        }
+        out[i] = wf->value;
+        wf->rep--;
+    }
+    wf->refills++;
+}
+
+float waveform_duty(const waveform_t *wf, uint32_t compare)
+{
+    return 100.0f * (float)compare / (float)wf->counts;
+}
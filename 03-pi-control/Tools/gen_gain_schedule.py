@@ -0,0 +1,146 @@
+"""Generate the PI gain-scheduling table for the LED/CdS loop.
+
+For every breakpoint of a uniform setpoint grid, the closed loop is
+simulated on a model of the LED -> CdS -> ADC path whose static gain
+falls steeply with brightness (the CdS response is roughly logarithmic
+in lux). Kp and Ki are picked from a log-spaced grid by minimising the
+ITAE of a small setpoint step into that operating point. The result is
+written as a C header consumed by gainsched.c:
+
+    python Tools/gen_gain_schedule.py                  # rewrites Core/Inc/gain_schedule_table.h
+    python Tools/gen_gain_schedule.py --points 21 -o /tmp/table.h
+
+The plant constants must match led_plant_log_step() in
+tests/led_plant.h, which the host test uses to check the table.
+"""
+
+import argparse
+import math
+import os
+
+# --- Plant model (keep in sync with tests/led_plant.h) -------------------
+LOG_U0 = 5.0          # duty (%) where the log curve bends
+AMBIENT = 5.0         # reading with the LED off (%)
+SPAN = 85.0           # reading span from LED off to full duty (%)
+TAU_RISE = 0.030      # CdS rise time constant (s)
+TAU_FALL = 0.060      # CdS decay time constant (s)
+TAU_ADC = 0.020       # ADC input RC filter (s)
+
+TS = 0.01             # control period (s), as in 02
+STEP = 5.0            # size of the evaluation step (%)
+HORIZON = 1.0         # simulated time per evaluation (s)
+MAX_OVERSHOOT = 0.10  # allowed overshoot as a fraction of the step
+
+
+def steady_reading(u):
+    u = min(max(u, 0.0), 100.0)
+    return AMBIENT + SPAN * math.log1p(u / LOG_U0) / math.log1p(100.0 / LOG_U0)
+
+
+def duty_for(y):
+    """Inverse of steady_reading()."""
+    frac = (y - AMBIENT) / SPAN
+    return LOG_U0 * math.expm1(frac * math.log1p(100.0 / LOG_U0))
+
+
+def itae(kp, ki, setpoint):
+    """ITAE of a step from setpoint-STEP to setpoint, plant at steady state.
+
+    The duty takes effect one tick late (ADC read -> compute -> CCR update),
+    and responses overshooting by more than MAX_OVERSHOOT are rejected so
+    the table stays robust to model error rather than merely fast.
+    """
+    start = setpoint - STEP
+    u = duty_for(start)
+    cds = y = start
+    integral = u                      # bumpless start at the old operating point
+    a_rise = math.exp(-TS / TAU_RISE)
+    a_fall = math.exp(-TS / TAU_FALL)
+    a_adc = math.exp(-TS / TAU_ADC)
+
+    cost = 0.0
+    peak = start
+    applied = u
+    for k in range(int(HORIZON / TS)):
+        e = setpoint - y
+        integral += ki * TS * e                               # backward Euler
+        integral = min(max(integral, 0.0), 100.0)             # PID_AW_CLAMP
+        u = min(max(kp * e + integral, 0.0), 100.0)
+
+        target = steady_reading(applied)                      # one tick of delay
+        applied = u
+        a = a_rise if target > cds else a_fall
+        cds = target + (cds - target) * a
+        y = cds + (y - cds) * a_adc
+        cost += (k * TS) * abs(setpoint - y) * TS
+        peak = max(peak, y)
+    if peak - setpoint > MAX_OVERSHOOT * STEP:
+        return math.inf
+    return cost
+
+
+def log_grid(lo, hi, n):
+    return [lo * (hi / lo) ** (i / (n - 1)) for i in range(n)]
+
+
+def tune(setpoint):
+    best = None
+    for kp in log_grid(0.02, 20.0, 37):
+        for ki in log_grid(0.5, 500.0, 37):
+            c = itae(kp, ki, setpoint)
+            if best is None or c < best[0]:
+                best = (c, kp, ki)
+    return best
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="Generate gain_schedule_table.h")
+    parser.add_argument("--points", type=int, default=16, help="Number of breakpoints")
+    parser.add_argument("--first", type=float, default=10.0, help="First setpoint (%%)")
+    parser.add_argument("--last", type=float, default=85.0, help="Last setpoint (%%)")
+    parser.add_argument("-o", "--output",
+                        default=os.path.join(here, "..", "Core", "Inc", "gain_schedule_table.h"))
+    args = parser.parse_args()
+
+    dx = (args.last - args.first) / (args.points - 1)
+    rows = []
+    for i in range(args.points):
+        sp = args.first + i * dx
+        cost, kp, ki = tune(sp)
+        rows.append((sp, kp, ki, cost))
+        print(f"setpoint {sp:5.1f}: Kp={kp:.4f} Ki={ki:.3f}  ITAE={cost:.5f}")
+
+    lines = [
+        "/**",
+        " * @file    gain_schedule_table.h",
+        " * @brief   PI gain schedule over the setpoint, generated by",
+        " *          Tools/gen_gain_schedule.py – do not edit.",
+        " *",
+        f" * Plant: log CdS curve (U0={LOG_U0}), tau rise/fall {TAU_RISE}/{TAU_FALL} s,",
+        f" * ADC RC {TAU_ADC} s; tuned for min ITAE of a {STEP} % step at Ts={TS} s.",
+        " */",
+        "",
+        "#ifndef GAIN_SCHEDULE_TABLE_H",
+        "#define GAIN_SCHEDULE_TABLE_H",
+        "",
+        '#include "ramfunc.h"',
+        "",
+        f"#define GAIN_SCHEDULE_X0      {args.first:.1f}f",
+        f"#define GAIN_SCHEDULE_DX      {dx:.4f}f",
+        f"#define GAIN_SCHEDULE_POINTS  {args.points}u",
+        "",
+        "/* { Kp, Ki (1/s), Kd (s) } per breakpoint */",
+        "RAMDATA static const float gain_schedule_table[GAIN_SCHEDULE_POINTS][3] = {",
+    ]
+    for sp, kp, ki, _ in rows:
+        lines.append(f"    {{ {kp:.5f}f, {ki:8.4f}f, 0.0f }},  /* setpoint {sp:5.1f} */")
+    lines += ["};", "", "#endif /* GAIN_SCHEDULE_TABLE_H */", ""]
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(lines))
+    print(f"wrote {os.path.relpath(args.output)}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,237 @@
+"""Generate the explicit MPC law for the LED/CdS loop.
+
+The controller minimises, over a prediction horizon of NP ticks,
+
+    sum_k (y[k] - r)^2 + RHO * sum_j (u[j] - u_ss(r))^2,   u_min <= u <= u_max
+
+on the two-lag model of the LED -> CdS -> ADC chain that kalman_init_led()
+uses, with state [level, rate] and u_ss(r) the duty that holds r. The
+input is move-blocked into NC blocks (BLOCKS ticks each), so the QP has
+NC variables with box constraints only.
+
+A box-constrained QP has one optimal active set per parameter
+theta = [level, rate, r]: every variable is either free, at u_min or at
+u_max. For each of the 3^NC active sets the optimiser is affine in theta
+and is optimal exactly where the free variables lie inside the box and
+the multipliers of the fixed ones are non-negative, which is a polyhedron
+in theta. Those polyhedra tile the whole parameter space. Only the
+regions actually reached by a sampled grid of operating points are kept,
+most-visited first, with the law for u[0] and their inequalities:
+
+    python Tools/gen_mpc_table.py                 # rewrites Core/Inc/mpc_table.h
+    python Tools/gen_mpc_table.py --rho 0.01 -o /tmp/mpc_table.h
+
+mpc.c then only searches the regions and applies one affine map. The
+model constants must match the kalman_init_led() call in mpc.h's usage.
+"""
+
+import argparse
+import itertools
+import math
+import os
+
+# --- Model (keep in sync with kalman_init_led() in the usage of mpc.h) ---
+GAIN = 0.8            # % reading per % duty
+AMBIENT = 5.0         # reading with the LED off (%)
+TAU1 = 0.045          # CdS, between its rise and decay constants (s)
+TAU2 = 0.020          # ADC input RC filter (s)
+TS = 0.01             # control period (s)
+
+# --- Controller -----------------------------------------------------------
+NP = 30               # prediction horizon (ticks)
+BLOCKS = (1, 2, 27)   # ticks per input block, sum == NP
+RHO = 2e-3            # weight of (u - u_ss)^2 against (y - r)^2
+
+# --- Sampled operating region ---------------------------------------------
+LEVELS = (0.0, 100.0, 21)
+RATES = (-1500.0, 1500.0, 25)
+SETPOINTS = (5.0, 85.0, 17)
+
+
+# --- Small dense linear algebra ---------------------------------------------
+def matmul(a, b):
+    return [[sum(a[i][k] * b[k][j] for k in range(len(b))) for j in range(len(b[0]))]
+            for i in range(len(a))]
+
+
+def solve(a, b):
+    """Solve a·x = b for a matrix right-hand side by Gaussian elimination."""
+    n = len(a)
+    m = [list(a[i]) + list(b[i]) for i in range(n)]
+    for c in range(n):
+        p = max(range(c, n), key=lambda r: abs(m[r][c]))
+        m[c], m[p] = m[p], m[c]
+        for r in range(n):
+            if r != c:
+                f = m[r][c] / m[c][c]
+                m[r] = [x - f * y for x, y in zip(m[r], m[c])]
+    return [[x / m[i][i] for x in m[i][n:]] for i in range(n)]
+
+
+def discretise():
+    """ZOH of y'' + (1/t1 + 1/t2)y' + y/(t1 t2) = (gain·u + ambient)/(t1 t2)."""
+    w = 1.0 / (TAU1 * TAU2)
+    ac = [[0.0, 1.0], [-w, -(TAU1 + TAU2) * w]]
+    a = [[1.0, 0.0], [0.0, 1.0]]
+    gamma = [[TS, 0.0], [0.0, TS]]
+    term = [[1.0, 0.0], [0.0, 1.0]]
+    for k in range(1, 21):
+        term = [[x * TS / k for x in row] for row in matmul(term, ac)]
+        a = [[a[i][j] + term[i][j] for j in range(2)] for i in range(2)]
+        gamma = [[gamma[i][j] + term[i][j] * TS / (k + 1) for j in range(2)] for i in range(2)]
+    b = [gamma[0][1] * GAIN * w, gamma[1][1] * GAIN * w]
+    c = [gamma[0][1] * AMBIENT * w, gamma[1][1] * AMBIENT * w]
+    return a, b, c
+
+
+def qp_matrices(rho):
+    """Cost ½U'HU + U'(F·p) with p = [level, rate, r, 1]."""
+    a, b, c = discretise()
+    nc = len(BLOCKS)
+    block_of = [i for i, n in enumerate(BLOCKS) for _ in range(n)]
+
+    # Predicted level y[k] = phi[k]·p + gam[k]·U, k = 1..NP
+    x_p = [[1.0, 0.0, 0.0, 0.0], [0.0, 1.0, 0.0, 0.0]]     # state as a map of p
+    x_u = [[0.0] * nc, [0.0] * nc]                           # state as a map of U
+    phi, gam = [], []
+    for k in range(NP):
+        x_p = [[sum(a[i][m] * x_p[m][j] for m in range(2)) + (c[i] if j == 3 else 0.0)
+                for j in range(4)] for i in range(2)]
+        x_u = [[sum(a[i][m] * x_u[m][j] for m in range(2)) + (b[i] if j == block_of[k] else 0.0)
+                for j in range(nc)] for i in range(2)]
+        phi.append([x_p[0][j] - (1.0 if j == 2 else 0.0) for j in range(4)])   # y - r
+        gam.append(list(x_u[0]))
+
+    # u_ss(r) = (r - ambient) / gain as a map of p
+    uss = [0.0, 0.0, 1.0 / GAIN, -AMBIENT / GAIN]
+    h = [[2.0 * sum(g[i] * g[j] for g in gam) + (2.0 * rho * BLOCKS[i] if i == j else 0.0)
+          for j in range(nc)] for i in range(nc)]
+    f = [[2.0 * sum(gam[k][i] * phi[k][j] for k in range(NP)) - 2.0 * rho * BLOCKS[i] * uss[j]
+          for j in range(4)] for i in range(nc)]
+    return h, f
+
+
+def region(h, f, active, u_min, u_max):
+    """Law for U and the inequalities (rows q with q·p <= 0) of one active set."""
+    nc = len(active)
+    free = [i for i in range(nc) if active[i] == 0]
+    fixed = {i: (u_min if active[i] < 0 else u_max) for i in range(nc) if active[i] != 0}
+
+    # U as an affine map of p: fixed entries constant, free ones from H_FF U_F = -(F p + H_FA U_A)
+    law = [[0.0, 0.0, 0.0, fixed[i]] if i in fixed else None for i in range(nc)]
+    if free:
+        rhs = [[-f[i][j] - (sum(h[i][m] * fixed[m] for m in fixed) if j == 3 else 0.0)
+                for j in range(4)] for i in free]
+        sol = solve([[h[i][j] for j in free] for i in free], rhs)
+        for n, i in enumerate(free):
+            law[i] = sol[n]
+
+    rows = []
+    for i in range(nc):
+        if active[i] == 0:
+            rows.append([law[i][j] - (u_max if j == 3 else 0.0) for j in range(4)])  # u <= max
+            rows.append([-law[i][j] + (u_min if j == 3 else 0.0) for j in range(4)]) # u >= min
+        else:
+            # Gradient g = H U + F p; at u_min g >= 0, at u_max g <= 0
+            g = [sum(h[i][m] * law[m][j] for m in range(nc)) + f[i][j] for j in range(4)]
+            rows.append([-x for x in g] if active[i] < 0 else g)
+    return law[0], rows
+
+
+def scale_row(q):
+    """Normalise so that q·p is in units of the sampled parameter span."""
+    s = math.hypot(q[0] * (LEVELS[1] - LEVELS[0]), q[1] * (RATES[1] - RATES[0]),
+                   q[2] * (SETPOINTS[1] - SETPOINTS[0]))
+    return [x / s for x in q] if s > 0.0 else q
+
+
+def grid(spec):
+    lo, hi, n = spec
+    return [lo + (hi - lo) * i / (n - 1) for i in range(n)]
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="Generate mpc_table.h")
+    parser.add_argument("--rho", type=float, default=RHO, help="Input weight")
+    parser.add_argument("--u-min", type=float, default=0.0, help="Lower duty limit (%%)")
+    parser.add_argument("--u-max", type=float, default=100.0, help="Upper duty limit (%%)")
+    parser.add_argument("-o", "--output",
+                        default=os.path.join(here, "..", "Core", "Inc", "mpc_table.h"))
+    args = parser.parse_args()
+
+    h, f = qp_matrices(args.rho)
+
+    candidates = []
+    for active in itertools.product((0, -1, 1), repeat=len(BLOCKS)):
+        law, rows = region(h, f, active, args.u_min, args.u_max)
+        candidates.append((active, law, [scale_row(q) for q in rows]))
+
+    # Visit the operating grid.  The containing region has no violated row;
+    # taking the smallest worst violation also settles points on boundaries.
+    hits = [0] * len(candidates)
+    samples = 0
+    for level in grid(LEVELS):
+        for rate in grid(RATES):
+            for r in grid(SETPOINTS):
+                p = (level, rate, r, 1.0)
+                worst = [max(sum(q[j] * p[j] for j in range(4)) for q in rows)
+                         for _, _, rows in candidates]
+                hits[min(range(len(candidates)), key=lambda i: worst[i])] += 1
+                samples += 1
+
+    order = sorted((i for i in range(len(candidates)) if hits[i]), key=lambda i: -hits[i])
+    max_rows = max(len(candidates[i][2]) for i in order)
+    names = {0: "free", -1: "min", 1: "max"}
+    for i in order:
+        active, law, _ = candidates[i]
+        print(f"{'/'.join(names[a] for a in active):<14} {100.0 * hits[i] / samples:5.1f} %  "
+              f"u0 = {law[0]:.4f}·level {law[1]:+.6f}·rate {law[2]:+.4f}·r {law[3]:+.3f}")
+
+    lines = [
+        "/**",
+        " * @file    mpc_table.h",
+        " * @brief   Explicit MPC law for the LED loop, generated by",
+        " *          Tools/gen_mpc_table.py – do not edit.",
+        " *",
+        f" * Model: gain {GAIN}, ambient {AMBIENT} %, lags {TAU1}/{TAU2} s at Ts={TS} s.",
+        f" * Horizon {NP} ticks in blocks {'/'.join(str(n) for n in BLOCKS)}, rho={args.rho:g},",
+        f" * duty in [{args.u_min:g}, {args.u_max:g}] %; {len(order)} of {len(candidates)} "
+        f"active sets reached.",
+        " */",
+        "",
+        "#ifndef MPC_TABLE_H",
+        "#define MPC_TABLE_H",
+        "",
+        '#include "mpc.h"',
+        '#include "ramfunc.h"',
+        "",
+        f"#define MPC_TABLE_TS       {TS}f",
+        f"#define MPC_TABLE_U_MIN    {args.u_min:.1f}f",
+        f"#define MPC_TABLE_U_MAX    {args.u_max:.1f}f",
+        f"#define MPC_TABLE_REGIONS  {len(order)}u",
+        "",
+        f"#if MPC_MAX_INEQ < {max_rows}",
+        "#error \"mpc_table.h needs a larger MPC_MAX_INEQ\"",
+        "#endif",
+        "",
+        "/* { rows, { a·[level, rate, r] + b <= 0 }, u = k·[level, rate, r] + k0 },",
+        "   most-visited region first */",
+        "RAMDATA static const mpc_region_t mpc_table[MPC_TABLE_REGIONS] = {",
+    ]
+    for i in order:
+        active, law, rows = candidates[i]
+        lines.append(f"    {{ {len(rows)}u, {{  /* {'/'.join(names[a] for a in active)}, "
+                     f"{100.0 * hits[i] / samples:.1f} % */")
+        for q in rows:
+            lines.append(f"        {{ {q[0]: .6e}f, {q[1]: .6e}f, {q[2]: .6e}f, {q[3]: .6e}f }},")
+        lines.append(f"      }}, {{ {law[0]: .6e}f, {law[1]: .6e}f, {law[2]: .6e}f, {law[3]: .6e}f }} }},")
+    lines += ["};", "", "#endif /* MPC_TABLE_H */", ""]
+
+    with open(args.output, "w") as f_out:
+        f_out.write("\n".join(lines))
+    print(f"wrote {os.path.relpath(args.output)}")
+
+
+if __name__ == "__main__":
+    main()
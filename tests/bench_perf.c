@@ -0,0 +1,70 @@
+/**
+ * @file    bench_perf.c
+ * @brief   perf_event_open() wrapper with a graceful no-counter fallback.
+ */
+
+#define _GNU_SOURCE
+#include "bench_perf.h"
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+#ifdef __linux__
+static int perf_open(uint64_t config, int group)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = config;
+    attr.disabled       = (group < 0) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+void bench_perf_start(bench_perf_t *p)
+{
+    p->fd_instr = -1;
+    p->fd_miss  = -1;
+#ifdef __linux__
+    p->fd_instr = perf_open(PERF_COUNT_HW_INSTRUCTIONS, -1);
+    if (p->fd_instr < 0) return;
+    p->fd_miss = perf_open(PERF_COUNT_HW_CACHE_MISSES, p->fd_instr);
+    ioctl(p->fd_instr, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(p->fd_instr, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+void bench_perf_stop(bench_perf_t *p, int64_t *instr, int64_t *misses)
+{
+    *instr  = -1;
+    *misses = -1;
+#ifdef __linux__
+    if (p->fd_instr < 0) return;
+    ioctl(p->fd_instr, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    uint64_t v = 0;
+    if (read(p->fd_instr, &v, sizeof(v)) == (ssize_t)sizeof(v)) *instr = (int64_t)v;
+    if (p->fd_miss >= 0)
+    {
+        if (read(p->fd_miss, &v, sizeof(v)) == (ssize_t)sizeof(v)) *misses = (int64_t)v;
+        close(p->fd_miss);
+    }
+    close(p->fd_instr);
+#endif
+}
@@ -0,0 +1,33 @@
+/**
+ * @file    bench_perf.h
+ * @brief   Host timing and hardware-counter helpers for control_bench.
+ *
+ * Kept in its own translation unit: the system headers it needs define
+ * POSIX pid_t, which clashes with the controller type in pid.h.
+ */
+
+#ifndef BENCH_PERF_H
+#define BENCH_PERF_H
+
+#include <stdint.h>
+
+/** Monotonic time in nanoseconds. */
+double bench_now_ns(void);
+
+typedef struct
+{
+    int fd_instr;   /**< Retired instructions, -1 if unavailable */
+    int fd_miss;    /**< Cache misses, -1 if unavailable         */
+} bench_perf_t;
+
+/** Open and start the counters (Linux perf_event). Never fails hard. */
+void bench_perf_start(bench_perf_t *p);
+
+/**
+ * @brief  Stop the counters and return raw counts.
+ * @param  instr   Instructions, or -1 when unavailable
+ * @param  misses  Cache misses, or -1 when unavailable
+ */
+void bench_perf_stop(bench_perf_t *p, int64_t *instr, int64_t *misses);
+
+#endif /* BENCH_PERF_H */
@@ -0,0 +1,160 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "../02-proportional-control/Core/Inc/capture.h"
+
+#define PERIOD   1800000u       /* 10 ms at 180 MHz */
+#define PRE      64u
+
+static capture_t cap;
+static uint32_t  k;             /* iteration counter, also the raw value */
+
+/* One control iteration: y settles on the setpoint, the duty mid-scale */
+static bool feed(float setpoint, float y, float duty)
+{
+    capture_sample_t s = { k * PERIOD + (k & 7u), k, y, duty, 0.5f * duty };
+    k++;
+    return capture_record(&cap, &s, setpoint);
+}
+
+static void check_window(uint32_t trigger_k)
+{
+    assert(cap.state == CAPTURE_FROZEN);
+    const capture_sample_t *t = capture_sample(&cap, cap.trig_index);
+    assert(t->raw == trigger_k);
+    for (uint32_t i = 1; i < cap.count; i++)
+        assert(capture_sample(&cap, i)->raw == capture_sample(&cap, i - 1u)->raw + 1u);
+}
+
+int main(void) {
+    capture_init(&cap, CAPTURE_TRIG_SETPOINT | CAPTURE_TRIG_ERROR | CAPTURE_TRIG_SATURATION,
+                 PRE, 20.0f, 0.0f, 100.0f);
+
+    // Idle until armed
+    for (int i = 0; i < 10; i++) assert(!feed(50.0f, 50.0f, 40.0f));
+    assert(cap.head == 0u);
+
+    // Setpoint change: PRE samples of history, the rest after
+    {
+        capture_arm(&cap);
+        uint32_t trigger_k = 0u;
+        bool done = false;
+        for (int i = 0; i < 1000 && !done; i++) {
+            float sp = (i < 500) ? 50.0f : 70.0f;
+            if (i == 500) trigger_k = k;
+            done = feed(sp, 50.0f, 40.0f);
+        }
+        assert(done);
+        assert(cap.cause == CAPTURE_TRIG_SETPOINT);
+        assert(cap.count == CAPTURE_DEPTH);
+        assert(cap.trig_index == PRE);
+        check_window(trigger_k);
+
+        /* Frozen: nothing is overwritten while the window is read out */
+        uint32_t head = cap.head;
+        for (int i = 0; i < 300; i++) assert(!feed(20.0f, 0.0f, 100.0f));
+        assert(cap.head == head);
+        check_window(trigger_k);
+    }
+
+    // Read-out: header, one line per sample, trailer, then nothing
+    {
+        char line[96];
+        uint32_t n = 0u;
+        size_t bytes = 0u;
+        assert(capture_format(&cap, n++, 180000000u, line, sizeof line) > 0u);
+        unsigned long hz, cause, count, trig;
+        assert(sscanf(line, "scope_begin,%lu,%lu,%lu,%lu", &hz, &cause, &count, &trig) == 4);
+        assert(hz == 180000000u && cause == CAPTURE_TRIG_SETPOINT);
+        assert(count == CAPTURE_DEPTH && trig == PRE);
+
+        long dt_prev = -2147483647L;
+        for (uint32_t i = 0; i < count; i++) {
+            size_t w = capture_format(&cap, n++, 180000000u, line, sizeof line);
+            assert(w > 0u && line[w - 1u] == '\n');
+            bytes += w;
+            long dt, filt, duty, integ;
+            unsigned long raw;
+            assert(sscanf(line, "scope,%ld,%lu,%ld,%ld,%ld", &dt, &raw, &filt, &duty, &integ) == 5);
+            assert(dt > dt_prev);
+            assert((dt == 0) == (i == trig));
+            assert(filt == 50000 && duty == 40000 && integ == 20000);
+            dt_prev = dt;
+        }
+        assert(capture_format(&cap, n++, 180000000u, line, sizeof line) > 0u);
+        assert(strcmp(line, "scope_end\n") == 0);
+        assert(capture_format(&cap, n, 180000000u, line, sizeof line) == 0u);
+
+        /* Truncation never overruns the caller's buffer */
+        char tiny[8];
+        assert(capture_format(&cap, 1u, 180000000u, tiny, sizeof tiny) == sizeof tiny - 1u);
+        assert(tiny[sizeof tiny - 1u] == '\0');
+        printf("window of %u samples: %lu bytes to read out\n",
+               (unsigned)CAPTURE_DEPTH, (unsigned long)bytes);
+    }
+
+    // A trigger right after arming keeps what history there is
+    {
+        capture_arm(&cap);
+        for (int i = 0; i < 10; i++) assert(!feed(50.0f, 50.0f, 40.0f));
+        uint32_t trigger_k = k;
+        bool done = false;
+        while (!done) done = feed(60.0f, 50.0f, 40.0f);
+        assert(cap.trig_index == 10u);
+        assert(cap.count == 10u + CAPTURE_DEPTH - PRE);
+        check_window(trigger_k);
+    }
+
+    // Saturation present at arming is ignored until it clears
+    {
+        capture_arm(&cap);
+        for (int i = 0; i < 500; i++) assert(!feed(50.0f, 45.0f, 100.0f));
+        for (int i = 0; i < 5; i++)   assert(!feed(50.0f, 45.0f, 80.0f));
+        uint32_t trigger_k = k;
+        bool done = false;
+        while (!done) done = feed(50.0f, 45.0f, 100.0f);
+        assert(cap.cause == CAPTURE_TRIG_SATURATION);
+        check_window(trigger_k);
+    }
+
+    // Error threshold, rising edge only
+    {
+        capture_arm(&cap);
+        for (int i = 0; i < 100; i++) assert(!feed(50.0f, 35.0f, 40.0f));  /* 15 < 20 */
+        uint32_t trigger_k = k;
+        bool done = false;
+        while (!done) done = feed(50.0f, 75.0f, 40.0f);
+        assert(cap.cause == CAPTURE_TRIG_ERROR);
+        check_window(trigger_k);
+    }
+
+    // Disabled triggers are ignored; capture_force() always works
+    {
+        capture_init(&cap, CAPTURE_TRIG_SETPOINT, PRE, 20.0f, 0.0f, 100.0f);
+        capture_arm(&cap);
+        for (int i = 0; i < 300; i++) {
+            assert(!feed(50.0f, (i & 1) ? 0.0f : 50.0f, (i & 1) ? 100.0f : 50.0f));
+        }
+        capture_force(&cap);
+        uint32_t trigger_k = k;
+        bool done = false;
+        while (!done) done = feed(50.0f, 50.0f, 50.0f);
+        assert(cap.cause == CAPTURE_TRIG_FORCE);
+        assert(cap.captures == 1u);
+        check_window(trigger_k);
+    }
+
+    // pre is limited to leave room for the trigger sample
+    {
+        capture_init(&cap, CAPTURE_TRIG_SETPOINT, 10000u, 1.0f, 0.0f, 100.0f);
+        assert(cap.pre == CAPTURE_DEPTH - 1u);
+        capture_arm(&cap);
+        for (int i = 0; i < 400; i++) assert(!feed(50.0f, 50.0f, 50.0f));
+        uint32_t trigger_k = k;
+        assert(feed(51.0f, 50.0f, 50.0f));
+        assert(cap.trig_index == CAPTURE_DEPTH - 1u);
+        check_window(trigger_k);
+    }
+
+    return 0;
+}
@@ -0,0 +1,659 @@
+/**
+ * @file    control_bench.c
+ * @brief   Host micro-benchmarks for the control-path primitives.
+ *
+ * Reports ns/op (min over several repetitions) and, where the kernel
+ * allows perf_event_open(), retired instructions and cache misses per op.
+ * Results are written as JSON, one case per line.
+ *
+ * With --check the run is compared against a checked-in baseline.  To be
+ * independent of host speed, ns/op is normalised by a fixed reference
+ * kernel measured in the same run; instructions/op is compared directly
+ * when both sides have it.
+ *
+ *     control_bench [--json out.json] [--check baseline.json] [--threshold 2.0]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_perf.h"
+#include "../03-pi-control/Core/Inc/pid.h"
+#include "../03-pi-control/Core/Inc/looptime.h"
+#include "../03-pi-control/Core/Inc/gainsched.h"
+#include "../03-pi-control/Core/Inc/gain_schedule_table.h"
+#include "../03-pi-control/Core/Inc/rls.h"
+#include "../03-pi-control/Core/Inc/freqresp.h"
+#include "../03-pi-control/Core/Inc/kalman.h"
+#include "../03-pi-control/Core/Inc/mpc.h"
+#include "../03-pi-control/Core/Inc/mpc_table.h"
+#include "../03-pi-control/Core/Inc/waveform.h"
+#include "../03-pi-control/Core/Inc/slew.h"
+#include "../02-proportional-control/Core/Inc/logger.h"
+#include "../02-proportional-control/Core/Inc/photocell.h"
+#include "../02-proportional-control/Core/Inc/led_pwm.h"
+#include "../02-proportional-control/Core/Inc/led_gamma_table.h"
+#include "../02-proportional-control/Core/Inc/capture.h"
+#include "../02-proportional-control/Core/Inc/telemetry.h"
+#include "../02-proportional-control/Core/Inc/onchange.h"
+#include "../02-proportional-control/Core/Inc/param.h"
+#include "stubs/stm32f4xx_hal.h"
+
+#define BENCH_REPEATS     7
+#define BENCH_TARGET_NS   20000000.0     /* ~20 ms per repetition */
+#define BENCH_MAX_CASES   32
+
+/* Keeps results observable so the optimiser cannot drop the work */
+static volatile float    sink_f;
+static volatile uint32_t sink_u;
+
+/* ------------------------------------------------------------------ */
+/* Cases                                                              */
+/* ------------------------------------------------------------------ */
+
+/* Fixed arithmetic workload used to normalise timings across hosts */
+static void bench_reference(uint32_t iters)
+{
+    float acc = 1.0f;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        acc = acc * 0.999f + (float)(i & 15u) * 0.001f;
+    }
+    sink_f = acc;
+}
+
+static void bench_pid_compute(uint32_t iters)
+{
+    pid_t pid;
+    pid_init(&pid, 1.2f, 0.05f, 60.0f, 0.0f, 100.0f);
+    float y = 0.0f;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        y = PID_COMPUTE(&pid, (float)(i & 127u));
+    }
+    sink_f = y;
+}
+
+/* The saturation-aware path; clamping (the default above) skips it */
+static void bench_pid_backcalc(uint32_t iters)
+{
+    pid_t pid;
+    pid_init(&pid, 1.2f, 0.05f, 60.0f, 0.0f, 100.0f);
+    pid_set_antiwindup(&pid, PID_AW_BACKCALC, 0.5f);
+    float y = 0.0f;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        y = PID_COMPUTE(&pid, (float)(i & 127u));
+    }
+    sink_f = y;
+}
+
+static void bench_pid_velocity(uint32_t iters)
+{
+    pid_t pid;
+    pid_init(&pid, 1.2f, 0.05f, 60.0f, 0.0f, 100.0f);
+    pid_set_form(&pid, PID_FORM_VELOCITY);
+    float y = 0.0f;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        y = PID_COMPUTE(&pid, (float)(i & 127u));
+    }
+    sink_f = y;
+}
+
+static void bench_pid_compute_dt(uint32_t iters)
+{
+    pid_t pid;
+    pid_init(&pid, 1.2f, 5.0f, 60.0f, 0.0f, 100.0f);
+    pid_set_sample_time(&pid, 0.01f, PID_DISC_TUSTIN);
+    float y = 0.0f;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        y = pid_compute_dt(&pid, (float)(i & 127u), 0.009f + 0.00001f * (float)(i & 255u));
+    }
+    sink_f = y;
+}
+
+/* Scheduling variable moves every step: lookup + bumpless retune + compute.
+ * The difference to pid_compute is the per-step cost of scheduling. */
+static void bench_pid_scheduled(uint32_t iters)
+{
+    pid_t pid;
+    gainsched_t sched;
+    pid_init(&pid, 1.2f, 0.05f, 60.0f, 0.0f, 100.0f);
+    gainsched_init(&sched, GAIN_SCHEDULE_X0, GAIN_SCHEDULE_DX,
+                   GAIN_SCHEDULE_POINTS, gain_schedule_table);
+    float y = 0.0f;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        float x = (float)(i & 127u);
+        gainsched_apply(&sched, &pid, x);
+        y = PID_COMPUTE(&pid, x);
+    }
+    sink_f = y;
+}
+
+static void bench_gainsched_lookup(uint32_t iters)
+{
+    gainsched_t sched;
+    gainsched_init(&sched, GAIN_SCHEDULE_X0, GAIN_SCHEDULE_DX,
+                   GAIN_SCHEDULE_POINTS, gain_schedule_table);
+    float g[3], acc = 0.0f;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        gainsched_lookup(&sched, (float)(i & 127u) + acc * 1e-9f, g);
+        acc += g[0];
+    }
+    sink_f = acc;
+}
+
+static void bench_rls_update(uint32_t iters)
+{
+    rls_t id;
+    rls_init(&id, RLS_LAMBDA, RLS_P0);
+    float y = 5.0f;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        float u = (i & 32u) ? 60.0f : 40.0f;
+        y += 0.2f * (5.0f + 0.8f * u - y);
+        rls_update(&id, u, y + (float)(i & 7u) * 0.01f);
+    }
+    sink_f = id.theta[RLS_B1];
+}
+
+/* One FREQRESP_NFFT-point real FFT; a measurement needs two per segment */
+static void bench_freqresp_rfft(uint32_t iters)
+{
+    static freqresp_t fr;
+    static float buf[FREQRESP_NFFT];
+    freqresp_init(&fr, FREQRESP_PRBS, 200.0f, 50.0f, 20.0f, 0.2f, 60.0f);
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        for (uint32_t n = 0; n < FREQRESP_NFFT; n++) buf[n] = (float)((n * 37u + i) & 63u);
+        freqresp_rfft(&fr, buf);
+    }
+    sink_f = buf[3];
+}
+
+/* Filter updates on a noisy square-wave response: covariance propagated
+ * (CMSIS matrix kernels), fixed steady-state gain, and the same in Q16.16 */
+static void kalman_bench(uint32_t iters, bool steady)
+{
+    kalman_t kf;
+    kalman_init_led(&kf, 0.01f, 0.045f, 0.020f, 0.8f, 5.0f, 5.0e5f, 3.0f);
+    if (steady) kalman_make_steady(&kf, 1000u);
+    float y = 5.0f, acc = 0.0f;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        float u = (i & 32u) ? 60.0f : 40.0f;
+        y += 0.2f * (5.0f + 0.8f * u - y);
+        acc += kalman_update(&kf, u, y + (float)(i & 7u) * 0.5f);
+    }
+    sink_f = acc;
+}
+
+static void bench_kalman_update(uint32_t iters) { kalman_bench(iters, false); }
+static void bench_kalman_steady(uint32_t iters) { kalman_bench(iters, true); }
+
+static void bench_kalman_q16(uint32_t iters)
+{
+    kalman_t kf;
+    kalman_init_led(&kf, 0.01f, 0.045f, 0.020f, 0.8f, 5.0f, 5.0e5f, 3.0f);
+    kalman_make_steady(&kf, 1000u);
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        int32_t u = (i & 32u) ? 60 * KALMAN_Q16_ONE : 40 * KALMAN_Q16_ONE;
+        int32_t z = (int32_t)(i & 7u) * (KALMAN_Q16_ONE / 2) + 45 * KALMAN_Q16_ONE;
+        acc ^= kalman_update_q16(&kf, u, z);
+    }
+    sink_u = (uint32_t)acc;
+}
+
+/* Operating point jumps every call, so most calls search the table */
+static void bench_mpc_compute(uint32_t iters)
+{
+    mpc_t mpc;
+    mpc_init(&mpc, mpc_table, MPC_TABLE_REGIONS, MPC_TABLE_U_MIN, MPC_TABLE_U_MAX);
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        float level = (float)(i & 127u) * 0.75f;
+        float rate  = (float)((int32_t)((i * 37u) & 255u) - 128) * 8.0f;
+        acc += mpc_compute(&mpc, level, rate, 40.0f + acc * 1e-9f);
+    }
+    sink_f = acc;
+}
+
+/* One DMA half-transfer interrupt: WAVEFORM_HALF_LEN samples of a ramp */
+static void bench_waveform_refill(uint32_t iters)
+{
+    static const waveform_point_t tri[] = {
+        { 0.0f, 10000u }, { 100.0f, 10000u }, { 0.0f, 0u } };
+    static waveform_t wf;
+    waveform_init(&wf, 1000u, 1u);
+    waveform_load_pwl(&wf, tri, 3u, true);
+    for (uint32_t i = 0; i < iters; i++)
+        waveform_refill(&wf, i & 1u);
+    sink_u = wf.buf[0] + wf.buf[WAVEFORM_BUF_LEN - 1u];
+}
+
+/* Target jumps every 64 calls, so the stage is always limiting */
+static void bench_slew_step(uint32_t iters)
+{
+    slew_t s;
+    slew_init(&s, 200.0f, 4000.0f, 0.01f, 0.0f);
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < iters; i++)
+        acc += slew_step(&s, (i & 64u) ? 90.0f : 10.0f);
+    sink_f = acc;
+}
+
+static void bench_photocell_read(uint32_t iters)
+{
+    photoCell_t cell;
+    photoCell_init(&cell, DEFAULT_SCALING, 300, 3800);
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        hal_stub_adc_value = i & 4095u;
+        acc += readSensor(&cell);          /* clip + map_range scaling */
+    }
+    sink_u = acc;
+}
+
+/* Work of the TIM2 update interrupt, which runs every 100 µs with dithering */
+static void bench_led_pwm_period(uint32_t iters)
+{
+    static TIM_TypeDef tim;
+    TIM_HandleTypeDef htim = { .Instance = &tim, .Init = { .Period = 99u } };
+    LedPwm_t led;
+    LedPwm_init(&led, &htim, TIM_CHANNEL_2);
+    LedPwm_setDither(&led, true);
+    LedPwm_setDutyFloat(&led, 52.875f);
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        LedPwm_periodElapsed(&led);
+        acc += tim.CCR2;
+    }
+    sink_u = acc;
+}
+
+/* Controller output through the linearisation curve */
+static void bench_led_pwm_curve(uint32_t iters)
+{
+    static TIM_TypeDef tim;
+    TIM_HandleTypeDef htim = { .Instance = &tim, .Init = { .Period = 99u } };
+    LedPwm_t led;
+    LedPwm_init(&led, &htim, TIM_CHANNEL_2);
+    LedPwm_setCurve(&led, led_gamma_table);
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        LedPwm_setDutyFloat(&led, (float)(i & 127u) * 0.78f);
+        acc += led.compare_q16;
+    }
+    sink_u = acc;
+}
+
+/* Armed and never triggering: the cost paid every control iteration */
+static void bench_capture_record(uint32_t iters)
+{
+    static capture_t cap;
+    capture_init(&cap, CAPTURE_TRIG_SETPOINT | CAPTURE_TRIG_ERROR | CAPTURE_TRIG_SATURATION,
+                 64u, 20.0f, 0.0f, 100.0f);
+    capture_arm(&cap);
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        capture_sample_t s = { i, i & 4095u, 50.0f, 40.0f + (float)(i & 15u), 0.0f };
+        capture_record(&cap, &s, 50.0f);
+    }
+    sink_u = cap.head + cap.captures;
+}
+
+/* One sample per call, a frame flushed every TELEMETRY_BATCH calls */
+static void bench_telemetry_encode(uint32_t iters)
+{
+    static telemetry_t tlm;
+    static uint8_t wire[TELEMETRY_WIRE_MAX];
+    telemetry_init(&tlm);
+    size_t bytes = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        int32_t v[TELEMETRY_CHANNELS] = {
+            2048 + (int32_t)(i & 31u), 4000 - (int32_t)(i & 63u), (int32_t)(i & 15u) - 8 };
+        if (telemetry_put(&tlm, v, (uint64_t)i * 1800000u)) bytes += telemetry_flush(&tlm, wire, sizeof(wire));
+    }
+    sink_u = (uint32_t)bytes;
+}
+
+/* Steady state: noise inside the deadbands, a report now and then */
+static void bench_onchange_update(uint32_t iters)
+{
+    static const onchange_channel_t cfg[ONCHANGE_CHANNELS] = {
+        { 32, 1000u }, { 100, 1000u }, { 100, 1000u } };
+    static onchange_t chg;
+    onchange_init(&chg, cfg);
+    uint32_t due = 0u;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        int32_t v[ONCHANGE_CHANNELS] = {
+            2048 + (int32_t)(i & 31u), 4000 - (int32_t)(i & 63u), (int32_t)(i & 127u) - 64 };
+        due += onchange_update(&chg, i * 10u, v);
+    }
+    sink_u = due + chg.reports;
+}
+
+/* One SET of a float gain per call: CRC check, validate, stage, commit */
+static void bench_param_set(uint32_t iters)
+{
+    static float gain = 1.0f;
+    static const param_def_t defs[] = {
+        { 1u, PARAM_F32, 0u, "kp", &gain, 0.0f, 10.0f } };
+    static param_registry_t reg;
+    param_init(&reg, defs, 1u);
+    uint8_t req[9] = { PARAM_CMD_SET, 0u, 1u, 0x00u, 0x00u, 0xC0u, 0x3Fu };   /* 1.5f */
+    uint16_t crc = param_crc16(req, 7u);
+    req[7] = (uint8_t)crc;
+    req[8] = (uint8_t)(crc >> 8);
+    uint8_t resp[PARAM_FRAME_MAX];
+    size_t bytes = 0u;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        bytes += param_handle(&reg, req, sizeof(req), resp, sizeof(resp));
+        param_commit(&reg);
+    }
+    sink_u = (uint32_t)bytes + (uint32_t)gain;
+}
+
+static void bench_log_enqueue(uint32_t iters)
+{
+    Log_Init();
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        if ((i & 63u) == 0u) Log_Init(); /* host UART never drains */
+        Log(LOG_LEVEL_INFO, "ctrl,%lu,%u\n", (unsigned long)i, (unsigned)(i & 255u));
+    }
+}
+
+/* Stand-in for DWT->CYCCNT: 10 ms at 180 MHz per read, wrapping */
+static uint32_t bench_cycles;
+static uint32_t bench_clock(void) { return bench_cycles += 1800000u; }
+
+/* log_enqueue with a time stamp on every line */
+static void bench_log_stamped(uint32_t iters)
+{
+    Log_Init();
+    Log_SetClock(bench_clock, 180000000u);
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        if ((i & 63u) == 0u) Log_Init();
+        Log(LOG_LEVEL_INFO, "ctrl,%lu,%u\n", (unsigned long)i, (unsigned)(i & 255u));
+    }
+    Log_SetClock(NULL, 0u);
+}
+
+static void bench_log_telemetry(uint32_t iters)
+{
+    Log_Init();
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        if ((i & 63u) == 0u) Log_Init();
+        Log_Telemetry((uint8_t)(i % 101u), (uint8_t)((i >> 3) % 101u));
+    }
+}
+
+static void bench_looptime(uint32_t iters)
+{
+    looptime_t lt;
+    looptime_init(&lt, 1800000u, 360000u);
+    uint32_t t = 0;
+    for (uint32_t i = 0; i < iters; i++)
+    {
+        looptime_begin(&lt, t);
+        looptime_mark(&lt, LOOPTIME_SENSE,   t + 100u);
+        looptime_mark(&lt, LOOPTIME_COMPUTE, t + 180u);
+        looptime_mark(&lt, LOOPTIME_ACTUATE, t + 260u);
+        t += 1800000u + (i & 255u);
+    }
+    sink_u = lt.iterations;
+}
+
+typedef struct
+{
+    const char *name;
+    void      (*fn)(uint32_t iters);
+} bench_case_t;
+
+static const bench_case_t cases[] = {
+    { "reference",        bench_reference        },
+    { "pid_compute",      bench_pid_compute      },
+    { "pid_compute_dt",   bench_pid_compute_dt   },
+    { "pid_backcalc",     bench_pid_backcalc     },
+    { "pid_velocity",     bench_pid_velocity     },
+    { "pid_scheduled",    bench_pid_scheduled    },
+    { "gainsched_lookup", bench_gainsched_lookup },
+    { "rls_update",       bench_rls_update       },
+    { "freqresp_rfft",    bench_freqresp_rfft    },
+    { "kalman_update",    bench_kalman_update    },
+    { "kalman_steady",    bench_kalman_steady    },
+    { "kalman_q16",       bench_kalman_q16       },
+    { "mpc_compute",      bench_mpc_compute      },
+    { "waveform_refill",  bench_waveform_refill  },
+    { "slew_step",        bench_slew_step        },
+    { "photocell_read",   bench_photocell_read   },
+    { "led_pwm_period",   bench_led_pwm_period   },
+    { "led_pwm_curve",    bench_led_pwm_curve    },
+    { "capture_record",   bench_capture_record   },
+    { "telemetry_encode", bench_telemetry_encode },
+    { "onchange_update",  bench_onchange_update  },
+    { "param_set",        bench_param_set        },
+    { "log_enqueue",      bench_log_enqueue      },
+    { "log_stamped",      bench_log_stamped      },
+    { "log_telemetry",    bench_log_telemetry    },
+    { "looptime_update",  bench_looptime         },
+};
+
+#define NUM_CASES (sizeof(cases) / sizeof(cases[0]))
+
+/* ------------------------------------------------------------------ */
+/* Measurement                                                        */
+/* ------------------------------------------------------------------ */
+
+typedef struct
+{
+    const char *name;
+    double ns_per_op;
+    double instr_per_op;     /* < 0 when unavailable */
+    double misses_per_op;    /* < 0 when unavailable */
+} bench_result_t;
+
+static void run_case(const bench_case_t *c, bench_result_t *r)
+{
+    /* Calibrate the iteration count to roughly BENCH_TARGET_NS */
+    uint32_t iters = 1000u;
+    for (;;)
+    {
+        double t0 = bench_now_ns();
+        c->fn(iters);
+        double dt = bench_now_ns() - t0;
+        if (dt > BENCH_TARGET_NS / 8.0 || iters >= (1u << 28)) break;
+        iters *= 2u;
+    }
+    {
+        double t0 = bench_now_ns();
+        c->fn(iters);
+        double dt = bench_now_ns() - t0;
+        double scale = BENCH_TARGET_NS / (dt > 1.0 ? dt : 1.0);
+        if (scale > 1.0 && iters * scale < (double)(1u << 30)) iters = (uint32_t)(iters * scale);
+    }
+
+    double best = 1e300;
+    for (int rep = 0; rep < BENCH_REPEATS; rep++)
+    {
+        double t0 = bench_now_ns();
+        c->fn(iters);
+        double ns = (bench_now_ns() - t0) / (double)iters;
+        if (ns < best) best = ns;
+    }
+
+    r->name          = c->name;
+    r->ns_per_op     = best;
+    r->instr_per_op  = -1.0;
+    r->misses_per_op = -1.0;
+
+    bench_perf_t perf;
+    int64_t instr, misses;
+    bench_perf_start(&perf);
+    c->fn(iters);
+    bench_perf_stop(&perf, &instr, &misses);
+    if (instr >= 0)  r->instr_per_op  = (double)instr / (double)iters;
+    if (misses >= 0) r->misses_per_op = (double)misses / (double)iters;
+}
+
+/* ------------------------------------------------------------------ */
+/* JSON I/O                                                           */
+/* ------------------------------------------------------------------ */
+
+static void write_json(FILE *f, const bench_result_t *res, size_t n)
+{
+    fprintf(f, "[\n");
+    for (size_t i = 0; i < n; i++)
+    {
+        fprintf(f, "  {\"name\": \"%s\", \"ns_per_op\": %.4f, "
+                   "\"instructions_per_op\": %.2f, \"cache_misses_per_op\": %.4f}%s\n",
+                res[i].name, res[i].ns_per_op, res[i].instr_per_op,
+                res[i].misses_per_op, (i + 1 < n) ? "," : "");
+    }
+    fprintf(f, "]\n");
+}
+
+/* Reads the line-per-case format produced by write_json() */
+static size_t read_json(const char *path, bench_result_t *res, char names[][48], size_t max)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+
+    char line[512];
+    size_t n = 0;
+    while (n < max && fgets(line, sizeof(line), f))
+    {
+        bench_result_t r;
+        if (sscanf(line, " {\"name\": \"%47[^\"]\", \"ns_per_op\": %lf, "
+                         "\"instructions_per_op\": %lf, \"cache_misses_per_op\": %lf",
+                   names[n], &r.ns_per_op, &r.instr_per_op, &r.misses_per_op) == 4)
+        {
+            r.name = names[n];
+            res[n++] = r;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+static const bench_result_t *find(const bench_result_t *res, size_t n, const char *name)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (strcmp(res[i].name, name) == 0) return &res[i];
+    }
+    return NULL;
+}
+
+static int check(const bench_result_t *cur, size_t n, const char *path, double threshold)
+{
+    static char names[BENCH_MAX_CASES][48];
+    bench_result_t base[BENCH_MAX_CASES];
+    size_t nb = read_json(path, base, names, BENCH_MAX_CASES);
+    if (nb == 0)
+    {
+        fprintf(stderr, "bench: cannot read baseline %s\n", path);
+        return 1;
+    }
+
+    const bench_result_t *ref_cur  = find(cur, n, "reference");
+    const bench_result_t *ref_base = find(base, nb, "reference");
+    if (!ref_cur || !ref_base)
+    {
+        fprintf(stderr, "bench: reference case missing\n");
+        return 1;
+    }
+
+    int failures = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (strcmp(cur[i].name, "reference") == 0) continue;
+        const bench_result_t *b = find(base, nb, cur[i].name);
+        if (!b)
+        {
+            printf("%-18s new case, no baseline\n", cur[i].name);
+            continue;
+        }
+
+        double ratio;
+        const char *metric;
+        if (cur[i].instr_per_op > 0.0 && b->instr_per_op > 0.0)
+        {
+            ratio  = cur[i].instr_per_op / b->instr_per_op;
+            metric = "instr";
+        }
+        else
+        {
+            ratio  = (cur[i].ns_per_op / ref_cur->ns_per_op) /
+                     (b->ns_per_op / ref_base->ns_per_op);
+            metric = "norm-ns";
+        }
+
+        int bad = ratio > threshold;
+        failures += bad;
+        printf("%-18s %-7s x%.2f %s\n", cur[i].name, metric, ratio, bad ? "REGRESSION" : "ok");
+    }
+    return failures ? 1 : 0;
+}
+
+/* ------------------------------------------------------------------ */
+
+int main(int argc, char **argv)
+{
+    const char *json_path  = NULL;
+    const char *check_path = NULL;
+    double      threshold  = 2.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)            json_path  = argv[++i];
+        else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc)      check_path = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)  sscanf(argv[++i], "%lf", &threshold);
+        else
+        {
+            fprintf(stderr, "usage: %s [--json out] [--check baseline] [--threshold x]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Log_SetLevel(LOG_LEVEL_INFO);
+
+    bench_result_t res[NUM_CASES];
+    for (size_t i = 0; i < NUM_CASES; i++)
+    {
+        run_case(&cases[i], &res[i]);
+        printf("%-18s %9.2f ns/op  %9.1f instr/op  %7.3f miss/op\n",
+               res[i].name, res[i].ns_per_op, res[i].instr_per_op, res[i].misses_per_op);
+    }
+
+    if (json_path)
+    {
+        FILE *f = fopen(json_path, "w");
+        if (!f)
+        {
+            perror(json_path);
+            return 1;
+        }
+        write_json(f, res, NUM_CASES);
+        fclose(f);
+    }
+
+    return check_path ? check(res, NUM_CASES, check_path, threshold) : 0;
+}
@@ -0,0 +1,108 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include "../03-pi-control/Core/Inc/gainsched.h"
+#include "../03-pi-control/Core/Inc/gain_schedule_table.h"
+#include "led_plant.h"
+
+#define PLANT_TS  0.01f     /* 10 ms loop, as in 02 */
+#define STEP      5.0f      /* evaluation step used by the generator */
+
+static int close_to(float a, float b) {
+    return fabsf(a - b) <= 1e-5f * (1.0f + fabsf(b));
+}
+
+/* ITAE of a STEP % setpoint step into `setpoint` on the logarithmic plant.
+ * With sched == NULL the controller keeps the gains it was given.  The
+ * duty is applied one tick late, as on the target (and in the generator). */
+static float step_itae(gainsched_t *sched, float kp, float ki, float setpoint) {
+    pid_t pid;
+    led_plant_t plant;
+    pid_init(&pid, kp, ki, setpoint - STEP, 0.0f, 100.0f);
+    pid_set_sample_time(&pid, PLANT_TS, PID_DISC_BACKWARD);
+    led_plant_init(&plant);
+
+    float applied = 0.0f, cost = 0.0f;
+    for (int k = 0; k < 400; k++) {                  /* settle at the start point */
+        if (sched) gainsched_apply(sched, &pid, pid.setpoint);
+        float u = pid_compute(&pid, plant.y);
+        led_plant_log_step(&plant, applied, PLANT_TS);
+        applied = u;
+    }
+
+    pid.setpoint = setpoint;
+    for (int k = 0; k < 100; k++) {
+        if (sched) gainsched_apply(sched, &pid, pid.setpoint);
+        float u = pid_compute(&pid, plant.y);
+        led_plant_log_step(&plant, applied, PLANT_TS);
+        applied = u;
+        cost += (float)k * PLANT_TS * fabsf(setpoint - plant.y) * PLANT_TS;
+    }
+    return cost;
+}
+
+int main(void) {
+    static const float table[4][3] = {
+        { 1.0f, 10.0f, 0.00f },
+        { 2.0f, 30.0f, 0.01f },
+        { 4.0f, 20.0f, 0.02f },
+        { 8.0f, 40.0f, 0.00f },
+    };
+    gainsched_t s;
+    float g[3];
+    gainsched_init(&s, 10.0f, 5.0f, 4u, table);
+
+    // Exact at breakpoints, including the last one
+    for (uint32_t i = 0; i < 4u; i++) {
+        gainsched_lookup(&s, 10.0f + 5.0f * (float)i, g);
+        assert(close_to(g[0], table[i][0]) && close_to(g[1], table[i][1]) &&
+               close_to(g[2], table[i][2]));
+    }
+
+    // Linear between breakpoints
+    gainsched_lookup(&s, 12.5f, g);
+    assert(close_to(g[0], 1.5f) && close_to(g[1], 20.0f) && close_to(g[2], 0.005f));
+    gainsched_lookup(&s, 21.0f, g);                       /* 20 % of row 2 → 3 */
+    assert(close_to(g[0], 4.8f) && close_to(g[1], 24.0f) && close_to(g[2], 0.016f));
+
+    // Clamped to the end rows outside the grid
+    gainsched_lookup(&s, -100.0f, g);
+    assert(close_to(g[0], 1.0f) && close_to(g[1], 10.0f));
+    gainsched_lookup(&s, 1e6f, g);
+    assert(close_to(g[0], 8.0f) && close_to(g[1], 40.0f));
+
+    // Apply retunes only when the operating point moves, and bumplessly
+    {
+        pid_t pid;
+        pid_init(&pid, 1.0f, 10.0f, 50.0f, 0.0f, 100.0f);
+        pid_set_sample_time(&pid, PLANT_TS, PID_DISC_BACKWARD);
+        for (int k = 0; k < 20; k++) pid_compute(&pid, 40.0f);
+        assert(gainsched_apply(&s, &pid, 17.0f));
+        assert(!gainsched_apply(&s, &pid, 17.0f));
+        assert(close_to(pid.Kp, 2.8f) && close_to(pid.Ki, 26.0f));
+        float u_prev = pid.out;
+        float u = pid_compute(&pid, 40.0f);                /* same error as before */
+        assert(fabsf(u - (u_prev + pid.Ki * PLANT_TS * 10.0f)) < 1e-3f);
+        assert(gainsched_apply(&s, &pid, 18.0f));
+    }
+
+    // Closed loop on the logarithmic plant: the generated schedule beats a
+    // fixed tuning taken from the middle of the table at both ends
+    gainsched_t sched;
+    gainsched_init(&sched, GAIN_SCHEDULE_X0, GAIN_SCHEDULE_DX,
+                   GAIN_SCHEDULE_POINTS, gain_schedule_table);
+    const float *mid = gain_schedule_table[GAIN_SCHEDULE_POINTS / 2u];
+    const float setpoints[] = { 15.0f, 50.0f, 80.0f };
+    float worst_sched = 0.0f, worst_fixed = 0.0f;
+    for (unsigned i = 0; i < sizeof(setpoints) / sizeof(setpoints[0]); i++) {
+        float c_sched = step_itae(&sched, 1.0f, 1.0f, setpoints[i]);
+        float c_fixed = step_itae(NULL, mid[0], mid[1], setpoints[i]);
+        printf("setpoint %4.1f: ITAE scheduled %.5f, fixed %.5f\n",
+               setpoints[i], c_sched, c_fixed);
+        worst_sched = fmaxf(worst_sched, c_sched);
+        worst_fixed = fmaxf(worst_fixed, c_fixed);
+    }
+    assert(worst_sched < 0.7f * worst_fixed);
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "../03-pi-control/Core/Inc/kalman.h"
+#include "led_plant.h"
+
+#define PLANT_TS   0.01f    /* 10 ms loop, as in 02 */
+#define NOISE      3.0f     /* uniform ADC noise ±3 % → variance 3 */
+#define MA_LEN     8        /* moving average the filter is compared with */
+
+#define KF_TAU1    0.045f   /* between the CdS rise and decay constants */
+#define KF_Q_RATE  5.0e5f   /* covers the rise/decay asymmetry of the model */
+
+/* Deterministic noise in [-a, a] */
+static float noise(uint32_t *state, float a) {
+    *state = *state * 1664525u + 1013904223u;
+    return a * ((float)(*state >> 8) / 8388608.0f - 1.0f);
+}
+
+static void init_led(kalman_t *kf) {
+    kalman_init_led(kf, PLANT_TS, KF_TAU1, LED_PLANT_TAU_ADC, LED_PLANT_GAIN,
+                    LED_PLANT_AMBIENT, KF_Q_RATE, NOISE * NOISE / 3.0f);
+}
+
+int main(void) {
+    kalman_t kf, kss;
+
+    // Discretised model: one step matches a fine integration of the
+    // second-order system, and the fixed point is [gain·u + ambient, 0]
+    {
+        init_led(&kf);
+        const float t1 = KF_TAU1, t2 = LED_PLANT_TAU_ADC, u = 60.0f;
+        float y = 10.0f, v = 200.0f;
+        for (int i = 0; i < 10000; i++) {
+            float acc = (LED_PLANT_GAIN * u + LED_PLANT_AMBIENT - y - (t1 + t2) * v) / (t1 * t2);
+            y += v * (PLANT_TS / 10000.0f);
+            v += acc * (PLANT_TS / 10000.0f);
+        }
+        float y1 = kf.A[0] * 10.0f + kf.A[1] * 200.0f + kf.B[0] * u + kf.c[0];
+        float v1 = kf.A[2] * 10.0f + kf.A[3] * 200.0f + kf.B[1] * u + kf.c[1];
+        assert(fabsf(y1 - y) < 0.01f && fabsf(v1 - v) < 0.5f);
+
+        float ys = LED_PLANT_GAIN * u + LED_PLANT_AMBIENT;
+        assert(fabsf(kf.A[0] * ys + kf.B[0] * u + kf.c[0] - ys) < 1e-3f);
+        assert(fabsf(kf.A[2] * ys + kf.B[1] * u + kf.c[1]) < 1e-2f);
+    }
+
+    // The time-varying gain converges to the steady-state one
+    {
+        init_led(&kf);
+        init_led(&kss);
+        uint32_t it = kalman_make_steady(&kss, 1000u);
+        assert(it < 1000u && kss.steady);
+        for (int k = 0; k < 500; k++) kalman_update(&kf, 50.0f, 45.0f);
+        assert(fabsf(kf.K[0] - kss.K[0]) < 1e-4f && fabsf(kf.K[1] - kss.K[1]) < 1e-2f);
+        printf("steady gain after %u iterations: K = [%.4f, %.3f]\n", it, kss.K[0], kss.K[1]);
+    }
+
+    // Noisy readings of the LED plant under duty steps: the filter beats a
+    // moving average on error and lag, the Q16 variant tracks the float one
+    {
+        led_plant_t plant;
+        led_plant_init(&plant);
+        init_led(&kf);
+        init_led(&kss);
+        kalman_make_steady(&kss, 1000u);
+        kalman_reset(&kf, plant.y);
+        kalman_reset(&kss, plant.y);
+
+        float ma_buf[MA_LEN], ma_sum = 0.0f;
+        for (int i = 0; i < MA_LEN; i++) { ma_buf[i] = plant.y; ma_sum += plant.y; }
+
+        uint32_t rng = 9u;
+        double se_raw = 0, se_ma = 0, se_kf = 0, se_ss = 0, settled_kf = 0;
+        uint32_t settled_n = 0;
+        float worst_q16 = 0.0f;
+        float u = 20.0f;
+        for (int k = 0; k < 2000; k++) {
+            if (k % 50 == 0) u = (k / 50) % 2 ? 80.0f : 20.0f;
+            led_plant_step(&plant, u, PLANT_TS);
+            float z = plant.y + noise(&rng, NOISE);
+
+            ma_sum += z - ma_buf[k % MA_LEN];
+            ma_buf[k % MA_LEN] = z;
+            float y_ma = ma_sum / MA_LEN;
+            float y_kf = kalman_update(&kf, u, z);
+            float y_ss = kalman_update(&kss, u, z);
+            int32_t y_q = kalman_update_q16(&kss, (int32_t)lrintf(u * KALMAN_Q16_ONE),
+                                            (int32_t)lrintf(z * KALMAN_Q16_ONE));
+
+            if (k >= 100) {
+                se_raw += (z - plant.y) * (z - plant.y);
+                se_ma  += (y_ma - plant.y) * (y_ma - plant.y);
+                se_kf  += (y_kf - plant.y) * (y_kf - plant.y);
+                se_ss  += (y_ss - plant.y) * (y_ss - plant.y);
+                if (k % 50 >= 25) {
+                    settled_n++;
+                    settled_kf  += (y_kf - plant.y) * (y_kf - plant.y);
+                }
+                worst_q16 = fmaxf(worst_q16, fabsf((float)y_q / KALMAN_Q16_ONE - y_ss));
+            }
+        }
+        float n = 1900.0f;
+        float rms_raw = sqrtf(se_raw / n), rms_ma = sqrtf(se_ma / n);
+        float rms_kf = sqrtf(se_kf / n), rms_ss = sqrtf(se_ss / n);
+        float rms_settled = sqrtf(settled_kf / settled_n);
+        printf("rms error: raw %.3f, moving average(%d) %.3f, kalman %.3f (settled %.3f), "
+               "steady %.3f; q16 vs float %.4f\n", rms_raw, MA_LEN, rms_ma, rms_kf,
+               rms_settled, rms_ss, worst_q16);
+        assert(rms_kf < 0.7f * rms_raw);            /* including the step transients  */
+        assert(rms_kf < 0.3f * rms_ma);             /* the average lags every step    */
+        assert(rms_settled < 0.6f * rms_raw);       /* noise between the steps        */
+        assert(fabsf(rms_ss - rms_kf) < 0.05f * rms_kf);
+        assert(worst_q16 < 0.05f);
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file    led_plant.h
+ * @brief   Host model of the LED → CdS photoresistor → ADC loop.
+ *
+ * Shared by the controller tests.  The LED's light output follows the
+ * PWM duty with no lag.  The CdS cell reacts slowly, and faster to rising
+ * light than to falling light (the datasheet's rise/decay times).  The
+ * divider voltage then passes the RC anti-alias filter in front of the
+ * ADC, a second, symmetric lag.  The sensor reading is expressed as
+ * 0–100 % of full scale, like the firmware's scaled photocell value.
+ *
+ *     led_plant_t plant;
+ *     led_plant_init(&plant);
+ *     for (…) { float y = plant.y; u = controller(y); led_plant_step(&plant, u, 0.01f); }
+ *
+ * led_plant_log_step() replaces the linear light → reading map with the
+ * CdS cell's logarithmic one: the static gain is about 15× higher near
+ * the dark end than at full duty.  Tools/gen_gain_schedule.py in 03 tunes
+ * its table on the same model; keep the constants in sync.
+ */
+
+#ifndef LED_PLANT_H
+#define LED_PLANT_H
+
+#include <math.h>
+
+#define LED_PLANT_GAIN       0.80f    /**< % reading per % duty            */
+#define LED_PLANT_AMBIENT    5.0f     /**< Reading with the LED off (%)    */
+#define LED_PLANT_TAU_RISE   0.030f   /**< CdS rise time constant (s)      */
+#define LED_PLANT_TAU_FALL   0.060f   /**< CdS decay time constant (s)     */
+#define LED_PLANT_TAU_ADC    0.020f   /**< ADC input RC filter (s)         */
+#define LED_PLANT_LOG_U0     5.0f     /**< Duty where the log curve bends  */
+#define LED_PLANT_LOG_SPAN   85.0f    /**< Reading span LED off → 100 %    */
+
+typedef struct
+{
+    float cds;      /**< CdS cell response (%)         */
+    float y;        /**< Current sensor reading (%)    */
+} led_plant_t;
+
+static inline void led_plant_init(led_plant_t *p)
+{
+    p->cds = LED_PLANT_AMBIENT;
+    p->y   = LED_PLANT_AMBIENT;
+}
+
+/** Advance the model by dt seconds with PWM duty u (%, clipped to 0–100). */
+static inline float led_plant_step(led_plant_t *p, float u, float dt)
+{
+    if (u < 0.0f)   u = 0.0f;
+    if (u > 100.0f) u = 100.0f;
+    float target = LED_PLANT_AMBIENT + LED_PLANT_GAIN * u;
+    float tau    = (target > p->cds) ? LED_PLANT_TAU_RISE : LED_PLANT_TAU_FALL;
+    p->cds = target + (p->cds - target) * expf(-dt / tau);
+    p->y   = p->cds + (p->y - p->cds) * expf(-dt / LED_PLANT_TAU_ADC);
+    return p->y;
+}
+
+/** Steady-state reading of the logarithmic model at duty u (%). */
+static inline float led_plant_log_reading(float u)
+{
+    if (u < 0.0f)   u = 0.0f;
+    if (u > 100.0f) u = 100.0f;
+    return LED_PLANT_AMBIENT + LED_PLANT_LOG_SPAN * log1pf(u / LED_PLANT_LOG_U0)
+                                                  / log1pf(100.0f / LED_PLANT_LOG_U0);
+}
+
+/** As led_plant_step(), with the logarithmic CdS characteristic. */
+static inline float led_plant_log_step(led_plant_t *p, float u, float dt)
+{
+    float target = led_plant_log_reading(u);
+    float tau    = (target > p->cds) ? LED_PLANT_TAU_RISE : LED_PLANT_TAU_FALL;
+    p->cds = target + (p->cds - target) * expf(-dt / tau);
+    p->y   = p->cds + (p->y - p->cds) * expf(-dt / LED_PLANT_TAU_ADC);
+    return p->y;
+}
+
+#endif /* LED_PLANT_H */
@@ -0,0 +1,178 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include "led_pwm.h"
+#include "led_gamma_table.h"
+#include "../02-proportional-control/Core/Inc/pid.h"
+#include "led_plant.h"
+
+#define CONTROL_TS    0.01f     /* 10 ms loop, as in 02 */
+#define PWM_PERIODS   100       /* 10 kHz PWM (TIM2: 1 MHz / 100) per tick */
+#define ADC_LSB       (100.0f / 4095.0f)
+
+typedef enum { ACT_UINT8, ACT_DITHER } actuator_t;
+
+typedef struct
+{
+    float mean;     /* mean reading over the last half   */
+    float pp;       /* peak-to-peak over the last half   */
+} settle_t;
+
+static TIM_TypeDef       tim2;
+static TIM_HandleTypeDef htim2 = { .Instance = &tim2, .Init = { .Period = 100u - 1u } };
+
+/* One 10 ms tick of the plant at PWM-period resolution */
+static void run_periods(LedPwm_t *led, led_plant_t *plant) {
+    for (int n = 0; n < PWM_PERIODS; n++) {
+        if (led->dither) LedPwm_periodElapsed(led);
+        float duty = 100.0f * (float)tim2.CCR2 / (float)(htim2.Init.Period + 1u);
+        led_plant_step(plant, duty, CONTROL_TS / PWM_PERIODS);
+    }
+}
+
+/* Exact duty (%) behind the compare value, before dithering */
+static float duty_of(const LedPwm_t *led) {
+    return 100.0f * (float)led->compare_q16 / 65536.0f / (float)(htim2.Init.Period + 1u);
+}
+
+/* Ratio of the largest to the smallest steady-reading step of the log
+ * CdS model over 20 equal command steps */
+static float step_spread(LedPwm_t *led) {
+    float lo = INFINITY, hi = 0.0f;
+    LedPwm_setDutyFloat(led, 0.0f);
+    float prev = led_plant_log_reading(duty_of(led));
+    for (int c = 5; c <= 100; c += 5) {
+        LedPwm_setDutyFloat(led, (float)c);
+        float y = led_plant_log_reading(duty_of(led));
+        lo = fminf(lo, y - prev);
+        hi = fmaxf(hi, y - prev);
+        prev = y;
+    }
+    return hi / lo;
+}
+
+static void apply(LedPwm_t *led, actuator_t act, float u) {
+    if (act == ACT_UINT8) LedPwm_setDuty(led, (uint8_t)u);   /* as main.c did */
+    else                  LedPwm_setDutyFloat(led, u);
+}
+
+/* Integral controller (Ki in 1/s) or 02's proportional one, 4 s run */
+static settle_t run_loop(actuator_t act, float setpoint, float kp, float ki) {
+    LedPwm_t led;
+    led_plant_t plant;
+    pid_t p;
+    LedPwm_init(&led, &htim2, TIM_CHANNEL_2);
+    LedPwm_setDither(&led, act == ACT_DITHER);
+    led_plant_init(&plant);
+    pid_init(&p, kp, setpoint, 0.0f, 100.0f);
+
+    float integral = 0.0f, lo = INFINITY, hi = -INFINITY;
+    double sum = 0.0;
+    int n = 0;
+    for (int k = 0; k < 400; k++) {
+        float y = roundf(plant.y / ADC_LSB) * ADC_LSB;          /* 12-bit ADC */
+        float u = PID_COMPUTE(&p, y);
+        if (ki > 0.0f) {
+            integral = fminf(fmaxf(integral + ki * CONTROL_TS * (setpoint - y), 0.0f), 100.0f);
+            u = fminf(fmaxf(u + integral, 0.0f), 100.0f);
+        }
+        apply(&led, act, u);
+        run_periods(&led, &plant);
+        if (k >= 200) {
+            lo = fminf(lo, y);
+            hi = fmaxf(hi, y);
+            sum += y;
+            n++;
+        }
+    }
+    settle_t s = { (float)(sum / n), hi - lo };
+    return s;
+}
+
+int main(void) {
+    // Dithered compare values average to the requested fraction of a count
+    {
+        LedPwm_t led;
+        LedPwm_init(&led, &htim2, TIM_CHANNEL_2);
+        LedPwm_setDither(&led, true);
+        assert(tim2.DIER & TIM_IT_UPDATE);
+        for (float d = 0.0f; d <= 100.0f; d += 3.7f) {
+            LedPwm_setDutyFloat(&led, d);
+            uint32_t total = 0;
+            for (int i = 0; i < 1000; i++) {
+                LedPwm_periodElapsed(&led);
+                assert(fabsf((float)tim2.CCR2 - d) < 1.001f);    /* neighbouring counts */
+                total += tim2.CCR2;
+            }
+            assert(fabsf((float)total / 1000.0f - d) < 0.01f);
+        }
+        LedPwm_setDutyQ16(&led, LED_PWM_Q16_ONE);
+        LedPwm_periodElapsed(&led);
+        assert(tim2.CCR2 == 100u);                       /* always on */
+
+        LedPwm_setDither(&led, false);                   /* rounds to the nearest count */
+        assert(!(tim2.DIER & TIM_IT_UPDATE));
+        LedPwm_setDutyFloat(&led, 42.6f);
+        assert(tim2.CCR2 == 43u);
+    }
+
+    // Integral action with 1 % duty steps hunts between two levels;
+    // dithering leaves only ADC quantisation
+    {
+        const float sp = 47.3f;                          /* needs u = 52.875 % */
+        settle_t q = run_loop(ACT_UINT8, sp, 0.5f, 10.0f);
+        settle_t d = run_loop(ACT_DITHER, sp, 0.5f, 10.0f);
+        printf("PI, setpoint %.1f: uint8 duty p-p %.3f %% mean %.3f; "
+               "dithered p-p %.3f %% mean %.3f\n", sp, q.pp, q.mean, d.pp, d.mean);
+        fflush(stdout);
+        assert(q.pp > 4.0f * ADC_LSB);                   /* the limit cycle exists */
+        assert(d.pp < 0.25f * q.pp);
+        assert(fabsf(d.mean - sp) < 2.0f * ADC_LSB);
+    }
+
+    // 02's proportional loop: no limit cycle, but truncation biases the level
+    {
+        const float kp = 1.2f, sp = 60.0f;
+        const float ideal = (LED_PLANT_AMBIENT + LED_PLANT_GAIN * kp * sp)
+                          / (1.0f + LED_PLANT_GAIN * kp);
+        settle_t q = run_loop(ACT_UINT8, sp, kp, 0.0f);
+        settle_t d = run_loop(ACT_DITHER, sp, kp, 0.0f);
+        printf("P, setpoint %.1f: ideal %.3f, uint8 %.3f, dithered %.3f\n",
+               sp, ideal, q.mean, d.mean);
+        assert(fabsf(d.mean - ideal) < 0.5f * fabsf(q.mean - ideal));
+    }
+
+    // The generated curve equalises the reading steps of the log CdS model
+    {
+        LedPwm_t led;
+        LedPwm_init(&led, &htim2, TIM_CHANNEL_2);
+        float raw = step_spread(&led);
+        LedPwm_setCurve(&led, led_gamma_table);
+        float lin = step_spread(&led);
+        printf("reading step max/min over 5 %% commands: raw %.2f, linearised %.3f\n", raw, lin);
+        assert(raw > 10.0f);
+        assert(lin < 1.05f);
+
+        for (uint32_t i = 1; i <= LED_GAMMA_SEGMENTS; i++)
+            assert(led_gamma_table[i] >= led_gamma_table[i - 1]);
+        LedPwm_setDutyFloat(&led, 0.0f);
+        assert(led.compare_q16 == 0u);
+        LedPwm_setDutyFloat(&led, 100.0f);
+        assert(duty_of(&led) == 100.0f);
+
+        // Between breakpoints the model is followed to a fraction of a step
+        float worst = 0.0f;
+        for (float c = 0.0f; c <= 100.0f; c += 0.37f) {
+            LedPwm_setDutyFloat(&led, c);
+            float ideal = LED_PLANT_AMBIENT + LED_PLANT_LOG_SPAN * c / 100.0f;
+            worst = fmaxf(worst, fabsf(led_plant_log_reading(duty_of(&led)) - ideal));
+        }
+        printf("linearised reading error: %.3f %%\n", worst);
+        assert(worst < 0.25f);
+
+        LedPwm_setDuty(&led, 50);                        /* uint8 path uses it too */
+        assert(fabsf(led_plant_log_reading(duty_of(&led)) - 47.5f) < 0.25f);
+    }
+
+    return 0;
+}
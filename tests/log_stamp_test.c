@@ -0,0 +1,151 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "../02-proportional-control/Core/Inc/logger.h"
+
+#define CORE_HZ 180000000u
+
+static char   out[4096];                /* what reached the UART hook */
+static size_t out_len;
+
+/* Replaces the ring buffer output, so the records can be read back */
+void Log_Write_UART(const char* msg)
+{
+    size_t n = strlen(msg);
+    assert(out_len + n < sizeof out);
+    memcpy(&out[out_len], msg, n + 1u);
+    out_len += n;
+}
+
+static void clear(void)
+{
+    out_len = 0u;
+    out[0] = '\0';
+}
+
+static uint32_t counter;
+static uint32_t read_counter(void) { return counter; }
+
+int main(void)
+{
+    Log_Init();
+    Log_SetLevel(LOG_LEVEL_DEBUG);
+
+    // Without a clock, messages are unchanged and no sync is sent
+    {
+        clear();
+        Log(LOG_LEVEL_INFO, "plain,%d\n", 1);
+        assert(strcmp(out, "plain,1\n") == 0);
+        assert(Log_Timestamp() == 0u);
+        assert(!Log_Sync());
+        assert(out_len == strlen("plain,1\n"));
+    }
+
+    // Stamp format: lower-case hex without leading zeros, all or nothing
+    {
+        char buf[LOG_STAMP_MAX];
+        assert(Log_FormatStamp(0u, buf, sizeof buf) == 3u && strcmp(buf, "@0:") == 0);
+        assert(Log_FormatStamp(0x1A2B3C4D5Eull, buf, sizeof buf) == 12u);
+        assert(strcmp(buf, "@1a2b3c4d5e:") == 0);
+        assert(Log_FormatStamp(UINT64_MAX, buf, sizeof buf) == LOG_STAMP_MAX - 1u);
+        assert(strcmp(buf, "@ffffffffffffffff:") == 0);
+        assert(Log_FormatStamp(UINT64_MAX, buf, LOG_STAMP_MAX - 1u) == 0u && buf[0] == '\0');
+        assert(Log_FormatStamp(0u, buf, 0u) == 0u);
+    }
+
+    // Each message carries the counter as it was on entry
+    {
+        counter = 0x1234u;
+        Log_SetClock(read_counter, CORE_HZ);
+        clear();
+        Log(LOG_LEVEL_INFO, "ctrl,%d\n", 7);
+        assert(strcmp(out, "@1234:ctrl,7\n") == 0);
+
+        clear();
+        Log(LOG_LEVEL_DEBUG, "level filter applies first\n");
+        Log_SetLevel(LOG_LEVEL_INFO);
+        Log(LOG_LEVEL_DEBUG, "dropped\n");
+        Log_SetLevel(LOG_LEVEL_DEBUG);
+        assert(strcmp(out, "@1234:level filter applies first\n") == 0);
+    }
+
+    // Wrap extension: a reading below the last one adds 2^32
+    {
+        counter = 0xFFFFFF00u;
+        Log_SetClock(read_counter, CORE_HZ);
+        assert(Log_Timestamp() == 0xFFFFFF00ull);
+        counter = 0x10u;
+        assert(Log_Timestamp() == 0x100000010ull);
+        assert(Log_Timestamp() == 0x100000010ull);          /* unchanged: no wrap */
+        counter = 0xFFFFFFFFu;
+        assert(Log_Timestamp() == 0x1FFFFFFFFull);
+        counter = 0u;
+        assert(Log_Timestamp() == 0x200000000ull);
+
+        /* A day at 100 Hz, the clock read once per tick: monotonic, exact */
+        uint64_t truth = 0x200000000ull, last = 0u;
+        for (uint32_t i = 0; i < 8640000u; i++) {
+            truth += 1800000u;
+            counter = (uint32_t)truth;
+            uint64_t t = Log_Timestamp();
+            assert(t == truth && t > last);
+            last = t;
+        }
+
+        clear();
+        Log(LOG_LEVEL_INFO, "x\n");
+        char expect[LOG_STAMP_MAX + 2];
+        snprintf(expect, sizeof expect, "@%llx:x\n", (unsigned long long)truth);
+        assert(strcmp(out, expect) == 0);
+
+        /* The stamp takes no room from the message: a full one keeps its '\n' */
+        char msg[LOG_BUFFER_SIZE];
+        memset(msg, 'm', sizeof msg - 2u);
+        msg[sizeof msg - 2u] = '\n';
+        msg[sizeof msg - 1u] = '\0';
+        clear();
+        Log(LOG_LEVEL_INFO, "%s", msg);
+        assert(strncmp(out, expect, strlen(expect) - 2u) == 0);
+        assert(strcmp(out + strlen(expect) - 2u, msg) == 0);
+    }
+
+    // Sync records go out only while nothing is queued ahead of them
+    {
+        counter = 0xABCDu;
+        Log_Init();
+        Log_SetClock(read_counter, CORE_HZ);
+        clear();
+        assert(Log_Sync());
+        assert(strcmp(out, "@abcd:sync,180000000\n") == 0);
+
+        /* The host UART never completes, so these bytes stay queued */
+        const uint8_t frame[] = { 0x00u, 0x02u, 0x11u, 0x00u };
+        assert(Log_WriteBytes(frame, sizeof frame));
+        clear();
+        counter = 0x10u;                                    /* wrapped */
+        assert(!Log_Sync());
+        assert(out_len == 0u);
+        assert(Log_Timestamp() == 0x100000010ull);          /* the wrap still counted */
+
+        Log_Init();                                         /* ring empty again */
+        assert(Log_Sync());
+        assert(strcmp(out, "@100000010:sync,180000000\n") == 0);
+
+        Log_Disable();
+        assert(!Log_Sync());
+        Log_Init();
+    }
+
+    // Clock removed: back to plain messages
+    {
+        Log_SetClock(NULL, 0u);
+        clear();
+        Log(LOG_LEVEL_INFO, "plain,%d\n", 2);
+        assert(strcmp(out, "plain,2\n") == 0);
+        assert(!Log_Sync());
+    }
+
+    printf("log stamps: format, wrap extension and sync records ok\n");
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <assert.h>
+#include <string.h>
+#include "../03-pi-control/Core/Inc/looptime.h"
+
+int main(void) {
+    looptime_t lt;
+
+    // Bucket boundaries: [2^(i-1), 2^i)
+    assert(looptime_bucket(0) == 0);
+    assert(looptime_bucket(1) == 1);
+    assert(looptime_bucket(2) == 2);
+    assert(looptime_bucket(3) == 2);
+    assert(looptime_bucket(4) == 3);
+    assert(looptime_bucket(0xFFFFFFFFu) == LOOPTIME_HIST_BUCKETS - 1);
+
+    // 1000-cycle period, 100-cycle deadline
+    looptime_init(&lt, 1000, 100);
+
+    uint32_t t = 0xFFFFFF00u;  // start close to CYCCNT wrap
+    uint32_t periods[] = { 1000, 1003, 990, 1200 };
+    uint32_t execs[]   = { 50, 150, 60, 70 };
+
+    for (int i = 0; i < 4; i++) {
+        looptime_begin(&lt, t);
+        looptime_mark(&lt, LOOPTIME_SENSE,   t + 10);
+        looptime_mark(&lt, LOOPTIME_COMPUTE, t + 10 + (execs[i] - 20));
+        looptime_mark(&lt, LOOPTIME_ACTUATE, t + execs[i]);
+        t += periods[i];
+    }
+    looptime_begin(&lt, t);  // closes the last period
+
+    assert(lt.iterations == 4);
+    assert(lt.overruns == 1);        // exec 150 > 100
+    assert(lt.late_periods == 1);    // 1200 > 1000 + 100
+    assert(lt.period_min == 990);
+    assert(lt.period_max == 1200);
+    assert(lt.exec_max == 150);
+    assert(lt.phase_max[LOOPTIME_SENSE] == 10);
+    assert(lt.phase_max[LOOPTIME_COMPUTE] == 130);
+    assert(lt.phase_max[LOOPTIME_ACTUATE] == 10);
+
+    // Jitters 0, 3, 10, 200 -> buckets 0, 2, 4, 8
+    assert(lt.hist[0] == 1);
+    assert(lt.hist[2] == 1);
+    assert(lt.hist[4] == 1);
+    assert(lt.hist[8] == 1);
+
+    char buf[256];
+    size_t n = looptime_format(&lt, buf, sizeof(buf));
+    assert(n == strlen(buf));
+    const char *head = "looptime,n=4,overrun=1,late=1,pmin=990,pmax=1200,exec=150,";
+    assert(strncmp(buf, head, strlen(head)) == 0);
+    assert(strstr(buf, "loophist,1,0,1,0,1,0,0,0,1\n") != NULL);
+
+    // Truncation never overruns the buffer
+    char small[16];
+    n = looptime_format(&lt, small, sizeof(small));
+    assert(n == sizeof(small) - 1 && small[n] == '\0');
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include "../03-pi-control/Core/Inc/mpc.h"
+#include "../03-pi-control/Core/Inc/mpc_table.h"
+#include "../03-pi-control/Core/Inc/kalman.h"
+#include "../03-pi-control/Core/Inc/pid.h"
+#include "led_plant.h"
+
+#define PLANT_TS  MPC_TABLE_TS
+
+/* PI tuned for this very sequence: min IAE with overshoot below 5 % of
+ * the step, on a 1.15× grid of Kp and Ki */
+#define PI_KP     7.66f
+#define PI_KI     204.0f
+
+typedef struct
+{
+    float iae;          /* Σ|r - y|·Ts                         */
+    float overshoot;    /* worst excursion past a setpoint (%) */
+    float u_lo, u_hi;   /* range of the commanded duty         */
+} response_t;
+
+/* 10 % → 80 % → 20 %: both steps drive the duty into a limit */
+static float setpoint_at(int k) {
+    return k < 50 ? 10.0f : k < 150 ? 80.0f : 20.0f;
+}
+
+static void score(response_t *r, int k, float y, float u) {
+    float sp = setpoint_at(k);
+    r->iae += fabsf(sp - y) * PLANT_TS;
+    if (k >= 50 && k < 150) r->overshoot = fmaxf(r->overshoot, y - sp);
+    if (k >= 150)           r->overshoot = fmaxf(r->overshoot, sp - y);
+    r->u_lo = fminf(r->u_lo, u);
+    r->u_hi = fmaxf(r->u_hi, u);
+}
+
+static response_t run_mpc(void) {
+    response_t r = { 0.0f, 0.0f, INFINITY, -INFINITY };
+    led_plant_t plant;
+    kalman_t kf;
+    mpc_t mpc;
+    led_plant_init(&plant);
+    kalman_init_led(&kf, PLANT_TS, 0.045f, 0.020f, 0.8f, 5.0f, 5.0e5f, 3.0f);
+    kalman_make_steady(&kf, 1000u);
+    kalman_reset(&kf, plant.y);
+    mpc_init(&mpc, mpc_table, MPC_TABLE_REGIONS, MPC_TABLE_U_MIN, MPC_TABLE_U_MAX);
+
+    float u = 0.0f;
+    for (int k = 0; k < 250; k++) {
+        kalman_update(&kf, u, plant.y);
+        u = mpc_compute(&mpc, kf.x[0], kf.x[1], setpoint_at(k));
+        led_plant_step(&plant, u, PLANT_TS);
+        score(&r, k, plant.y, u);
+    }
+    return r;
+}
+
+static response_t run_pi(void) {
+    response_t r = { 0.0f, 0.0f, INFINITY, -INFINITY };
+    led_plant_t plant;
+    pid_t pi;
+    led_plant_init(&plant);
+    pid_init(&pi, PI_KP, PI_KI, setpoint_at(0), MPC_TABLE_U_MIN, MPC_TABLE_U_MAX);
+    pid_set_sample_time(&pi, PLANT_TS, PID_DISC_BACKWARD);
+
+    for (int k = 0; k < 250; k++) {
+        pi.setpoint = setpoint_at(k);
+        float u = PID_COMPUTE(&pi, plant.y);
+        led_plant_step(&plant, u, PLANT_TS);
+        score(&r, k, plant.y, u);
+    }
+    return r;
+}
+
+/* Deterministic uniform sample in [lo, hi] */
+static float uniform(uint32_t *state, float lo, float hi) {
+    *state = *state * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(*state >> 8) / 16777216.0f;
+}
+
+int main(void) {
+    mpc_t mpc;
+    mpc_init(&mpc, mpc_table, MPC_TABLE_REGIONS, MPC_TABLE_U_MIN, MPC_TABLE_U_MAX);
+
+    // At rest on the setpoint the law holds the steady-state duty
+    for (float sp = 10.0f; sp <= 80.0f; sp += 10.0f) {
+        float u = mpc_compute(&mpc, sp, 0.0f, sp);
+        assert(fabsf(u - (sp - LED_PLANT_AMBIENT) / LED_PLANT_GAIN) < 0.05f);
+    }
+
+    // The law is continuous: a misassigned region would show as a jump
+    {
+        uint32_t rng = 5u;
+        float worst = 0.0f;
+        for (int i = 0; i < 20000; i++) {
+            float level = uniform(&rng, 0.0f, 100.0f);
+            float rate  = uniform(&rng, -1500.0f, 1500.0f);
+            float sp    = uniform(&rng, 5.0f, 85.0f);
+            float u0 = mpc_compute(&mpc, level, rate, sp);
+            float u1 = mpc_compute(&mpc, level + 0.01f, rate + 0.1f, sp + 0.01f);
+            assert(u0 >= MPC_TABLE_U_MIN && u0 <= MPC_TABLE_U_MAX);
+            worst = fmaxf(worst, fabsf(u1 - u0));
+        }
+        printf("largest change for a small parameter step: %.3f %%\n", worst);
+        assert(worst < 0.5f);
+    }
+
+    // Constrained steps on the LED plant: MPC respects the limits without
+    // clamping and beats a PI with clamping anti-windup
+    {
+        response_t m = run_mpc(), p = run_pi();
+        printf("mpc: IAE %.3f, overshoot %.2f %%, duty %.1f..%.1f\n",
+               m.iae, m.overshoot, m.u_lo, m.u_hi);
+        printf("pi:  IAE %.3f, overshoot %.2f %%, duty %.1f..%.1f\n",
+               p.iae, p.overshoot, p.u_lo, p.u_hi);
+        fflush(stdout);
+        assert(m.u_lo == MPC_TABLE_U_MIN && m.u_hi == MPC_TABLE_U_MAX);   /* limits used */
+        assert(m.iae < p.iae);
+        assert(m.overshoot < p.overshoot);
+    }
+
+    return 0;
+}
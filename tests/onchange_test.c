@@ -0,0 +1,175 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "../02-proportional-control/Core/Inc/onchange.h"
+#include "../02-proportional-control/Core/Inc/pid.h"
+#include "led_plant.h"
+
+#define CH      ONCHANGE_CHANNELS
+#define PERIOD  10u                     /* control period, ms */
+#define MAXS    6000u                   /* 60 s of samples    */
+
+/* The configuration main.c uses */
+static const onchange_channel_t cfg[CH] = { { 32, 1000u }, { 100, 1000u }, { 100, 1000u } };
+
+/* stdlib.h is left out: its pid_t clashes with the controller's */
+static int64_t field(const char **p)
+{
+    assert(**p == ',');
+    (*p)++;
+    int64_t sign = (**p == '-') ? ((*p)++, -1) : 1, v = 0;
+    while (**p >= '0' && **p <= '9') v = v * 10 + (*(*p)++ - '0');
+    return sign * v;
+}
+
+static int32_t iabs(int32_t v) { return v < 0 ? -v : v; }
+
+/* Parse one chg line into held[] (mirrors uart_plotter/onchange_rebuild.py) */
+static uint32_t apply_line(const char *line, int32_t *held, uint32_t *t)
+{
+    assert(strncmp(line, "chg", 3) == 0);
+    const char *p = line + 3;
+    *t = (uint32_t)field(&p);
+    uint32_t mask = (uint32_t)field(&p);
+    for (uint32_t ch = 0; ch < CH; ch++)
+        if (mask & (1u << ch)) held[ch] = (int32_t)field(&p);
+    assert(p[0] == '\n' && p[1] == '\0');
+    return mask;
+}
+
+static uint32_t lcg = 12345u;
+static uint32_t rnd(void) { return lcg = lcg * 1664525u + 1013904223u; }
+
+static int32_t samples[MAXS][CH];
+
+int main(void) {
+    // Deadband, heartbeat and force, one channel at a time
+    {
+        onchange_t o;
+        const onchange_channel_t c[CH] = { { 10, 100u }, { 0, 0u }, { 5, 50u } };
+        onchange_init(&o, c);
+        int32_t v[CH] = { 0, 0, 0 };
+        assert(onchange_update(&o, 0u, v) == 7u);          /* first: everything */
+        assert(onchange_update(&o, 10u, v) == 0u);
+        v[0] = 10;
+        assert(onchange_update(&o, 20u, v) == 0u);         /* at the deadband   */
+        v[0] = 11;
+        assert(onchange_update(&o, 30u, v) == 1u);
+        v[1] = 1;
+        assert(onchange_update(&o, 40u, v) == 2u);         /* deadband 0        */
+        assert(onchange_update(&o, 50u, v) == 4u);         /* ch2 heartbeat     */
+        for (uint32_t t = 60u; t < 130u; t += 10u) {
+            v[0] = 11 + (int32_t)(t - 60u) / 10;           /* drift 1 per sample */
+            uint32_t m = onchange_update(&o, t, v);
+            assert(m == ((t == 100u) ? 4u : 0u));
+        }
+        v[0] = 22;                                         /* 11 from 11: due   */
+        assert(onchange_update(&o, 130u, v) == 1u);
+        assert(onchange_update(&o, 230u, v) == 5u);        /* ch0 heartbeat too */
+        onchange_force(&o);
+        assert(onchange_update(&o, 240u, v) == 7u);
+        assert(onchange_update(&o, 250u, v) == 0u);        /* force is one-shot */
+        assert(o.samples == 17u && o.reports == 8u);
+    }
+
+    // The whole int32 range, clock wrap, and the line format
+    {
+        onchange_t o;
+        onchange_init(&o, cfg);
+        int32_t v[CH] = { INT32_MIN, INT32_MAX, -1 };
+        assert(onchange_update(&o, 0xFFFFFFF0u, v) == 7u);
+        v[0] = INT32_MAX;
+        v[1] = INT32_MIN;
+        assert(onchange_update(&o, 0xFFFFFFFAu, v) == 3u);
+        assert(onchange_update(&o, 0x10u, v) == 0u);       /* 32 ms after wrap  */
+        assert(onchange_update(&o, 0xFFFFFFF0u + 1000u, v) == 4u); /* ch2 heartbeat   */
+
+        char buf[ONCHANGE_LINE_MAX];
+        v[0] = INT32_MIN;
+        size_t n = onchange_format(0xFFFFFFFFu, 0xFFFFFFFFu >> (32u - CH), v, buf, sizeof buf);
+        assert(n == strlen(buf) && n + 1u <= sizeof buf);
+        assert(strcmp(buf, "chg,4294967295,7,-2147483648,-2147483648,-1\n") == 0);
+        assert(onchange_format(5u, 5u, v, buf, sizeof buf) > 0u);
+        assert(strcmp(buf, "chg,5,5,-2147483648,-1\n") == 0);
+        assert(onchange_format(5u, 0u, v, buf, sizeof buf) == 0u);
+        assert(onchange_format(5u, 5u, v, buf, 20u) == 0u);     /* too small */
+    }
+
+    // A recorded closed-loop run: 02's P controller on the LED model with
+    // ±0.3 % ADC noise and setpoint steps every 5 s; raw counts, duty and
+    // error in hundredths, as main.c reports them
+    {
+        pid_t ctrl;
+        led_plant_t plant;
+        led_plant_init(&plant);
+        for (uint32_t i = 0; i < MAXS; i++) {
+            pid_init(&ctrl, 1.2f, ((i / 500u) & 1u) ? 70.0f : 40.0f, 0.0f, 100.0f);
+            float noise = (float)((int32_t)(rnd() >> 29) - 4) * 0.08f;
+            float y     = plant.y + noise;
+            float u     = pid_compute(&ctrl, y);
+            led_plant_step(&plant, u, 0.01f);
+            samples[i][0] = (int32_t)(y * 40.95f + 0.5f);
+            samples[i][1] = (int32_t)(u * 100.0f + 0.5f);
+            samples[i][2] = (int32_t)((ctrl.setpoint - y) * 100.0f);
+        }
+
+        /* On change: rebuild by holding each reported value */
+        onchange_t o;
+        onchange_init(&o, cfg);
+        int32_t held[CH];
+        uint32_t last[CH] = { 0 }, t_line = 0u, in_steps = 0u;
+        size_t chg_bytes = 0u;
+        int32_t worst[CH] = { 0 };
+        for (uint32_t i = 0; i < MAXS; i++) {
+            uint32_t t = i * PERIOD;
+            uint32_t due = onchange_update(&o, t, samples[i]);
+            if (due) {
+                char line[ONCHANGE_LINE_MAX];
+                chg_bytes += onchange_format(t, due, samples[i], line, sizeof line);
+                assert(apply_line(line, held, &t_line) == due && t_line == t);
+                if (i % 500u < 50u) in_steps++;
+            }
+            for (uint32_t ch = 0; ch < CH; ch++) {
+                if (due & (1u << ch)) last[ch] = t;
+                assert(t - last[ch] < cfg[ch].max_ms);
+                int32_t e = iabs(held[ch] - samples[i][ch]);
+                assert(e <= cfg[ch].deadband);
+                if (e > worst[ch]) worst[ch] = e;
+            }
+        }
+
+        /* Fixed rate: every 100 ms, as the old commented-out line would */
+        size_t fixed_bytes = 0u, all_bytes = 0u;
+        int32_t fixed_worst[CH] = { 0 }, fheld[CH] = { 0 };
+        for (uint32_t i = 0; i < MAXS; i++) {
+            char line[64];
+            size_t n = (size_t)snprintf(line, sizeof line, "telemetry,%ld,%ld,%ld\n",
+                                        (long)samples[i][0], (long)samples[i][1], (long)samples[i][2]);
+            all_bytes += n;
+            if (i % 10u == 0u) {
+                fixed_bytes += n;
+                memcpy(fheld, samples[i], sizeof fheld);
+            }
+            for (uint32_t ch = 0; ch < CH; ch++) {
+                int32_t e = iabs(fheld[ch] - samples[i][ch]);
+                if (e > fixed_worst[ch]) fixed_worst[ch] = e;
+            }
+        }
+
+        double secs = MAXS * PERIOD / 1000.0;
+        printf("on change: %.0f B/s, %u of %u samples reported (%u in the 500 ms after "
+               "the %u steps), worst held error %ld/%ld/%ld\n",
+               chg_bytes / secs, (unsigned)o.reports, (unsigned)o.samples, (unsigned)in_steps,
+               (unsigned)(MAXS / 500u), (long)worst[0], (long)worst[1], (long)worst[2]);
+        printf("every 100 ms: %.0f B/s, 5 samples per step, worst held error %ld/%ld/%ld; "
+               "every sample: %.0f B/s\n",
+               fixed_bytes / secs, (long)fixed_worst[0], (long)fixed_worst[1],
+               (long)fixed_worst[2], all_bytes / secs);
+        assert(chg_bytes < fixed_bytes);
+        assert(in_steps > 5u * (MAXS / 500u));
+        for (uint32_t ch = 0; ch < CH; ch++) assert(fixed_worst[ch] > cfg[ch].deadband);
+    }
+
+    return 0;
+}
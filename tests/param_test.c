@@ -0,0 +1,333 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "stm32f4xx_hal.h"
+#include "../02-proportional-control/Core/Inc/param.h"
+#include "../02-proportional-control/Core/Inc/telemetry.h"
+#include "../02-proportional-control/Core/Inc/logger.h"
+
+static float    kp = 1.2f, setpoint = 60.0f;
+static int32_t  deadband = 32;
+static uint32_t rate_ms = 1000u, period_ms = 10u;
+
+static const param_def_t defs[] = {
+    {  1u, PARAM_F32, 0u, "kp",        &kp,        0.0f,    10.0f   },
+    {  2u, PARAM_F32, 0u, "setpoint",  &setpoint,  0.0f,    100.0f  },
+    { 10u, PARAM_I32, 0u, "deadband",  &deadband,  -100.0f, 100.0f  },
+    { 13u, PARAM_U32, 0u, "a_rather_long_name", &rate_ms, 1.0f, 60000.0f },
+    { 30u, PARAM_U32, PARAM_READ_ONLY, "period_ms", &period_ms, 0.0f, 1000.0f },
+};
+#define NDEFS   (sizeof defs / sizeof defs[0])
+
+static param_registry_t reg;
+static uint8_t resp[PARAM_FRAME_MAX];
+static size_t  resp_len;
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint32_t fbits(float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof v);
+    return v;
+}
+
+/* Build cmd, seq, body, crc */
+static size_t build(uint8_t *out, uint8_t cmd, uint8_t seq, const uint8_t *body, size_t n)
+{
+    out[0] = cmd;
+    out[1] = seq;
+    memcpy(&out[2], body, n);
+    uint16_t crc = param_crc16(out, n + 2u);
+    out[n + 2u] = (uint8_t)crc;
+    out[n + 3u] = (uint8_t)(crc >> 8);
+    return n + 4u;
+}
+
+/* Send one request straight to the handler; check the response framing
+ * and return its status; the body is at resp[3], resp_len - 5 bytes */
+static param_status_t request(uint8_t cmd, const uint8_t *body, size_t n)
+{
+    static uint8_t seq;
+    uint8_t req[PARAM_FRAME_MAX];
+    size_t len = build(req, cmd, ++seq, body, n);
+    resp_len = param_handle(&reg, req, len, resp, sizeof resp);
+    assert(resp_len >= 5u);
+    assert(resp[0] == (cmd | PARAM_CMD_RESPONSE) && resp[1] == seq);
+    assert(param_crc16(resp, resp_len - 2u) == (uint16_t)(resp[resp_len - 2u] | resp[resp_len - 1u] << 8));
+    return (param_status_t)resp[2];
+}
+
+static size_t set_pair(uint8_t *p, uint8_t id, uint32_t v)
+{
+    p[0] = id;
+    put_u32(&p[1], v);
+    return 5u;
+}
+
+/* --- The UART path: frames arrive through Log_Poll() --- */
+static uint32_t frames_ok, commands;
+static char     last_cmd[64];
+
+static bool on_frame(const uint8_t *frame, size_t len)
+{
+    uint8_t req[PARAM_FRAME_MAX];
+    size_t n = telemetry_uncobs(frame, len, req, sizeof req);
+    if (n == 0u) return false;
+    resp_len = param_handle(&reg, req, n, resp, sizeof resp);
+    if (resp_len == 0u || resp[2] == PARAM_ERR_CRC) return false;
+    frames_ok++;
+    return true;
+}
+
+static void on_command(const char *cmd)
+{
+    strcpy(last_cmd, cmd);
+    commands++;
+}
+
+static size_t wire_request(uint8_t *wire, uint8_t cmd, uint8_t seq, const uint8_t *body, size_t n)
+{
+    uint8_t req[PARAM_FRAME_MAX];
+    size_t len = build(req, cmd, seq, body, n);
+    return telemetry_cobs(req, len, wire, PARAM_FRAME_MAX + 8u);
+}
+
+int main(void) {
+    // CRC-16/CCITT-FALSE check value
+    assert(param_crc16((const uint8_t *)"123456789", 9) == 0x29B1u);
+
+    param_init(&reg, defs, NDEFS);
+
+    // GET: typed values, little-endian
+    {
+        const uint8_t ids[] = { 1u, 10u, 30u };
+        assert(request(PARAM_CMD_GET, ids, 3) == PARAM_OK);
+        assert(resp_len == 3u + 18u + 2u);
+        assert(resp[3] == 1u && resp[4] == PARAM_F32 && get_u32(&resp[5]) == fbits(1.2f));
+        assert(resp[9] == 10u && resp[10] == PARAM_I32 && (int32_t)get_u32(&resp[11]) == 32);
+        assert(resp[15] == 30u && resp[16] == PARAM_U32 && get_u32(&resp[17]) == 10u);
+        const uint8_t unknown[] = { 1u, 99u };
+        assert(request(PARAM_CMD_GET, unknown, 2) == PARAM_ERR_ID && resp[3] == 99u);
+        assert(request(PARAM_CMD_GET, ids, 0) == PARAM_ERR_LENGTH);
+    }
+
+    // SET is staged, applied only by the commit, all pairs together
+    {
+        uint8_t b[20];
+        size_t n = set_pair(b, 1u, fbits(2.5f));
+        n += set_pair(&b[n], 10u, (uint32_t)-7);
+        assert(request(PARAM_CMD_SET, b, n) == PARAM_OK && resp_len == 5u);
+        assert(kp == 1.2f && deadband == 32);
+        const uint8_t ids[] = { 1u };
+        assert(request(PARAM_CMD_GET, ids, 1) == PARAM_OK && get_u32(&resp[5]) == fbits(1.2f));
+        assert(param_commit(&reg));
+        assert(kp == 2.5f && deadband == -7);
+        assert(!param_commit(&reg));                        /* nothing left */
+    }
+
+    // One bad pair rejects the whole frame
+    {
+        uint8_t b[20];
+        size_t n = set_pair(b, 2u, fbits(50.0f));
+        set_pair(&b[n], 13u, 0u);                           /* below min 1 */
+        assert(request(PARAM_CMD_SET, b, 2u * n) == PARAM_ERR_RANGE && resp[3] == 13u);
+        set_pair(&b[n], 30u, 20u);
+        assert(request(PARAM_CMD_SET, b, 2u * n) == PARAM_ERR_READ_ONLY && resp[3] == 30u);
+        set_pair(&b[n], 77u, 20u);
+        assert(request(PARAM_CMD_SET, b, 2u * n) == PARAM_ERR_ID && resp[3] == 77u);
+        set_pair(&b[n], 1u, fbits(NAN));
+        assert(request(PARAM_CMD_SET, b, 2u * n) == PARAM_ERR_RANGE && resp[3] == 1u);
+        set_pair(&b[n], 1u, fbits(10.5f));
+        assert(request(PARAM_CMD_SET, b, 2u * n) == PARAM_ERR_RANGE);
+        assert(request(PARAM_CMD_SET, b, n + 2u) == PARAM_ERR_LENGTH);
+        assert(!param_commit(&reg) && setpoint == 60.0f);
+        set_pair(b, 13u, 60000u);                           /* max is inclusive */
+        assert(request(PARAM_CMD_SET, b, 5u) == PARAM_OK && param_commit(&reg) && rate_ms == 60000u);
+    }
+
+    // Corrupt, short and unknown requests
+    {
+        uint8_t req[16];
+        const uint8_t ids[] = { 1u };
+        size_t len = build(req, PARAM_CMD_GET, 5u, ids, 1);
+        req[2] ^= 0x10u;
+        assert(param_handle(&reg, req, len, resp, sizeof resp) == 5u && resp[2] == PARAM_ERR_CRC);
+        assert(param_handle(&reg, req, 3u, resp, sizeof resp) == 0u);
+        assert(request(0x42u, ids, 1) == PARAM_ERR_CMD);
+    }
+
+    // LIST in pages: entries from the given index while they fit
+    {
+        uint32_t got = 0u;
+        for (uint32_t pages = 0; got < NDEFS; pages++) {
+            uint8_t first = (uint8_t)got;
+            param_registry_t small = reg;
+            /* A small reply buffer forces several pages */
+            uint8_t req[8];
+            size_t len = build(req, PARAM_CMD_LIST, 1u, &first, 1);
+            resp_len = param_handle(&small, req, len, resp, 48u);
+            assert(resp[2] == PARAM_OK && resp[3] == NDEFS);
+            size_t r = 4u;
+            while (r < resp_len - 2u) {
+                const param_def_t *d = &defs[got++];
+                assert(resp[r] == d->id && resp[r + 1u] == d->type && resp[r + 2u] == d->flags);
+                assert(get_u32(&resp[r + 3u]) == fbits(d->min) && get_u32(&resp[r + 7u]) == fbits(d->max));
+                uint8_t nlen = resp[r + 11u];
+                assert(nlen == (strlen(d->name) > PARAM_NAME_MAX ? PARAM_NAME_MAX : strlen(d->name)));
+                assert(memcmp(&resp[r + 12u], d->name, nlen) == 0);
+                r += 12u + nlen;
+            }
+            assert(r == resp_len - 2u && pages < NDEFS);
+        }
+    }
+
+    // Updates interleaved with ticks: a tick never sees half of one
+    {
+        uint32_t lcg = 1u;
+        for (uint32_t i = 1; i < 2000u; i++) {
+            lcg = lcg * 1664525u + 1013904223u;
+            if (lcg >> 31) {
+                uint8_t b[10];
+                size_t n = set_pair(b, 1u, fbits((float)(i % 10u)));
+                n += set_pair(&b[n], 2u, fbits((float)(i % 10u) * 10.0f));
+                assert(request(PARAM_CMD_SET, b, n) == PARAM_OK);
+            }
+            if ((lcg >> 30) & 1u) param_commit(&reg);
+            assert(setpoint == kp * 10.0f || (kp == 2.5f && setpoint == 60.0f));
+        }
+    }
+
+    // Through the UART: interrupt ring, text lines and frames mixed,
+    // a frame joined midway, and more bytes than one Log_Poll() takes
+    {
+        Log_Init();
+        Log_SetFrameCallback(on_frame);
+        Log_SetCommandCallback(on_command);
+        uint8_t stream[400], wire[PARAM_FRAME_MAX + 8u];
+        size_t n = 0u;
+        const uint8_t ids[] = { 1u, 2u };
+
+        const char *text = "status\n";
+        memcpy(&stream[n], text, strlen(text));
+        n += strlen(text);
+        size_t w = wire_request(wire, PARAM_CMD_GET, 1u, ids, 2);
+        memcpy(&stream[n], wire, w);
+        n += w;
+        /* The tail of a frame whose start was missed, then a good one */
+        stream[n++] = 0x00u;
+        stream[n++] = 0x37u;
+        stream[n++] = 0x12u;
+        w = wire_request(wire, PARAM_CMD_GET, 2u, ids, 2);
+        memcpy(&stream[n], &wire[0], w);                   /* 0x00 closes the tail */
+        n += w;
+        for (uint32_t k = 0; k < 12u; k++) {               /* 12 × ~15 B */
+            uint8_t b[5];
+            set_pair(b, 13u, 100u + k);
+            w = wire_request(wire, PARAM_CMD_SET, (uint8_t)(3u + k), b, 5);
+            memcpy(&stream[n], wire, w);
+            n += w;
+        }
+        memcpy(&stream[n], "go\r", 3);
+        n += 3u;
+        assert(n < 255u);                                  /* fits the RX ring */
+
+        hal_stub_uart_rx(stream, (uint32_t)n);
+        uint32_t polls = 0u;
+        while (commands < 2u && polls < 100u) {
+            Log_Poll();
+            polls++;
+        }
+        assert(polls > 1u);                                /* took several calls */
+        assert(frames_ok == 14u && commands == 2u && strcmp(last_cmd, "go") == 0);
+        assert(param_commit(&reg) && rate_ms == 111u);
+        Log_Init();                                        /* reset before timing */
+    }
+
+    // Text commands survive line glitches: a bad frame, a stray 0x00,
+    // an overlong frame, and frames nobody takes
+    {
+        uint8_t stream[400], wire[PARAM_FRAME_MAX + 8u];
+        size_t n = 0u;
+        const uint8_t ids[] = { 1u };
+        size_t w = wire_request(wire, PARAM_CMD_GET, 1u, ids, 1);
+        memcpy(&stream[n], wire, w);
+        stream[n + 2u] ^= 0x40u;                           /* CRC fails */
+        n += w;
+        memcpy(&stream[n], "one\n", 4);
+        n += 4u;
+        stream[n++] = 0x00u;                               /* stray */
+        memcpy(&stream[n], "two\r\n", 5);
+        n += 5u;
+        stream[n++] = 0x00u;                               /* never closed in time */
+        memset(&stream[n], 0x01u, 138u);                  /* LOG_FRAME_MAX is 128 */
+        n += 138u;
+        memcpy(&stream[n], "\nthree\n", 7);
+        n += 7u;
+        w = wire_request(wire, PARAM_CMD_GET, 2u, ids, 1);
+        memcpy(&stream[n], wire, w);                       /* frames still work */
+        n += w;
+        assert(n < 255u);
+
+        Log_Init();
+        Log_SetFrameCallback(on_frame);
+        Log_SetCommandCallback(on_command);
+        frames_ok = commands = 0u;
+        hal_stub_uart_rx(stream, (uint32_t)n);
+        for (uint32_t k = 0; k < 10u; k++) Log_Poll();
+        assert(commands == 3u && strcmp(last_cmd, "three") == 0 && frames_ok == 1u);
+
+        /* No frame callback: the same valid frame must not swallow "four" */
+        Log_Init();
+        Log_SetFrameCallback(NULL);
+        n = 0u;
+        memcpy(&stream[n], wire, w);
+        n += w;
+        memcpy(&stream[n], "four\n", 5);
+        n += 5u;
+        hal_stub_uart_rx(stream, (uint32_t)n);
+        for (uint32_t k = 0; k < 10u; k++) Log_Poll();
+        assert(commands == 4u && strcmp(last_cmd, "four") == 0 && frames_ok == 1u);
+        Log_SetFrameCallback(on_frame);
+        Log_Init();
+    }
+
+    // Cost on the host, and what a parameter write takes on the link
+    {
+        uint8_t req[16], b[5];
+        set_pair(b, 1u, fbits(1.5f));
+        size_t len = build(req, PARAM_CMD_SET, 9u, b, 5);
+        uint8_t wire[32];
+        size_t wlen = telemetry_cobs(req, len, wire, sizeof wire);
+
+        const uint32_t iters = 1000000u;
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        uint32_t sink = 0u;
+        for (uint32_t i = 0; i < iters; i++) {
+            uint8_t dec[16];
+            size_t n = telemetry_uncobs(&wire[1], wlen - 2u, dec, sizeof dec);
+            sink += (uint32_t)param_handle(&reg, dec, n, resp, sizeof resp);
+            sink += param_commit(&reg);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double ns = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / iters;
+        size_t rlen = 5u + 3u;                             /* ack + COBS, delimiters */
+        printf("set kp: %zu B request, %zu B ack on the wire, %.0f round trips/s at "
+               "115200 baud; decode + handle + commit %.0f ns on the host (%u)\n",
+               wlen, rlen, 11520.0 / (double)(wlen + rlen), ns, (unsigned)(sink & 1u));
+        assert(kp == 1.5f);
+    }
+
+    return 0;
+}
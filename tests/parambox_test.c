@@ -0,0 +1,131 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include "../03-pi-control/Core/Inc/parambox.h"
+
+/* Payload of the same size as pid_params_t; every word is derived from
+ * the publication number so a torn copy is detectable. */
+typedef struct {
+    uint32_t n;
+    uint32_t words[5];
+    uint32_t check;
+} payload_t;
+
+#define PUBLICATIONS  200000u
+#define READERS       3
+
+static parambox_t box;
+static atomic_bool writer_done;
+
+static payload_t make_payload(uint32_t n) {
+    payload_t p;
+    p.n = n;
+    p.check = n;
+    for (uint32_t i = 0; i < 5; i++) {
+        p.words[i] = n * 2654435761u + i;
+        p.check ^= p.words[i];
+    }
+    return p;
+}
+
+static int consistent(const payload_t *p) {
+    payload_t ref = make_payload(p->n);
+    return memcmp(&ref, p, sizeof(ref)) == 0;
+}
+
+static void *writer(void *arg) {
+    (void)arg;
+    for (uint32_t n = 1; n <= PUBLICATIONS; n++) {
+        payload_t p = make_payload(n);
+        parambox_publish(&box, &p);
+        if ((n & 15u) == 0u) sched_yield();  /* interleave on single-core hosts */
+    }
+    atomic_store(&writer_done, true);
+    return NULL;
+}
+
+typedef struct {
+    uint32_t updates;
+    uint32_t empty_polls;
+} reader_stats_t;
+
+static void *reader(void *arg) {
+    reader_stats_t *st = arg;
+    payload_t p = make_payload(0);
+    uint32_t version = 0;
+
+    for (;;) {
+        bool done = atomic_load(&writer_done);
+        if (parambox_poll(&box, &p, &version)) {
+            assert(consistent(&p));
+            assert(p.n == version);          /* payload matches its version */
+            st->updates++;
+        } else {
+            st->empty_polls++;
+            sched_yield();
+        }
+        assert(consistent(&p));              /* held copy is never clobbered */
+        if (done && version == PUBLICATIONS) break;
+    }
+    return NULL;
+}
+
+int main(void) {
+    payload_t p0 = make_payload(0), out;
+    uint32_t version = 0;
+
+    // Single-threaded semantics
+    parambox_init(&box, &p0, sizeof(p0));
+    assert(parambox_version(&box) == 0);
+    assert(!parambox_poll(&box, &out, &version));   /* nothing newer yet */
+
+    payload_t p1 = make_payload(1);
+    parambox_publish(&box, &p1);
+    assert(parambox_version(&box) == 1);
+    assert(parambox_poll(&box, &out, &version));
+    assert(version == 1 && out.n == 1 && consistent(&out));
+    assert(!parambox_poll(&box, &out, &version));   /* consumed */
+
+    payload_t p2 = make_payload(2), p3 = make_payload(3);
+    parambox_publish(&box, &p2);
+    parambox_publish(&box, &p3);
+    assert(parambox_poll(&box, &out, &version));    /* skips to the newest */
+    assert(version == 3 && out.n == 3);
+
+    // Writer preempted while copy 0 is half written: the reader is steered
+    // to copy 1, which still holds the previous version intact
+    {
+        parambox_init(&box, &p0, sizeof(p0));
+        version = 0;
+        parambox_publish(&box, &p1);                          /* version 1 */
+        uint32_t s = atomic_load(&box.seq);
+        atomic_store(&box.seq, s + 1u);                       /* start v2 */
+        atomic_store(&box.data[0][0], 2u);
+        atomic_store(&box.data[0][1], 0xDEADBEEFu);           /* torn copy 0 */
+        assert(parambox_poll(&box, &out, &version));
+        assert(version == 1 && out.n == 1 && consistent(&out));
+        assert(!parambox_poll(&box, &out, &version));        /* v2 not ready */
+    }
+
+    // Torture: one writer publishing flat out against several readers
+    parambox_init(&box, &p0, sizeof(p0));
+    atomic_store(&writer_done, false);
+
+    pthread_t w, r[READERS];
+    reader_stats_t stats[READERS] = {{0}};
+    for (int i = 0; i < READERS; i++) {
+        assert(pthread_create(&r[i], NULL, reader, &stats[i]) == 0);
+    }
+    assert(pthread_create(&w, NULL, writer, NULL) == 0);
+    pthread_join(w, NULL);
+    for (int i = 0; i < READERS; i++) {
+        pthread_join(r[i], NULL);
+        assert(stats[i].updates > 0);
+        printf("reader %d: %u updates, %u empty polls\n",
+               i, stats[i].updates, stats[i].empty_polls);
+    }
+
+    return 0;
+}
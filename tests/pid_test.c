@@ -1,6 +1,68 @@
 #include <assert.h>
 #include <math.h>
+#include <stdio.h>
 #include "../03-pi-control/Core/Inc/pid.h"
+#include "led_plant.h"
+
+#define PLANT_TS  0.01f     /* 10 ms loop, as in 02 */
+
+/* Drive the plant into saturation with an unreachable setpoint, then step
+ * down and return the samples until the reading stays within ±2 %. */
+static int recovery_samples(pid_antiwindup_t mode, pid_form_t form) {
+    pid_t pid;
+    led_plant_t plant;
+    pid_init(&pid, 0.5f, 0.1f, 95.0f, 0.0f, 100.0f);   /* max reading is 85 % */
+    pid_set_antiwindup(&pid, mode, 0.5f);
+    pid_set_form(&pid, form);
+    led_plant_init(&plant);
+
+    for (int k = 0; k < 300; k++) {
+        led_plant_step(&plant, pid_compute(&pid, plant.y), PLANT_TS);
+    }
+
+    pid.setpoint = 40.0f;
+    int last_outside = -1;
+    for (int k = 0; k < 3000; k++) {
+        led_plant_step(&plant, pid_compute(&pid, plant.y), PLANT_TS);
+        if (fabsf(plant.y - 40.0f) > 2.0f) last_outside = k;
+    }
+    return last_outside + 1;
+}
+
+/* Step 5 % -> 50 % with continuous gains at sample period ts; samples the
+ * reading at 0.2 s, 0.5 s and 1 s. */
+static void step_response(float ts, pid_disc_t disc, float y[3]) {
+    pid_t pid;
+    led_plant_t plant;
+    pid_init(&pid, 0.5f, 10.0f, 50.0f, 0.0f, 100.0f);
+    pid_set_sample_time(&pid, ts, disc);
+    led_plant_init(&plant);
+
+    int n = (int)(1.0f / ts + 0.5f);
+    for (int k = 1; k <= n; k++) {
+        led_plant_step(&plant, pid_compute(&pid, plant.y), ts);
+        if (k == (int)(0.2f / ts + 0.5f)) y[0] = plant.y;
+        if (k == (int)(0.5f / ts + 0.5f)) y[1] = plant.y;
+    }
+    y[2] = plant.y;
+}
+
+/* Seconds until a 5 % -> 50 % step stays within ±1 % at 1 kHz */
+static float settle_time(float kp, float ki, float kd, float tf) {
+    pid_t pid;
+    led_plant_t plant;
+    pid_init(&pid, kp, ki, 50.0f, 0.0f, 100.0f);
+    pid_set_sample_time(&pid, 0.001f, PID_DISC_TUSTIN);
+    pid_set_derivative(&pid, kd, tf);
+    led_plant_init(&plant);
+
+    int last_outside = -1;
+    for (int k = 0; k < 3000; k++) {
+        led_plant_step(&plant, pid_compute(&pid, plant.y), 0.001f);
+        if (fabsf(plant.y - 50.0f) > 1.0f) last_outside = k;
+    }
+    return (float)(last_outside + 1) * 0.001f;
+}
 
 int main(void) {
     pid_t pid;
@@ -18,11 +80,267 @@ int main(void) {
 
     // Integral accumulation behaviour
     pid_init(&pid, 0.0f, 0.5f, 10.0f, 0.0f, 100.0f);
-    out = pid_compute(&pid, 0.0f);   // error=10 -> integral=10 -> output=5
+    out = pid_compute(&pid, 0.0f);   // error=10 -> integral term=5 -> output=5
     assert(fabsf(out - 5.0f) < 1e-6);
 
-    out = pid_compute(&pid, 0.0f);   // integral=20 -> output=10
+    out = pid_compute(&pid, 0.0f);   // integral term=10 -> output=10
+    assert(fabsf(out - 10.0f) < 1e-6);
+
+    // Anti-windup: without it the integral grows past the output limit
+    pid_init(&pid, 0.0f, 1.0f, 50.0f, 0.0f, 10.0f);
+    pid_set_antiwindup(&pid, PID_AW_NONE, 0.0f);
+    for (int i = 0; i < 5; i++) out = pid_compute(&pid, 0.0f);
+    assert(fabsf(out - 10.0f) < 1e-6 && pid.integral > 200.0f);
+
+    pid_init(&pid, 0.0f, 1.0f, 50.0f, 0.0f, 10.0f);     // default: clamp
+    for (int i = 0; i < 5; i++) out = pid_compute(&pid, 0.0f);
+    assert(fabsf(pid.integral - 10.0f) < 1e-6);
+
+    pid_set_antiwindup(&pid, PID_AW_CONDITIONAL, 0.0f);
+    pid.integral = 10.0f;
+    out = pid_compute(&pid, 0.0f);   // saturated and error > 0: frozen
+    assert(fabsf(pid.integral - 10.0f) < 1e-6);
+    out = pid_compute(&pid, 60.0f);  // error < 0 unwinds immediately
+    assert(fabsf(pid.integral - 0.0f) < 1e-6);
+
+    pid_init(&pid, 0.2f, 1.0f, 50.0f, 0.0f, 10.0f);
+    pid_set_antiwindup(&pid, PID_AW_BACKCALC, 1.0f);
+    out = pid_compute(&pid, 0.0f);   // Kt=1 tracks: p + integral == limit
     assert(fabsf(out - 10.0f) < 1e-6);
+    assert(fabsf(pid.integral - (10.0f - 0.2f * 50.0f)) < 1e-6);
+
+    // All strategies agree while the output stays inside its limits
+    {
+        pid_t ref, alt;
+        led_plant_t plant;
+        for (int m = PID_AW_CLAMP; m <= PID_AW_BACKCALC; m++) {
+            pid_init(&ref, 0.5f, 0.1f, 40.0f, 0.0f, 100.0f);
+            pid_set_antiwindup(&ref, PID_AW_NONE, 0.0f);
+            pid_init(&alt, 0.5f, 0.1f, 40.0f, 0.0f, 100.0f);
+            pid_set_antiwindup(&alt, (pid_antiwindup_t)m, 0.5f);
+            led_plant_init(&plant);
+            for (int k = 0; k < 200; k++) {
+                float u_ref = pid_compute(&ref, plant.y);
+                float u_alt = pid_compute(&alt, plant.y);
+                assert(fabsf(u_ref - u_alt) < 1e-4f);
+                led_plant_step(&plant, u_ref, PLANT_TS);
+            }
+        }
+    }
+
+    // Discretisation of the integrator, constant error 1, Ki=2/s, Ts=0.1 s
+    {
+        static const struct { pid_disc_t disc; float u[3]; } cases[] = {
+            { PID_DISC_FORWARD,  { 0.0f, 0.2f, 0.4f } },
+            { PID_DISC_BACKWARD, { 0.2f, 0.4f, 0.6f } },
+            { PID_DISC_TUSTIN,   { 0.1f, 0.3f, 0.5f } },
+        };
+        for (unsigned c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+            pid_init(&pid, 0.0f, 2.0f, 1.0f, -100.0f, 100.0f);
+            pid_set_sample_time(&pid, 0.1f, cases[c].disc);
+            for (int k = 0; k < 3; k++) {
+                out = pid_compute(&pid, 0.0f);
+                assert(fabsf(out - cases[c].u[k]) < 1e-5f);
+            }
+        }
+    }
+
+    // Same continuous tuning at 100 Hz and 10 kHz gives the same response
+    for (int d = PID_DISC_FORWARD; d <= PID_DISC_TUSTIN; d++) {
+        float slow[3], fast[3];
+        step_response(0.01f, (pid_disc_t)d, slow);
+        step_response(0.0001f, (pid_disc_t)d, fast);
+        for (int i = 0; i < 3; i++) assert(fabsf(slow[i] - fast[i]) < 1.0f);
+        assert(fabsf(fast[2] - 50.0f) < 0.5f);
+    }
+
+    // Measured-dt path: identical to the fixed path when dt == Ts, and
+    // tracks the same trajectory with ±10 % timing jitter
+    {
+        pid_t fixed, timed, jitter;
+        led_plant_t p_fixed, p_jitter;
+        pid_init(&fixed, 0.5f, 10.0f, 50.0f, 0.0f, 100.0f);
+        pid_set_sample_time(&fixed, 0.01f, PID_DISC_TUSTIN);
+        timed = fixed;
+        jitter = fixed;
+        led_plant_init(&p_fixed);
+        p_jitter = p_fixed;
+
+        for (int k = 0; k < 100; k++) {
+            float u = pid_compute(&fixed, p_fixed.y);
+            assert(pid_compute_dt(&timed, p_fixed.y, 0.01f) == u);
+            led_plant_step(&p_fixed, u, 0.01f);
+
+            float dt = (k & 1) ? 0.009f : 0.011f;
+            led_plant_step(&p_jitter, pid_compute_dt(&jitter, p_jitter.y, dt), dt);
+        }
+        assert(fabsf(p_fixed.y - p_jitter.y) < 0.5f);
+    }
+
+    // A repeated time stamp (dt = 0, default Tf = 0) leaves the state alone
+    {
+        pid_t rep;
+        pid_init(&rep, 0.5f, 10.0f, 50.0f, 0.0f, 100.0f);
+        pid_set_sample_time(&rep, 0.01f, PID_DISC_TUSTIN);
+        float u = pid_compute_dt(&rep, 20.0f, 0.01f);
+        assert(pid_compute_dt(&rep, 30.0f, 0.0f) == u);
+        assert(pid_compute_dt(&rep, 30.0f, -0.01f) == u);
+        for (int k = 0; k < 10; k++) {
+            assert(isfinite(pid_compute_dt(&rep, 20.0f, 0.01f)));
+            assert(isfinite(pid_compute(&rep, 20.0f)));
+        }
+        assert(isfinite(rep.deriv) && isfinite(rep.integral));
+    }
+
+    // Derivative acts on the measurement: a setpoint step causes no kick
+    pid_init(&pid, 0.0f, 0.0f, 10.0f, -100.0f, 100.0f);
+    pid_set_derivative(&pid, 1.0f, 0.0f);
+    out = pid_compute(&pid, 5.0f);
+    pid.setpoint = 80.0f;
+    out = pid_compute(&pid, 5.0f);
+    assert(fabsf(out) < 1e-6f);
+    out = pid_compute(&pid, 6.0f);   // Kd·dy/Ts with Ts=1, Tf=0
+    assert(fabsf(out + 1.0f) < 1e-6f);
+
+    // Filtered derivative of a ramp settles to -Kd·slope
+    pid_init(&pid, 0.0f, 0.0f, 0.0f, -100.0f, 100.0f);
+    pid_set_sample_time(&pid, 0.01f, PID_DISC_BACKWARD);
+    pid_set_derivative(&pid, 0.5f, 0.05f);
+    out = pid_compute(&pid, 0.0f);
+    assert(fabsf(out) < 1e-6f);      // first sample has nothing to difference
+    for (int k = 1; k <= 200; k++) out = pid_compute(&pid, 0.1f * (float)k);  // 10 /s
+    assert(fabsf(out + 5.0f) < 1e-3f);
+
+    // PID settles faster than PI on the LED/CdS/RC plant (gains are the
+    // best of a coarse grid search for each structure, at 1 kHz)
+    {
+        float pi  = settle_time(1.06f, 30.3f, 0.0f, 0.0f);
+        float pd  = settle_time(6.65f, 51.2f, 0.077f, 0.0012f);
+        printf("settle time: PI=%.3f s PID=%.3f s\n", pi, pd);
+        assert(pd > 0.0f && pd < 0.8f * pi);
+    }
+
+    // Velocity form matches the positional form while unsaturated
+    {
+        pid_t pos, vel;
+        led_plant_t plant;
+        pid_init(&pos, 0.5f, 10.0f, 40.0f, 0.0f, 100.0f);
+        pid_set_sample_time(&pos, 0.01f, PID_DISC_TUSTIN);
+        pid_set_derivative(&pos, 0.01f, 0.002f);
+        vel = pos;
+        pid_set_form(&vel, PID_FORM_VELOCITY);
+        led_plant_init(&plant);
+        for (int k = 0; k < 300; k++) {
+            float u_pos = pid_compute(&pos, plant.y);
+            float u_vel = pid_compute(&vel, plant.y);
+            assert(fabsf(u_pos - u_vel) < 1e-3f);
+            led_plant_step(&plant, u_pos, PLANT_TS);
+        }
+    }
+
+    // Online retuning: the output continues from the last value with
+    // only the new gains' increment, both mid-transient and in steady
+    // state; re-initialising the controller instead drops the integral
+    for (int f = PID_FORM_POSITIONAL; f <= PID_FORM_VELOCITY; f++) {
+        static const int change_at[] = { 8, 200 };
+        for (int c = 0; c < 2; c++) {
+            pid_t ctrl, reinit;
+            led_plant_t plant;
+            pid_init(&ctrl, 0.5f, 10.0f, 60.0f, 0.0f, 100.0f);
+            pid_set_sample_time(&ctrl, 0.01f, PID_DISC_BACKWARD);
+            pid_set_form(&ctrl, (pid_form_t)f);
+            led_plant_init(&plant);
+            float u = 0.0f;
+            for (int k = 0; k < change_at[c]; k++) {
+                u = pid_compute(&ctrl, plant.y);
+                led_plant_step(&plant, u, PLANT_TS);
+            }
+            reinit = ctrl;
+
+            float e_prev = ctrl.e_prev;
+            float e = ctrl.setpoint - plant.y;
+            pid_set_gains(&ctrl, 1.5f, 30.0f, 0.0f);
+            float u_bumpless = pid_compute(&ctrl, plant.y);
+            float expected = u + 1.5f * (e - e_prev) + 30.0f * 0.01f * e;
+            assert(fabsf(u_bumpless - expected) < 1e-3f);
+
+            pid_init(&reinit, 1.5f, 30.0f, 60.0f, 0.0f, 100.0f);
+            pid_set_sample_time(&reinit, 0.01f, PID_DISC_BACKWARD);
+            float u_reinit = pid_compute(&reinit, plant.y);
+            if (c == 1) assert(fabsf(u_bumpless - u) < 0.1f && fabsf(u_reinit - u) > 50.0f);
+        }
+    }
+
+    // Retuning while saturated (as an adaptive loop does every few ticks)
+    // keeps the integral within its bounds: the output holds the limit,
+    // and leaves it as soon as the error reverses, with no stored windup
+    {
+        pid_t ctrl;
+        pid_init(&ctrl, 0.5f, 10.0f, 60.0f, 0.0f, 100.0f);
+        pid_set_sample_time(&ctrl, 0.01f, PID_DISC_BACKWARD);
+        for (int k = 0; k < 200; k++) out = pid_compute(&ctrl, 10.0f);
+        assert(out == 100.0f && ctrl.integral == 100.0f);
+
+        for (int r = 0; r < 10; r++) {
+            pid_set_gains(&ctrl, (r & 1) ? 0.5f : 0.1f, 10.0f, 0.0f);
+            assert(ctrl.integral >= ctrl.aw_min && ctrl.integral <= ctrl.aw_max);
+            out = pid_compute(&ctrl, 10.0f);
+            assert(out == 100.0f);
+        }
+        pid_set_gains(&ctrl, 0.1f, 10.0f, 0.0f);
+        out = pid_compute(&ctrl, 70.0f);
+        assert(fabsf(out - (0.1f * -10.0f + 100.0f + 10.0f * 0.01f * -10.0f)) < 1e-3f);
+    }
+
+    // Parameter block round trip and application at a tick boundary
+    {
+        pid_params_t prm;
+        pid_init(&pid, 0.5f, 10.0f, 40.0f, 0.0f, 100.0f);
+        pid_set_sample_time(&pid, 0.01f, PID_DISC_BACKWARD);
+        for (int k = 0; k < 50; k++) out = pid_compute(&pid, 30.0f);
+        pid_get_params(&pid, &prm);
+        assert(prm.Kp == 0.5f && prm.Ki == 10.0f && prm.setpoint == 40.0f);
+
+        prm.Kp = 2.0f;
+        prm.out_max = 50.0f;
+        pid_apply_params(&pid, &prm);
+        assert(pid.aw_max == 50.0f);             /* clamp bound follows */
+        float next = pid_compute(&pid, 30.0f);
+        assert(next <= 50.0f);
+    }
+
+    // Manual -> auto transfer continues from the manual output
+    for (int f = PID_FORM_POSITIONAL; f <= PID_FORM_VELOCITY; f++) {
+        pid_t ctrl;
+        led_plant_t plant;
+        pid_init(&ctrl, 0.5f, 10.0f, 60.0f, 0.0f, 100.0f);
+        pid_set_sample_time(&ctrl, 0.01f, PID_DISC_BACKWARD);
+        pid_set_derivative(&ctrl, 0.01f, 0.002f);
+        pid_set_form(&ctrl, (pid_form_t)f);
+        led_plant_init(&plant);
+        for (int k = 0; k < 100; k++) {
+            led_plant_step(&plant, pid_track(&ctrl, plant.y, 30.0f), PLANT_TS);
+        }
+        /* plant has settled at 29 %: error 31, so one step of I is ~3 */
+        out = pid_compute(&ctrl, plant.y);
+        assert(fabsf(out - 30.0f) < 4.0f);
+    }
+
+    // Recovery after saturation on the LED/CdS plant
+    {
+        int none = recovery_samples(PID_AW_NONE, PID_FORM_POSITIONAL);
+        int clamp = recovery_samples(PID_AW_CLAMP, PID_FORM_POSITIONAL);
+        int cond = recovery_samples(PID_AW_CONDITIONAL, PID_FORM_POSITIONAL);
+        int back = recovery_samples(PID_AW_BACKCALC, PID_FORM_POSITIONAL);
+        int vel = recovery_samples(PID_AW_NONE, PID_FORM_VELOCITY);
+        printf("recovery samples: none=%d clamp=%d conditional=%d backcalc=%d velocity=%d\n",
+               none, clamp, cond, back, vel);
+        assert(clamp > 0 && clamp * 2 < none);
+        assert(cond > 0 && cond * 2 < none);
+        assert(back > 0 && back * 2 < none);
+        assert(vel > 0 && vel * 2 < none);
+        assert(none < 3000);             // still converges eventually
+    }
 
     return 0;
 }
@@ -0,0 +1,188 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ff.h"
+#include "../02-proportional-control/Core/Inc/logger.h"
+
+#define LOG_FILE   "log.txt"
+#define BLOCK      (512u * 4u)          /* LOG_SD_BLOCK_SECTORS default */
+
+static char   expect[1u << 20];         /* what the file should hold */
+static size_t expect_len;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static void start(const char *existing)
+{
+    FILE *f = fopen(LOG_FILE, "wb");
+    fputs(existing, f);
+    fclose(f);
+    strcpy(expect, existing);
+    expect_len = strlen(existing);
+    Log_Init();
+    Log_SetLevel(LOG_LEVEL_DEBUG);
+}
+
+static void check_file(void)
+{
+    static char got[sizeof expect];
+    FILE *f = fopen(LOG_FILE, "rb");
+    size_t n = fread(got, 1, sizeof got, f);
+    fclose(f);
+    assert(n == expect_len);
+    assert(memcmp(got, expect, n) == 0);
+}
+
+/* A control-loop style line of varying length */
+static size_t log_line(uint32_t i)
+{
+    char line[96];
+    int n = snprintf(line, sizeof line, "ctrl,%lu,%u,%u%s\n", (unsigned long)i,
+                     (unsigned)(i * 7u % 4096u), (unsigned)(i % 101u),
+                     (i % 5u) ? "" : ",note=setpoint step");
+    LogSdStats st;
+    Log_GetSdStats(&st);
+    uint32_t dropped = st.dropped_msgs;
+    Log(LOG_LEVEL_INFO, "%s", line);
+    Log_GetSdStats(&st);
+    if (st.dropped_msgs == dropped)
+    {
+        memcpy(&expect[expect_len], line, (size_t)n);
+        expect_len += (size_t)n;
+    }
+    return (size_t)n;
+}
+
+int main(void) {
+    // Everything logged ends up in the file, appended to what was there;
+    // after the first block, every write is whole aligned sectors
+    {
+        start("earlier session\n");
+        ff_stub_writes = ff_stub_unaligned = 0u;
+        for (uint32_t i = 0; i < 5000u; i++) {
+            log_line(i);
+            Log_Service(0u);                      /* no sync interval yet */
+        }
+        LogSdStats st;
+        Log_GetSdStats(&st);
+        assert(st.dropped_msgs == 0u && st.errors == 0u && st.syncs == 0u);
+        assert(ff_stub_writes == st.blocks);
+        assert(ff_stub_unaligned == 1u);          /* first block: 16 → 2048 */
+        Log_Flush();
+        check_file();
+    }
+
+    // A sync writes the part block, and the full block later overwrites it
+    {
+        start("");
+        uint32_t ms = 0u;
+        for (uint32_t i = 0; i < 3000u; i++) {
+            log_line(i);
+            ms += 7u;
+            Log_Service(ms);
+            if (i % 400u == 399u) {
+                /* A reset here loses nothing logged before the last sync */
+                Log_Flush();
+                check_file();
+            }
+        }
+        LogSdStats st;
+        Log_GetSdStats(&st);
+        assert(st.syncs > 15u && st.partial_writes > 15u);
+        Log_Flush();
+        check_file();
+    }
+
+    // Without service the two blocks fill, then whole lines are dropped
+    {
+        start("");
+        size_t offered = 0u;
+        for (uint32_t i = 0; i < 400u; i++) offered += log_line(i);
+        LogSdStats st;
+        Log_GetSdStats(&st);
+        assert(st.dropped_msgs > 0u);
+        assert(offered - st.dropped_bytes == expect_len);
+        assert(expect_len <= 2u * BLOCK && expect_len > 2u * BLOCK - 64u);
+        Log_Flush();
+        check_file();
+    }
+
+    // Throughput and stalls against one f_write() per message, on the SD
+    // model in stubs/ff.h: a 100 Hz loop logging three lines per tick,
+    // Log_Service() every 1 ms, a sync every second
+    {
+        const uint32_t ticks = 20000u;            /* 200 s */
+        size_t bytes = 0u;
+
+        /* Before: each Log() wrote straight through */
+        FIL direct;
+        FILE *f = fopen("direct.txt", "wb");
+        fclose(f);
+        f_open(&direct, "direct.txt", FA_OPEN_ALWAYS | FA_WRITE);
+        double busy = 0.0, stall = 0.0;
+        for (uint32_t ms = 0; ms < ticks * 10u; ms++) {
+            double tick = 0.0;
+            if (ms % 10u == 0u)
+                for (uint32_t k = 0; k < 3u; k++) {
+                    char line[96];
+                    int n = snprintf(line, sizeof line, "ctrl,%lu,%u,%u\n",
+                                     (unsigned long)ms, (unsigned)(ms % 4096u), k);
+                    UINT bw;
+                    f_write(&direct, line, (UINT)n, &bw);
+                    tick += ff_stub_last_us;
+                    bytes += (size_t)n;
+                }
+            if (ms % 1000u == 999u) {
+                f_sync(&direct);
+                tick += ff_stub_last_us;
+            }
+            busy += tick;
+            if (tick > stall) stall = tick;
+        }
+        f_close(&direct);
+        remove("direct.txt");
+
+        /* After: Log() copies, Log_Service() writes */
+        start("");
+        double b_busy = 0.0, b_stall = 0.0, t0 = now_s();
+        for (uint32_t ms = 0; ms < ticks * 10u; ms++) {
+            if (ms % 10u == 0u)
+                for (uint32_t k = 0; k < 3u; k++) {
+                    ff_stub_last_us = 0.0;
+                    Log(LOG_LEVEL_INFO, "ctrl,%lu,%u,%u\n",
+                        (unsigned long)ms, (unsigned)(ms % 4096u), k);
+                    assert(ff_stub_last_us == 0.0);     /* no card access in Log() */
+                }
+            double before = ff_stub_total_us;
+            Log_Service(ms);
+            double call = ff_stub_total_us - before;
+            b_busy += call;
+            if (call > b_stall) b_stall = call;
+        }
+        Log_Flush();
+        double wall = now_s() - t0;
+
+        LogSdStats st;
+        Log_GetSdStats(&st);
+        assert(st.dropped_msgs == 0u && st.errors == 0u);
+        double mb = (double)bytes / 1e6;
+        printf("per-message f_write: card busy %.2f s for %.2f MB (%.2f MB/s), "
+               "worst stall in the loop %.2f ms\n", busy * 1e-6, mb, mb / (busy * 1e-6), stall * 1e-3);
+        printf("buffered %u B blocks: card busy %.2f s (%.2f MB/s), worst Log_Service() "
+               "%.2f ms, Log() never touches the card; host %.0f MB/s\n",
+               BLOCK, b_busy * 1e-6, mb / (b_busy * 1e-6), b_stall * 1e-3, mb / wall);
+        assert(b_busy < 0.6 * busy);
+        /* Bounded: one block, or a part block plus a sync (window + entry) */
+        assert(b_stall <= 3.0 * FF_STUB_CMD_US + (BLOCK / 512u + 2u) * FF_STUB_SECTOR_US);
+    }
+
+    remove(LOG_FILE);
+    return 0;
+}
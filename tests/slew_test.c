@@ -0,0 +1,129 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include "../03-pi-control/Core/Inc/slew.h"
+#include "../03-pi-control/Core/Inc/pid.h"
+#include "led_plant.h"
+
+#define TS    0.01f
+#define EPS   1e-4f
+
+typedef struct
+{
+    float iae;          /* Σ|r - y|·Ts                      */
+    float overshoot;    /* worst excursion past the setpoint */
+    float max_step;     /* largest duty change in one tick   */
+} response_t;
+
+/* 10 % → 80 % → 20 % on the LED plant, PI (mpc_test's tuning) through a
+ * 200 %/s slew stage, with or without feedback of the applied duty */
+static response_t run_loop(pid_antiwindup_t aw, int feedback) {
+    response_t r = { 0.0f, 0.0f, 0.0f };
+    pid_t pi;
+    slew_t s;
+    led_plant_t plant;
+    led_plant_init(&plant);
+    pid_init(&pi, 7.66f, 204.0f, 10.0f, 0.0f, 100.0f);
+    pid_set_sample_time(&pi, TS, PID_DISC_BACKWARD);
+    pid_set_antiwindup(&pi, aw, 20.0f);
+    slew_init(&s, 200.0f, 0.0f, TS, 0.0f);
+
+    float prev = 0.0f;
+    for (int k = 0; k < 300; k++) {
+        float sp = (k < 50) ? 10.0f : (k < 150) ? 80.0f : 20.0f;
+        pi.setpoint = sp;
+        float u = slew_step(&s, PID_COMPUTE(&pi, plant.y));
+        if (feedback) pid_track_applied(&pi, u);
+        led_plant_step(&plant, u, TS);
+
+        r.iae += fabsf(sp - plant.y) * TS;
+        if (k >= 50 && k < 150) r.overshoot = fmaxf(r.overshoot, plant.y - sp);
+        if (k >= 150)           r.overshoot = fmaxf(r.overshoot, sp - plant.y);
+        r.max_step = fmaxf(r.max_step, fabsf(u - prev));
+        prev = u;
+    }
+    return r;
+}
+
+int main(void) {
+    // No limits: the output follows the target
+    {
+        slew_t s;
+        slew_init(&s, 0.0f, 0.0f, TS, 0.0f);
+        assert(slew_step(&s, 73.5f) == 73.5f);
+        assert(slew_step(&s, 2.0f) == 2.0f);
+    }
+
+    // Rate only: 2 % per tick, lands exactly on the target
+    {
+        slew_t s;
+        slew_init(&s, 200.0f, 0.0f, TS, 0.0f);
+        int k = 0;
+        while (s.out < 100.0f) {
+            float prev = s.out;
+            slew_step(&s, 100.0f);
+            assert(s.out - prev <= 2.0f + EPS);
+            assert(s.out <= 100.0f);
+            k++;
+        }
+        assert(k == 50);
+        slew_step(&s, 99.0f);                          /* short move: one tick */
+        assert(s.out == 99.0f);
+    }
+
+    // Jerk limit: speed ramps up and down, no overshoot, S-curve timing
+    {
+        slew_t s;
+        slew_init(&s, 200.0f, 4000.0f, TS, 10.0f);     /* 0.4 %/tick² */
+        float prev_step = 0.0f, peak = 0.0f;
+        int k = 0;
+        while (fabsf(s.out - 80.0f) > EPS || fabsf(s.step) > EPS) {
+            float before = s.out;
+            slew_step(&s, 80.0f);
+            float step = s.out - before;
+            assert(fabsf(step) <= 2.0f + EPS);
+            assert(fabsf(step - prev_step) <= 0.4f + EPS);
+            assert(s.out <= 80.0f + EPS);
+            peak = fmaxf(peak, step);
+            prev_step = step;
+            assert(++k < 100);
+        }
+        /* 70 % at 2 %/tick plus 5 ticks each to speed up and slow down */
+        printf("jerk-limited 10 -> 80: %d ticks, peak step %.2f %%\n", k, peak);
+        assert(peak == 2.0f);
+        assert(k >= 40 && k <= 42);
+    }
+
+    // A reversal mid-move brakes with the jerk limit, then settles
+    {
+        slew_t s;
+        slew_init(&s, 200.0f, 4000.0f, TS, 0.0f);
+        for (int k = 0; k < 20; k++) slew_step(&s, 100.0f);
+        float prev_step = s.step;
+        for (int k = 0; k < 200; k++) {
+            float before = s.out;
+            slew_step(&s, 20.0f);
+            assert(fabsf((s.out - before) - prev_step) <= 0.4f + EPS);
+            prev_step = s.out - before;
+        }
+        assert(fabsf(s.out - 20.0f) < EPS);
+    }
+
+    // Closed loop: feeding the applied duty back stops the windup that
+    // the rate limit causes
+    {
+        response_t bare = run_loop(PID_AW_CLAMP, 0);
+        response_t trk  = run_loop(PID_AW_CLAMP, 1);
+        response_t bc   = run_loop(PID_AW_BACKCALC, 1);
+        printf("slew 200 %%/s, clamp: IAE %.2f overshoot %.2f %%; "
+               "tracked: IAE %.2f overshoot %.2f %%; back-calc tracked: IAE %.2f overshoot %.2f %%\n",
+               bare.iae, bare.overshoot, trk.iae, trk.overshoot, bc.iae, bc.overshoot);
+        fflush(stdout);
+        assert(trk.max_step <= 2.0f + EPS);
+        assert(trk.overshoot < 0.25f * bare.overshoot);
+        assert(trk.iae < bare.iae);
+        assert(bc.overshoot < 0.25f * bare.overshoot);
+    }
+
+    return 0;
+}
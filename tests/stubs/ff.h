@@ -0,0 +1,63 @@
+/**
+ * @file    ff.h
+ * @brief   Host stand-in for the FatFS calls used by the 02 logger.
+ *
+ * Files are ordinary host files.  Each call also advances a model of the
+ * SD card, so the tests can compare write patterns: every bus command
+ * costs FF_STUB_CMD_US (card busy time) plus FF_STUB_SECTOR_US per
+ * 512-byte sector.  As in FatFS, partial sectors go through a one-sector
+ * window that is written back when the file moves to another sector or
+ * on f_sync(), and whole aligned sectors are written directly with one
+ * multi-sector command.
+ */
+
+#ifndef FF_H
+#define FF_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef FF_STUB_CMD_US
+#define FF_STUB_CMD_US      800.0   /* Command + card busy per write    */
+#endif
+#ifndef FF_STUB_SECTOR_US
+#define FF_STUB_SECTOR_US   100.0   /* Transfer per sector (~5 MB/s)    */
+#endif
+#define FF_STUB_SECTOR      512u
+
+typedef unsigned int UINT;
+typedef uint32_t     FSIZE_t;
+
+typedef enum { FR_OK = 0, FR_DISK_ERR, FR_NO_FILE, FR_INVALID_OBJECT } FRESULT;
+
+#define FA_READ          0x01
+#define FA_WRITE         0x02
+#define FA_OPEN_ALWAYS   0x10
+
+typedef struct
+{
+    FILE    *fp;
+    FSIZE_t  fptr;          /* File pointer                       */
+    FSIZE_t  obj_size;      /* File size                          */
+    int64_t  win;           /* Sector held in the window, -1 none */
+    int      win_dirty;
+} FIL;
+
+FRESULT f_open(FIL *fp, const char *path, uint8_t mode);
+FRESULT f_close(FIL *fp);
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw);
+FRESULT f_lseek(FIL *fp, FSIZE_t ofs);
+FRESULT f_sync(FIL *fp);
+
+#define f_size(fp)  ((fp)->obj_size)
+#define f_tell(fp)  ((fp)->fptr)
+
+/* Model time of the last call and of all calls, in microseconds */
+extern double ff_stub_last_us;
+extern double ff_stub_total_us;
+extern uint32_t ff_stub_commands;
+/* f_write() calls, and those not starting and ending on a sector */
+extern uint32_t ff_stub_writes;
+extern uint32_t ff_stub_unaligned;
+
+#endif /* FF_H */
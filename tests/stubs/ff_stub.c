@@ -0,0 +1,121 @@
+/**
+ * @file    ff_stub.c
+ * @brief   Host implementation of the FatFS stand-in (see ff.h).
+ */
+
+#include "ff.h"
+
+double   ff_stub_last_us;
+double   ff_stub_total_us;
+uint32_t ff_stub_commands;
+uint32_t ff_stub_writes;
+uint32_t ff_stub_unaligned;
+
+static void disk_write(uint32_t sectors)
+{
+    ff_stub_last_us += FF_STUB_CMD_US + FF_STUB_SECTOR_US * sectors;
+    ff_stub_commands++;
+}
+
+/* Write the window back if it holds unsaved data */
+static void win_flush(FIL *fp)
+{
+    if (fp->win_dirty) disk_write(1u);
+    fp->win_dirty = 0;
+}
+
+/* Bring sector s into the window, reading it if it holds file data */
+static void win_move(FIL *fp, int64_t s)
+{
+    if (fp->win == s) return;
+    win_flush(fp);
+    if ((FSIZE_t)(s * FF_STUB_SECTOR) < fp->obj_size)
+    {
+        ff_stub_last_us += FF_STUB_CMD_US + FF_STUB_SECTOR_US;   /* read */
+        ff_stub_commands++;
+    }
+    fp->win = s;
+}
+
+static void account(void)
+{
+    ff_stub_total_us += ff_stub_last_us;
+}
+
+FRESULT f_open(FIL *fp, const char *path, uint8_t mode)
+{
+    (void)mode;
+    fp->fp = fopen(path, "r+b");
+    if (!fp->fp) fp->fp = fopen(path, "w+b");
+    if (!fp->fp) return FR_NO_FILE;
+    fseek(fp->fp, 0, SEEK_END);
+    fp->obj_size  = (FSIZE_t)ftell(fp->fp);
+    fp->fptr      = 0u;
+    fp->win       = -1;
+    fp->win_dirty = 0;
+    ff_stub_last_us = 0.0;
+    return FR_OK;
+}
+
+FRESULT f_close(FIL *fp)
+{
+    FRESULT res = f_sync(fp);
+    fclose(fp->fp);
+    fp->fp = NULL;
+    return res;
+}
+
+FRESULT f_lseek(FIL *fp, FSIZE_t ofs)
+{
+    ff_stub_last_us = 0.0;
+    fp->fptr = ofs;
+    return FR_OK;
+}
+
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw)
+{
+    ff_stub_last_us = 0.0;
+    if (!fp->fp) return FR_INVALID_OBJECT;
+
+    fseek(fp->fp, (long)fp->fptr, SEEK_SET);
+    *bw = (UINT)fwrite(buff, 1, btw, fp->fp);
+
+    FSIZE_t pos = fp->fptr, end = fp->fptr + btw;
+    ff_stub_writes++;
+    if (pos % FF_STUB_SECTOR != 0u || end % FF_STUB_SECTOR != 0u) ff_stub_unaligned++;
+    while (pos < end)
+    {
+        int64_t  s    = pos / FF_STUB_SECTOR;
+        FSIZE_t  next = (FSIZE_t)(s + 1) * FF_STUB_SECTOR;
+        if (pos % FF_STUB_SECTOR == 0u && next <= end)
+        {
+            /* Whole sectors: one direct multi-sector command */
+            uint32_t n = (end - pos) / FF_STUB_SECTOR;
+            if (fp->win >= s && fp->win < s + n) { fp->win = -1; fp->win_dirty = 0; }
+            disk_write(n);
+            pos += n * FF_STUB_SECTOR;
+        }
+        else
+        {
+            win_move(fp, s);
+            fp->win_dirty = 1;
+            pos = (next < end) ? next : end;
+        }
+    }
+
+    fp->fptr = end;
+    if (end > fp->obj_size) fp->obj_size = end;
+    account();
+    return (*bw == btw) ? FR_OK : FR_DISK_ERR;
+}
+
+FRESULT f_sync(FIL *fp)
+{
+    ff_stub_last_us = 0.0;
+    if (!fp->fp) return FR_INVALID_OBJECT;
+    win_flush(fp);
+    disk_write(1u);                     /* directory entry: size, time */
+    fflush(fp->fp);
+    account();
+    return FR_OK;
+}
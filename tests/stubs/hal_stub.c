@@ -0,0 +1,126 @@
+/**
+ * @file    hal_stub.c
+ * @brief   Host implementations of the stubbed HAL entry points.
+ */
+
+#include "stm32f4xx_hal.h"
+#include <stddef.h>
+
+static USART_TypeDef usart2;
+
+UART_HandleTypeDef huart2 = { .Instance = &usart2 };
+ADC_HandleTypeDef  hadc1;
+
+uint32_t hal_stub_adc_value     = 2048u;
+uint32_t hal_stub_uart_tx_bytes = 0u;
+
+static uint32_t tick_ms;
+
+uint32_t HAL_GetTick(void)
+{
+    return tick_ms++;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef *hadc, uint32_t Timeout)
+{
+    (void)hadc;
+    (void)Timeout;
+    return HAL_OK;
+}
+
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    return hal_stub_adc_value;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    (void)htim;
+    (void)Channel;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    (void)htim;
+    (void)Channel;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData,
+                                    uint16_t Size, uint32_t Timeout)
+{
+    (void)huart;
+    (void)pData;
+    (void)Timeout;
+    hal_stub_uart_tx_bytes += Size;
+    return HAL_OK;
+}
+
+/* Transfers never complete on the host: the logger ring buffer simply
+ * fills up, which is what a saturated UART looks like on target. */
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData,
+                                       uint16_t Size)
+{
+    (void)huart;
+    (void)pData;
+    hal_stub_uart_tx_bytes += Size;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData,
+                                        uint16_t Size)
+{
+    return HAL_UART_Transmit_IT(huart, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData,
+                                   uint16_t Size, uint32_t Timeout)
+{
+    (void)huart;
+    (void)pData;
+    (void)Size;
+    (void)Timeout;
+    return HAL_TIMEOUT;
+}
+
+static uint8_t *rx_target;
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData,
+                                      uint16_t Size)
+{
+    (void)huart;
+    (void)Size;
+    rx_target = pData;
+    return HAL_OK;
+}
+
+/* Weak, as in the HAL: builds without the logger's receiver still link */
+__attribute__((weak)) void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+void hal_stub_uart_rx(const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        uint8_t *p = rx_target;
+        if (p == NULL) continue;
+        rx_target = NULL;
+        *p = data[i];
+        HAL_UART_RxCpltCallback(&huart2);
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file    stm32f4xx_hal.h
+ * @brief   Host stand-in for the handful of HAL symbols the portable
+ *          modules touch, so they can be unit tested and benchmarked.
+ */
+
+#ifndef STM32F4XX_HAL_STUB_H
+#define STM32F4XX_HAL_STUB_H
+
+#include <stdint.h>
+
+#define __IO volatile
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+typedef enum
+{
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct { uint32_t dummy; } USART_TypeDef;
+
+typedef struct
+{
+    USART_TypeDef *Instance;
+    uint16_t       TxXferSize;
+} UART_HandleTypeDef;
+
+typedef struct { uint32_t dummy; } ADC_HandleTypeDef;
+
+/* Timer registers the PWM driver writes; tests read CCRx back */
+typedef struct
+{
+    __IO uint32_t DIER;
+    __IO uint32_t SR;
+    __IO uint32_t CCR1, CCR2, CCR3, CCR4;
+} TIM_TypeDef;
+
+typedef struct { uint32_t Period; } TIM_Base_InitTypeDef;
+
+typedef struct
+{
+    TIM_TypeDef         *Instance;
+    TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+#define TIM_CHANNEL_1     0x00000000U
+#define TIM_CHANNEL_2     0x00000004U
+#define TIM_CHANNEL_3     0x00000008U
+#define TIM_CHANNEL_4     0x0000000CU
+#define TIM_IT_UPDATE     0x00000001U
+
+#define __HAL_TIM_SET_COMPARE(h, ch, v)  (*(&(h)->Instance->CCR1 + (ch) / 4U) = (v))
+#define __HAL_TIM_ENABLE_IT(h, it)       ((h)->Instance->DIER |= (it))
+#define __HAL_TIM_DISABLE_IT(h, it)      ((h)->Instance->DIER &= ~(it))
+
+/* Interrupt mask: nothing preempts a host test.  arm_math.h brings the
+ * CMSIS versions along; those are only declared, never run, on the host */
+#ifndef __CMSIS_GCC_H
+static inline uint32_t __get_PRIMASK(void) { return 0U; }
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+static inline void __disable_irq(void) { }
+#endif
+
+/* Raw value returned by HAL_ADC_GetValue(); tests set it directly */
+extern uint32_t hal_stub_adc_value;
+
+/* Bytes handed to HAL_UART_Transmit*(); tests may inspect/reset it */
+extern uint32_t hal_stub_uart_tx_bytes;
+
+uint32_t          HAL_GetTick(void);
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef *hadc, uint32_t Timeout);
+uint32_t          HAL_ADC_GetValue(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData,
+                                    uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData,
+                                       uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData,
+                                        uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData,
+                                   uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData,
+                                      uint16_t Size);
+void              HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void              HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+/* Deliver bytes as the UART would: one RxCplt interrupt per byte into
+ * the buffer of the pending HAL_UART_Receive_IT(); bytes arriving with
+ * no reception pending are lost (an overrun) */
+void hal_stub_uart_rx(const uint8_t *data, uint32_t len);
+
+#endif /* STM32F4XX_HAL_STUB_H */
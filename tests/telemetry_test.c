@@ -0,0 +1,193 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "../02-proportional-control/Core/Inc/telemetry.h"
+#include "../02-proportional-control/Core/Inc/pid.h"
+#include "led_plant.h"
+
+#define CH      TELEMETRY_CHANNELS
+#define MAXS    4096u
+
+/* --- Reference decoder (mirrors uart_plotter/telemetry_decode.py) --- */
+static size_t cobs_decode(const uint8_t *in, size_t n, uint8_t *out)
+{
+    size_t r = 0u, w = 0u;
+    while (r < n)
+    {
+        uint8_t code = in[r++];
+        assert(code != 0u);
+        for (uint8_t i = 1; i < code; i++) out[w++] = in[r++];
+        if (code < 0xFFu && r < n) out[w++] = 0u;
+    }
+    return w;
+}
+
+static uint32_t get_varint(const uint8_t *p, size_t *pos)
+{
+    uint32_t z = 0u;
+    for (uint32_t shift = 0;; shift += 7)
+    {
+        uint8_t b = p[(*pos)++];
+        z |= (uint32_t)(b & 0x7Fu) << shift;
+        if (!(b & 0x80u)) return z;
+    }
+}
+
+static uint64_t get_varint64(const uint8_t *p, size_t *pos)
+{
+    uint64_t z = 0u;
+    for (uint32_t shift = 0;; shift += 7)
+    {
+        uint8_t b = p[(*pos)++];
+        z |= (uint64_t)(b & 0x7Fu) << shift;
+        if (!(b & 0x80u)) return z;
+    }
+}
+
+/* Decode one wire frame; returns the number of samples appended */
+static uint32_t decode_frame(const uint8_t *wire, size_t n, int32_t (*out)[CH], uint8_t *seq,
+                             uint64_t *stamp)
+{
+    static uint8_t frame[TELEMETRY_FRAME_MAX];
+    assert(n >= 4u && wire[0] == 0u && wire[n - 1u] == 0u);
+    for (size_t i = 1; i + 1u < n; i++) assert(wire[i] != 0u);
+
+    size_t len = cobs_decode(wire + 1, n - 2u, frame);
+    size_t pos = 2u;
+    *seq = frame[0];
+    uint32_t count = frame[1];
+    *stamp = get_varint64(frame, &pos);
+    for (uint32_t s = 0; s < count; s++)
+        for (uint32_t ch = 0; ch < CH; ch++) {
+            int32_t v = telemetry_unzigzag(get_varint(frame, &pos));
+            out[s][ch] = s ? (int32_t)((uint32_t)out[s - 1u][ch] + (uint32_t)v) : v;
+        }
+    assert(pos == len);
+    return count;
+}
+
+static uint32_t lcg = 12345u;
+static uint32_t rnd(void) { return lcg = lcg * 1664525u + 1013904223u; }
+
+static int32_t samples[MAXS][CH];
+static int32_t decoded[MAXS][CH];
+
+/* Sample i at 100 Hz of a 180 MHz cycle count that started near a wrap */
+static uint64_t stamp_of(uint32_t i) { return 0xFFF00000u + (uint64_t)i * 1800000u; }
+
+/* Encode n samples, decode the stream, check it, return wire bytes */
+static size_t round_trip(uint32_t n)
+{
+    static telemetry_t t;
+    uint8_t wire[TELEMETRY_WIRE_MAX];
+    uint32_t got = 0u;
+    size_t bytes = 0u;
+    uint8_t seq, expect = 0u;
+    uint64_t stamp;
+
+    telemetry_init(&t);
+    for (uint32_t i = 0; i < n; i++) {
+        bool full = telemetry_put(&t, samples[i], stamp_of(i));
+        if (full || i + 1u == n) {
+            size_t w = telemetry_flush(&t, wire, sizeof wire);
+            assert(w > 0u && w <= TELEMETRY_WIRE_MAX);
+            uint32_t first = got;
+            got += decode_frame(wire, w, &decoded[got], &seq, &stamp);
+            assert(seq == expect++);
+            assert(stamp == stamp_of(first));       /* the keyframe's time */
+            bytes += w;
+        }
+    }
+    assert(got == n);
+    assert(memcmp(samples, decoded, n * sizeof(samples[0])) == 0);
+    assert(telemetry_flush(&t, wire, sizeof wire) == 0u);      /* nothing pending */
+    return bytes;
+}
+
+int main(void) {
+    // Zig-zag: small magnitudes first, both ends of the range round-trip
+    {
+        assert(telemetry_zigzag(0) == 0u && telemetry_zigzag(-1) == 1u);
+        assert(telemetry_zigzag(1) == 2u && telemetry_zigzag(-64) == 127u);
+        const int32_t v[] = { 0, 1, -1, 63, -64, 64, INT32_MAX, INT32_MIN };
+        for (size_t i = 0; i < sizeof v / sizeof v[0]; i++)
+            assert(telemetry_unzigzag(telemetry_zigzag(v[i])) == v[i]);
+    }
+
+    // COBS: zero-free between the delimiters, including 254+ byte runs
+    {
+        static uint8_t in[600], wire[700], back[600];
+        for (size_t n = 0; n < sizeof in; n += 37) {
+            for (size_t i = 0; i < n; i++) in[i] = (rnd() >> 24) % 4u ? (uint8_t)(1u + i % 255u) : 0u;
+            size_t w = telemetry_cobs(in, n, wire, sizeof wire);
+            assert(w >= n + 3u && w <= n + n / 254u + 3u);
+            for (size_t i = 1; i + 1u < w; i++) assert(wire[i] != 0u);
+            assert(cobs_decode(wire + 1, w - 2u, back) == n);
+            assert(memcmp(in, back, n) == 0);
+        }
+        memset(in, 0xAA, 508);
+        size_t w = telemetry_cobs(in, 508, wire, sizeof wire);
+        assert(w == 508u + 2u + 3u);
+        assert(cobs_decode(wire + 1, w - 2u, back) == 508u && memcmp(in, back, 508) == 0);
+        assert(telemetry_cobs(in, 508, wire, 512) == 0u);           /* too small */
+
+        /* The firmware's decoder, used for received frames */
+        assert(telemetry_uncobs(wire + 1, w - 2u, back, sizeof back) == 508u);
+        assert(memcmp(in, back, 508) == 0);
+        assert(telemetry_uncobs(wire + 1, w - 2u, back, 507u) == 0u);   /* too small */
+        const uint8_t bad_zero[] = { 0x03u, 0x11u, 0x00u };
+        const uint8_t bad_code[] = { 0x05u, 0x11u, 0x22u };
+        assert(telemetry_uncobs(bad_zero, sizeof bad_zero, back, sizeof back) == 0u);
+        assert(telemetry_uncobs(bad_code, sizeof bad_code, back, sizeof back) == 0u);
+        const uint8_t zeros[] = { 0x01u, 0x01u, 0x02u, 0x07u };         /* 00 00 07 */
+        assert(telemetry_uncobs(zeros, sizeof zeros, back, sizeof back) == 3u);
+        assert(back[0] == 0u && back[1] == 0u && back[2] == 7u);
+    }
+
+    // Extreme values and jumps survive the delta coding
+    {
+        const int32_t ext[] = { INT32_MIN, INT32_MAX, 0, -1, INT32_MIN, 1 };
+        for (uint32_t i = 0; i < 100u; i++)
+            for (uint32_t ch = 0; ch < CH; ch++)
+                samples[i][ch] = (i % 7u == 3u) ? ext[(i + ch) % 6u] : (int32_t)rnd();
+        round_trip(100u);
+        round_trip(TELEMETRY_BATCH);            /* exactly one frame */
+        round_trip(1u);                         /* keyframe only     */
+    }
+
+    // A recorded closed-loop run: 02's P controller on the LED model with
+    // ADC noise, setpoint steps every 5 s; raw counts, duty and error in
+    // hundredths of a percent
+    {
+        pid_t ctrl;
+        led_plant_t plant;
+        led_plant_init(&plant);
+        const uint32_t n = MAXS;
+        size_t text = 0u;
+        for (uint32_t i = 0; i < n; i++) {
+            pid_init(&ctrl, 1.2f, ((i / 500u) & 1u) ? 70.0f : 40.0f, 0.0f, 100.0f);
+            float noise = (float)((int32_t)(rnd() >> 28) - 8) * 0.1f;   /* ±0.8 % */
+            float y     = plant.y + noise;
+            float u     = pid_compute(&ctrl, y);
+            led_plant_step(&plant, u, 0.01f);
+
+            samples[i][0] = (int32_t)(y * 40.95f + 0.5f);
+            samples[i][1] = (int32_t)(u * 100.0f + 0.5f);
+            samples[i][2] = (int32_t)((ctrl.setpoint - y) * 100.0f + (y < ctrl.setpoint ? 0.5f : -0.5f));
+
+            char line[64];
+            text += (size_t)snprintf(line, sizeof line, "telemetry,%ld,%ld,%ld\n",
+                                     (long)samples[i][0], (long)samples[i][1], (long)samples[i][2]);
+        }
+        size_t bin = round_trip(n);
+        float ratio = (float)text / (float)bin;
+        printf("recorded loop, %u samples: text %.1f B/sample, binary %.2f B/sample, "
+               "ratio %.2f; at 115200 baud %.0f vs %.0f samples/s\n",
+               (unsigned)n, (double)text / n, (double)bin / n, ratio,
+               11520.0 * n / text, 11520.0 * n / bin);
+        assert(ratio >= 3.0f);
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include "../03-pi-control/Core/Inc/waveform.h"
+
+#define COUNTS  1000u       /* 03's TIM2: Period = 1000-1 */
+
+/* Circular DMA over the buffer: the half-transfer and transfer-complete
+ * interrupts refill the half that was just played */
+static uint32_t dma_pos;
+
+static uint32_t dma_update(waveform_t *wf)
+{
+    uint32_t v = wf->buf[dma_pos++];
+    if (dma_pos == WAVEFORM_HALF_LEN) waveform_refill(wf, 0u);
+    if (dma_pos == WAVEFORM_BUF_LEN)
+    {
+        waveform_refill(wf, 1u);
+        dma_pos = 0u;
+    }
+    return v;
+}
+
+static void start(waveform_t *wf)
+{
+    waveform_prime(wf);
+    dma_pos = 0u;
+}
+
+static uint32_t counts_of(float duty) {
+    return (uint32_t)(duty * COUNTS / 100.0f + 0.5f);
+}
+
+int main(void) {
+    static waveform_t wf;
+
+    // Idle output after init is 0 %
+    waveform_init(&wf, COUNTS, 1u);
+    start(&wf);
+    for (int i = 0; i < 300; i++) assert(dma_update(&wf) == 0u);
+
+    // A looping triangle plays back sample-exact across every half refill
+    {
+        static const waveform_point_t tri[] = {
+            { 0.0f, 100u }, { 100.0f, 100u }, { 0.0f, 0u } };
+        waveform_load_pwl(&wf, tri, 3u, true);
+        start(&wf);
+        for (uint32_t k = 0; k < 1000u; k++) {
+            uint32_t n = k % 200u;
+            float d = (n < 100u) ? (float)n : 100.0f - (float)(n - 100u);
+            assert(dma_update(&wf) == counts_of(d));
+        }
+        assert(!wf.done);
+        assert(wf.refills == 2u + 1000u / WAVEFORM_HALF_LEN);
+    }
+
+    // hold stretches each sample over several PWM periods
+    {
+        static const waveform_point_t ramp[] = { { 0.0f, 10u }, { 50.0f, 0u } };
+        waveform_init(&wf, COUNTS, 7u);
+        waveform_load_pwl(&wf, ramp, 2u, false);
+        start(&wf);
+        for (uint32_t k = 0; k < 70u; k++)
+            assert(dma_update(&wf) == counts_of(5.0f * (float)(k / 7u)));
+        for (uint32_t k = 0; k < 200u; k++)
+            assert(dma_update(&wf) == counts_of(50.0f));      /* holds the end */
+        assert(wf.done);
+    }
+
+    // A calibration staircase: zero-length segments are steps
+    {
+        static const waveform_point_t stairs[] = {
+            { 10.0f, 50u }, { 10.0f, 0u }, { 40.0f, 50u }, { 40.0f, 0u },
+            { 70.0f, 50u }, { 70.0f, 0u }, { 100.0f, 0u } };
+        waveform_init(&wf, COUNTS, 1u);
+        waveform_load_pwl(&wf, stairs, 7u, false);
+        start(&wf);
+        for (uint32_t k = 0; k < 300u; k++) {
+            float d = (k < 50u) ? 10.0f : (k < 100u) ? 40.0f : (k < 150u) ? 70.0f : 100.0f;
+            assert(dma_update(&wf) == counts_of(d));
+        }
+        assert(wf.done);
+    }
+
+    // Degenerate profiles do not hang the interrupt
+    {
+        static const waveform_point_t empty[] = { { 20.0f, 0u }, { 30.0f, 0u } };
+        waveform_load_pwl(&wf, empty, 2u, true);
+        start(&wf);
+        for (int i = 0; i < 200; i++) assert(dma_update(&wf) == counts_of(20.0f));
+    }
+
+    // Chirp: inside offset ± amplitude, and the cycle count of a linear sweep
+    {
+        const float fs = 1000.0f, f0 = 1.0f, f1 = 20.0f;
+        const uint32_t len = 4000u;
+        waveform_load_chirp(&wf, 50.0f, 20.0f, f0, f1, fs, len, false);
+        start(&wf);
+        uint32_t crossings = 0u, prev = counts_of(50.0f);
+        for (uint32_t k = 0; k < len; k++) {
+            uint32_t v = dma_update(&wf);
+            assert(v >= counts_of(30.0f) && v <= counts_of(70.0f));
+            if (prev < counts_of(50.0f) && v >= counts_of(50.0f)) crossings++;
+            prev = v;
+        }
+        float cycles = 0.5f * (f0 + f1) * (float)len / fs;    /* 42 */
+        printf("chirp: %u upward crossings, %.1f cycles expected\n", crossings, cycles);
+        assert(fabsf((float)crossings - cycles) <= 1.0f);
+        for (int i = 0; i < 200; i++) assert(dma_update(&wf) == counts_of(50.0f));
+        assert(wf.done);
+    }
+
+    // The CPU only runs once per half buffer
+    {
+        static const waveform_point_t tri[] = {
+            { 0.0f, 10000u }, { 100.0f, 10000u }, { 0.0f, 0u } };
+        waveform_init(&wf, COUNTS, 1u);
+        waveform_load_pwl(&wf, tri, 3u, true);
+        start(&wf);
+        for (uint32_t k = 0; k < 20000u; k++) (void)dma_update(&wf);
+        printf("20000 PWM periods: %lu refills of %u samples\n",
+               (unsigned long)wf.refills, (unsigned)WAVEFORM_HALF_LEN);
+        assert(wf.refills == 2u + 20000u / WAVEFORM_HALF_LEN);
+    }
+
+    return 0;
+}
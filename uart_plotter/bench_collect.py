@@ -0,0 +1,117 @@
+"""Collect on-target benchmark results into JSON.
+
+Reads the `bench_begin` / `bench,...` / `bench_end` lines emitted by the
+03-pi-control benchmark firmware, either from a serial port or from stdin
+(e.g. piped from qemu), and writes them as JSON.
+
+    python bench_collect.py --serial-port /dev/ttyACM0 --json bench.json
+    Bench/run_qemu.sh bench.elf | python bench_collect.py --json bench.json
+
+With --compare, the median and max of each case are printed relative to
+an earlier result file, e.g. a flash-only build (USE_RAMFUNC=OFF) against
+the default SRAM-placed one:
+
+    python bench_collect.py --serial-port /dev/ttyACM0 --compare flash.json
+
+Cases the firmware announced a `budget,<name>,<cycles>` for (the Kalman
+filter against KALMAN_CYCLE_BUDGET) are marked OVER when their max, warm
+or cold, exceeds it; the exit status is then 1.
+"""
+
+import argparse
+import json
+import sys
+
+BAUD_RATE = 250000
+
+
+def parse(lines):
+    result = {"core_hz": None, "timer": None, "placement": None, "budgets": {}, "cases": []}
+    for raw in lines:
+        line = raw.strip()
+        if line.startswith("bench_begin,"):
+            fields = line.split(",")
+            result["core_hz"] = int(fields[1])
+            result["timer"] = fields[2]
+            if len(fields) > 3:
+                result["placement"] = fields[3]
+        elif line.startswith("budget,"):
+            _, name, cycles = line.split(",")
+            result["budgets"][name] = int(cycles)
+        elif line.startswith("bench,"):
+            _, name, runs, lo, med, hi = line.split(",")
+            result["cases"].append({
+                "name": name,
+                "runs": int(runs),
+                "min": int(lo),
+                "median": int(med),
+                "max": int(hi),
+            })
+        elif line == "bench_end":
+            break
+    return result
+
+
+def over_budget(result, case):
+    budget = result["budgets"].get(case["name"].removesuffix("_cold"))
+    return budget is not None and case["max"] > budget
+
+
+def serial_lines(port):
+    import serial
+    with serial.Serial(port, BAUD_RATE, timeout=5) as ser:
+        while True:
+            line = ser.readline().decode("utf-8", errors="ignore")
+            if not line:
+                return
+            yield line
+
+
+def compare(result, base):
+    """Print median / max of each case as a ratio to the baseline run."""
+    ref = {c["name"]: c for c in base["cases"]}
+    print(f"{'case':<22} {'median':>16} {'max':>16}   "
+          f"[{result['placement']} vs {base['placement']}]", file=sys.stderr)
+    for case in result["cases"]:
+        b = ref.get(case["name"])
+        if not b:
+            continue
+        cells = []
+        for key in ("median", "max"):
+            ratio = case[key] / b[key] if b[key] else float("nan")
+            cells.append(f"{b[key]:>6}->{case[key]:<6} x{ratio:.2f}")
+        print(f"{case['name']:<22} {cells[0]:>16} {cells[1]:>16}", file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Collect benchmark results")
+    parser.add_argument("--serial-port", help="Read from this serial device instead of stdin")
+    parser.add_argument("--json", help="Write results to this file (default: stdout)")
+    parser.add_argument("--compare", help="Earlier result file to compare against")
+    args = parser.parse_args()
+
+    source = serial_lines(args.serial_port) if args.serial_port else sys.stdin
+    result = parse(source)
+
+    for case in result["cases"]:
+        flag = "  OVER" if over_budget(result, case) else ""
+        print(f"{case['name']:<18} min {case['min']:>7}  median {case['median']:>7}  "
+              f"max {case['max']:>7}  [{result['timer']}]{flag}", file=sys.stderr)
+
+    if args.compare:
+        with open(args.compare) as f:
+            compare(result, json.load(f))
+
+    text = json.dumps(result, indent=2)
+    if args.json:
+        with open(args.json, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+
+    if any(over_budget(result, case) for case in result["cases"]):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
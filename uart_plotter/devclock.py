@@ -0,0 +1,97 @@
+"""Map the firmware's cycle time stamps to host wall time.
+
+02-proportional-control starts every log record with `@<hex>:`, the
+64-bit TIM5 count when the record was made (see logger.h).  Once a
+second, while its UART is idle, it sends `@<hex>:sync,<hz>`.  A
+sync record starts to leave as it is stamped, so its arrival time, less
+its own transmission time, is the device time plus the host's read
+latency, and that latency only ever adds.
+
+DeviceClock fits  host = offset + rate * cycles  through the sync
+points of a sliding window.  The rate comes from a least-squares fit:
+the MCU crystal and the host clock differ by tens of ppm, a few
+milliseconds per minute.  The fit is repeated over the quarter of the
+points with the least latency, which follow the clocks more closely.
+The offset comes from the lower envelope, the sync that arrived the
+soonest.  A record is then placed at the time it was made, not when the
+host happened to read it:
+
+    clock = DeviceClock()
+    cycles, text = split_stamp(line)
+    if text.startswith("sync,"):
+        clock.add_sync(cycles, int(text[5:]), arrival, len(raw_line))
+    t = clock.to_host(cycles)           # None before the first sync
+
+A device reset is noticed at its first sync record, when the count goes
+backwards; records in between are mapped with the old fit.
+"""
+
+import re
+from collections import deque
+
+STAMP = re.compile(r"^@([0-9a-f]{1,16}):")
+BAUD_RATE = 115200
+BITS_PER_BYTE = 10              # 8N1
+MAX_DRIFT_PPM = 500             # beyond this a fit is noise, not a crystal
+
+
+def slope(points):
+    """Least-squares dt/dcycles, or None if the cycles do not vary."""
+    n = len(points)
+    c0, t0 = points[0]
+    mc = sum(c - c0 for c, _ in points) / n
+    mt = sum(t - t0 for _, t in points) / n
+    sxx = sum((c - c0 - mc) ** 2 for c, _ in points)
+    sxy = sum((c - c0 - mc) * (t - t0 - mt) for c, t in points)
+    return sxy / sxx if sxx > 0 else None
+
+
+def split_stamp(line):
+    """Return (cycles, text after the prefix); cycles is None if unstamped."""
+    m = STAMP.match(line)
+    if not m:
+        return None, line
+    return int(m.group(1), 16), line[m.end():]
+
+
+class DeviceClock:
+    def __init__(self, window=120, baud=BAUD_RATE):
+        self.points = deque(maxlen=window)  # (cycles, host time it was sent)
+        self.baud = baud
+        self.hz = None
+        self.rate = None                    # host seconds per cycle
+        self.offset = None
+
+    def add_sync(self, cycles, hz, arrival, size):
+        """Add a sync record of `size` bytes, newline included, read at `arrival`."""
+        if hz != self.hz or (self.points and cycles <= self.points[-1][0]):
+            self.points.clear()             # first sync, or the device restarted
+        self.hz = hz
+        self.points.append((cycles, arrival - size * BITS_PER_BYTE / self.baud))
+        self._fit()
+
+    def _fit(self):
+        nominal = 1.0 / self.hz
+        rate = nominal
+        points = list(self.points)
+        if len(points) >= 3:
+            fit = slope(points)
+            if fit is not None:
+                latency = sorted(t - fit * c for c, t in points)
+                cut = latency[len(latency) // 4]
+                fit = slope([(c, t) for c, t in points if t - fit * c <= cut] or points)
+            if fit is not None and abs(fit / nominal - 1.0) * 1e6 <= MAX_DRIFT_PPM:
+                rate = fit
+        self.rate = rate
+        self.offset = min(t - rate * c for c, t in self.points)
+
+    @property
+    def drift_ppm(self):
+        """How much faster the device clock runs than the host's."""
+        return None if self.rate is None else (1.0 / (self.rate * self.hz) - 1.0) * 1e6
+
+    def to_host(self, cycles):
+        """Host time (time.time() scale) at which the device read `cycles`."""
+        if cycles is None or self.rate is None:
+            return None
+        return self.offset + self.rate * cycles
@@ -0,0 +1,124 @@
+"""Rebuild uniform time series from report-on-change telemetry.
+
+02-proportional-control reports a channel only when it leaves its
+deadband or its heartbeat is due (see onchange.h):
+
+    chg_cfg,<channel>,<deadband>,<max_ms>       once, at start-up
+    chg,<ms>,<mask>,<value of each set bit>     when something changed
+
+This tool holds each reported value until the next report and writes
+one CSV row per grid step, so the series can be plotted or compared like
+a fixed-rate log.  A held value is never further than the deadband from
+what the firmware sampled.  A channel that has missed two heartbeats is
+left empty until it is reported again, since lines were lost.
+
+    python onchange_rebuild.py --serial-port /dev/ttyACM0 --csv chg.csv
+    python onchange_rebuild.py < session.log --csv chg.csv --period-ms 10
+
+Other log lines and the binary telemetry frames are ignored.
+"""
+
+import argparse
+import csv
+import re
+import sys
+
+BAUD_RATE = 115200
+HEADER = ["Time (ms)", "Raw", "Duty (%)", "Error (%)"]
+SCALE = [1, 100, 100]           # raw counts, duty and error in hundredths
+
+CFG = re.compile(rb"chg_cfg,(\d+),(-?\d+),(\d+)")
+CHG = re.compile(rb"chg,(\d+),(\d+)((?:,-?\d+)*)$")
+
+
+def parse(lines):
+    """Return ({channel: max_ms}, [(ms, {channel: value})]) with ms unwrapped."""
+    max_ms, reports = {}, []
+    wraps, prev = 0, None
+    for raw in lines:
+        line = raw.rstrip(b"\r\n")
+        m = CFG.search(line)
+        if m:
+            max_ms[int(m.group(1))] = int(m.group(3))
+            continue
+        m = CHG.search(line)
+        if not m:
+            continue
+        t, mask = int(m.group(1)), int(m.group(2))
+        values = [int(v) for v in m.group(3).split(b",")[1:]]
+        channels = [ch for ch in range(32) if mask >> ch & 1]
+        if len(values) != len(channels):
+            print(f"bad line: {line!r}", file=sys.stderr)
+            continue
+        if prev is not None and t < prev:
+            wraps += 1                      # 32-bit millisecond counter
+        prev = t
+        reports.append((t + (wraps << 32), dict(zip(channels, values))))
+    return max_ms, reports
+
+
+def rebuild(max_ms, reports, period_ms, channels=len(SCALE)):
+    """Yield (ms since the first report, [held value or None per channel])."""
+    if not reports:
+        return
+    held, seen = [None] * channels, [None] * channels
+    i, t0 = 0, reports[0][0]
+    t = t0
+    while t <= reports[-1][0]:
+        while i < len(reports) and reports[i][0] <= t:
+            for ch, v in reports[i][1].items():
+                if ch < channels:
+                    held[ch], seen[ch] = v, reports[i][0]
+            i += 1
+        row = []
+        for ch in range(channels):
+            limit = 2 * max_ms.get(ch, 0)
+            stale = limit and seen[ch] is not None and t - seen[ch] > limit
+            row.append(None if stale else held[ch])
+        yield t - t0, row
+        t += period_ms
+
+
+def serial_lines(port):
+    import serial
+    with serial.Serial(port, BAUD_RATE, timeout=1) as ser:
+        try:
+            while True:
+                line = ser.readline()
+                if line:
+                    yield line
+        except KeyboardInterrupt:
+            return
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Rebuild report-on-change telemetry")
+    parser.add_argument("--serial-port", help="Read from this serial device (Ctrl-C ends)")
+    parser.add_argument("--input", help="Read a recorded log (default: stdin)")
+    parser.add_argument("--csv", help="Write the series here (default: stdout)")
+    parser.add_argument("--period-ms", type=int, default=10,
+                        help="Grid step, the firmware's control period (default: 10)")
+    args = parser.parse_args()
+
+    if args.serial_port:
+        lines = serial_lines(args.serial_port)
+    else:
+        lines = open(args.input, "rb") if args.input else sys.stdin.buffer
+
+    max_ms, reports = parse(lines)
+    out = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(HEADER)
+    rows = 0
+    for t, row in rebuild(max_ms, reports, args.period_ms):
+        writer.writerow([t] + ["" if v is None else v if s == 1 else v / s
+                               for v, s in zip(row, SCALE)])
+        rows += 1
+    if args.csv:
+        out.close()
+    print(f"{len(reports)} reports -> {rows} rows every {args.period_ms} ms",
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
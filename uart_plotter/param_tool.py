@@ -0,0 +1,165 @@
+"""Read and write the tunable parameters of 02-proportional-control.
+
+Talks the binary protocol of param.h over the firmware's UART: COBS
+frames between 0x00 bytes, each ending in a CRC-16/CCITT-FALSE.  The
+text log and telemetry frames on the same link are skipped.
+
+    python param_tool.py --serial-port /dev/ttyACM0 list
+    python param_tool.py --serial-port /dev/ttyACM0 get kp setpoint
+    python param_tool.py --serial-port /dev/ttyACM0 set kp=1.5 setpoint=40
+
+All values of one `set` travel in a single frame, so the controller
+applies them on the same tick, or none of them if one is rejected.  A
+request with no valid answer within --timeout is sent again.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+from telemetry_decode import cobs_decode
+
+BAUD_RATE = 115200
+GET, SET, LIST, RESPONSE = 0x01, 0x02, 0x03, 0x80
+TYPES = {0: ("f32", "<f"), 1: ("u32", "<I"), 2: ("i32", "<i")}
+STATUS = ["ok", "crc error", "unknown command", "bad length", "unknown id",
+          "read-only", "out of range"]
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out, block = bytearray(), bytearray()
+    for b in data:
+        if b:
+            block.append(b)
+        if not b or len(block) == 254:
+            out += bytes([len(block) + 1]) + block
+            block.clear()
+    out += bytes([len(block) + 1]) + block
+    return bytes(out)
+
+
+class ParamError(Exception):
+    pass
+
+
+class Link:
+    def __init__(self, ser, timeout, retries):
+        self.ser, self.timeout, self.retries = ser, timeout, retries
+        self.seq, self.block = 0, None
+
+    def _responses(self, deadline):
+        """Yield CRC-checked payloads of the frames received until deadline."""
+        while time.monotonic() < deadline:
+            for b in self.ser.read(self.ser.in_waiting or 1):
+                if b:
+                    if self.block is not None:
+                        self.block.append(b)
+                    continue
+                if self.block:
+                    try:
+                        p = cobs_decode(bytes(self.block))
+                        if len(p) >= 5 and crc16(p[:-2]) == p[-2] | p[-1] << 8:
+                            yield p
+                    except ValueError:
+                        pass
+                self.block = bytearray()
+
+    def request(self, cmd, body):
+        for _ in range(self.retries + 1):
+            self.seq = (self.seq + 1) & 0xFF
+            frame = bytes([cmd, self.seq]) + bytes(body)
+            frame += struct.pack("<H", crc16(frame))
+            self.ser.write(b"\x00" + cobs_encode(frame) + b"\x00")
+            for p in self._responses(time.monotonic() + self.timeout):
+                if p[0] == cmd | RESPONSE and p[1] == self.seq:
+                    if p[2] == 1:           # crc error: the request was damaged
+                        break
+                    return p[2], p[3:-2]
+        raise ParamError("no answer")
+
+
+def list_params(link):
+    params, first = [], 0
+    while True:
+        status, body = link.request(LIST, [first])
+        if status:
+            raise ParamError(STATUS[status])
+        count, r = body[0], 1
+        while r < len(body):
+            pid, ptype, flags = body[r:r + 3]
+            lo, hi = struct.unpack("<ff", body[r + 3:r + 11])
+            n = body[r + 11]
+            name = body[r + 12:r + 12 + n].decode()
+            params.append({"id": pid, "type": ptype, "ro": bool(flags & 1),
+                           "min": lo, "max": hi, "name": name})
+            r += 12 + n
+        if len(params) >= count or r == 1:
+            return params
+        first = len(params)
+
+
+def lookup(params, key):
+    for p in params:
+        if p["name"] == key or str(p["id"]) == key:
+            return p
+    raise ParamError(f"no parameter {key!r}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Parameter get/set/list over UART")
+    parser.add_argument("--serial-port", required=True, help="Serial device")
+    parser.add_argument("--timeout", type=float, default=0.2, help="Seconds per attempt")
+    parser.add_argument("--retries", type=int, default=3, help="Attempts after the first")
+    parser.add_argument("command", choices=["list", "get", "set"])
+    parser.add_argument("args", nargs="*", help="Names or IDs; name=value for set")
+    args = parser.parse_args()
+
+    import serial
+    with serial.Serial(args.serial_port, BAUD_RATE, timeout=0.01) as ser:
+        link = Link(ser, args.timeout, args.retries)
+        try:
+            params = list_params(link)
+            if args.command == "list":
+                for p in params:
+                    print(f"{p['id']:3d} {p['name']:<16} {TYPES[p['type']][0]} "
+                          f"[{p['min']:g}, {p['max']:g}]{' read-only' if p['ro'] else ''}")
+            elif args.command == "get":
+                wanted = [lookup(params, k) for k in (args.args or [p["name"] for p in params])]
+                status, body = link.request(GET, [p["id"] for p in wanted])
+                if status:
+                    raise ParamError(STATUS[status])
+                for k in range(0, len(body), 6):
+                    p = lookup(params, str(body[k]))
+                    value = struct.unpack(TYPES[body[k + 1]][1], body[k + 2:k + 6])[0]
+                    print(f"{p['name']} = {value:g}")
+            else:
+                body = bytearray()
+                for item in args.args:
+                    key, _, text = item.partition("=")
+                    p = lookup(params, key)
+                    fmt = TYPES[p["type"]][1]
+                    value = float(text) if fmt == "<f" else int(text, 0)
+                    body += bytes([p["id"]]) + struct.pack(fmt, value)
+                status, reply = link.request(SET, body)
+                if status:
+                    name = lookup(params, str(reply[0]))["name"] if reply else ""
+                    raise ParamError(f"{STATUS[status]} {name}".strip())
+                print("ok")
+        except ParamError as e:
+            print(f"error: {e}", file=sys.stderr)
+            sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,104 @@
+"""Save the capture windows of the on-device scope as CSV.
+
+Reads the `scope_begin` / `scope,...` / `scope_end` blocks that
+02-proportional-control prints after each trigger (see capture.h), either
+from a serial port or from stdin, and writes one CSV per window:
+
+    python scope_collect.py --serial-port /dev/ttyACM0
+    python scope_collect.py < session.log --plot
+
+Times are in microseconds relative to the trigger sample, taken from the
+firmware's TIM5 stamps, so the loop's real sampling jitter is visible.  Other
+log lines are ignored.
+"""
+
+import argparse
+import csv
+import sys
+from datetime import datetime
+
+from devclock import split_stamp
+
+BAUD_RATE = 115200
+CAUSES = {1: "setpoint", 2: "error", 4: "saturation", 8: "force"}
+
+
+def cause_names(bits):
+    return "+".join(name for bit, name in CAUSES.items() if bits & bit) or "none"
+
+
+def windows(lines):
+    """Yield (header, rows) for every complete window in the stream."""
+    header, rows = None, []
+    for raw in lines:
+        _, line = split_stamp(raw.strip())
+        if line.startswith("scope_begin,"):
+            core_hz, cause, count, trig = (int(v) for v in line.split(",")[1:5])
+            header = {"core_hz": core_hz, "cause": cause, "count": count, "trigger": trig}
+            rows = []
+        elif line.startswith("scope,") and header:
+            dt, raw_adc, filt, duty, integ = (int(v) for v in line.split(",")[1:6])
+            rows.append((dt * 1e6 / header["core_hz"], raw_adc,
+                         filt / 1000.0, duty / 1000.0, integ / 1000.0))
+        elif line == "scope_end" and header:
+            if rows and len(rows) == header["count"]:
+                yield header, rows
+            else:
+                print(f"dropped window: {len(rows)} of {header['count']} samples",
+                      file=sys.stderr)
+            header = None
+
+
+def serial_lines(port):
+    import serial
+    with serial.Serial(port, BAUD_RATE, timeout=5) as ser:
+        while True:
+            line = ser.readline().decode("utf-8", errors="ignore")
+            if line:
+                yield line
+
+
+def plot(rows, title):
+    import matplotlib.pyplot as plt
+    t = [r[0] / 1000.0 for r in rows]
+    fig, (ax_y, ax_u) = plt.subplots(2, 1, sharex=True)
+    ax_y.plot(t, [r[2] for r in rows], label="Filtered")
+    ax_y.set_ylabel("Reading (%)")
+    ax_u.plot(t, [r[3] for r in rows], label="Duty (%)", color="blue")
+    ax_u.plot(t, [r[4] for r in rows], label="Integral", color="gray")
+    ax_u.set_xlabel("Time from trigger (ms)")
+    for ax in (ax_y, ax_u):
+        ax.axvline(0.0, color="red", linewidth=0.8)
+        ax.grid(True)
+        ax.legend(loc="upper right")
+    fig.suptitle(title)
+    plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Collect on-device scope captures")
+    parser.add_argument("--serial-port", help="Read from this serial device instead of stdin")
+    parser.add_argument("--prefix", default="scope", help="CSV file name prefix")
+    parser.add_argument("--plot", action="store_true", help="Plot each window as it arrives")
+    args = parser.parse_args()
+
+    source = serial_lines(args.serial_port) if args.serial_port else sys.stdin
+    stamp = datetime.now().strftime("%Y%m%d_%H%M%S")
+    for n, (header, rows) in enumerate(windows(source)):
+        name = f"{args.prefix}_{stamp}_{n:03d}.csv"
+        with open(name, "w", newline="") as f:
+            writer = csv.writer(f)
+            writer.writerow(["Time (us)", "Raw", "Filtered", "Duty (%)", "Integral"])
+            for t_us, raw_adc, filt, duty, integ in rows:
+                writer.writerow([f"{t_us:.2f}", raw_adc, filt, duty, integ])
+
+        period = (rows[-1][0] - rows[0][0]) / max(len(rows) - 1, 1)
+        cause = cause_names(header["cause"])
+        print(f"{name}: {cause}, {len(rows)} samples, {header['trigger']} before "
+              f"the trigger, mean period {period:.1f} us", file=sys.stderr)
+        if args.plot:
+            plot(rows, f"{cause} trigger")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,188 @@
+"""Decode the binary telemetry frames of 02-proportional-control.
+
+The firmware interleaves its text log with COBS frames between 0x00
+bytes (see telemetry.h).  This tool reads the raw byte stream from a
+serial port or a file, writes the samples to CSV and prints the text
+lines unchanged:
+
+    python telemetry_decode.py --serial-port /dev/ttyACM0 --csv tlm.csv
+    python telemetry_decode.py --input capture.bin --stats
+
+Frame payload: seq, n, the first sample's 64-bit time stamp as a
+varint, then n samples of CHANNELS zig-zag varints; the first sample is
+absolute, the others are deltas to the previous one.  The device time of
+each sample is the stamp plus its index times --period-ms, in seconds of
+the core clock that the `sync,<hz>` log records announce.
+
+--stats compares the bytes received with the text lines
+`telemetry,<a>,<b>,<c>` the same samples would have needed.
+"""
+
+import argparse
+import csv
+import sys
+
+from devclock import split_stamp
+
+BAUD_RATE = 115200
+CHANNELS = 3
+HEADER = ["Seq", "Device time (s)", "Raw", "Duty (%)", "Error (%)"]
+CORE_HZ = 90_000_000            # TIM5 rate, until a sync record says otherwise
+SCALE = [1, 100, 100]           # raw counts, duty and error in hundredths
+
+
+def cobs_decode(block):
+    out, i = bytearray(), 0
+    while i < len(block):
+        code = block[i]
+        if code == 0 or i + code > len(block):
+            raise ValueError("bad COBS block")
+        out += block[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(block):
+            out.append(0)
+    return bytes(out)
+
+
+def varint(data, pos):
+    """Return (value, next position) of the unsigned varint at pos."""
+    z, shift = 0, 0
+    while True:
+        b = data[pos]
+        pos += 1
+        z |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return z, pos
+
+
+def varints(data, pos):
+    while pos < len(data):
+        z, pos = varint(data, pos)
+        yield (z >> 1) ^ -(z & 1)
+
+
+def decode_frame(payload):
+    """Return (seq, stamp, samples) of one frame payload."""
+    seq, count = payload[0], payload[1]
+    stamp, pos = varint(payload, 2)
+    values = list(varints(payload, pos))
+    if len(values) != count * CHANNELS:
+        raise ValueError(f"frame {seq}: {len(values)} values for {count} samples")
+    samples, prev = [], None
+    for s in range(count):
+        row = values[s * CHANNELS:(s + 1) * CHANNELS]
+        if prev is not None:
+            row = [((p + d + 2**31) % 2**32) - 2**31 for p, d in zip(prev, row)]
+        samples.append(row)
+        prev = row
+    return seq, stamp, samples
+
+
+def split(stream):
+    """Yield ('text', line) and ('frame', wire_bytes, payload) items."""
+    text, frame, in_frame = bytearray(), bytearray(), False
+    for chunk in stream:
+        for b in chunk:
+            if not in_frame:
+                if b == 0:
+                    in_frame = True
+                elif b == 0x0A:
+                    line = text.decode("utf-8", errors="ignore").strip()
+                    if line:
+                        yield ("text", line)
+                    text.clear()
+                else:
+                    text.append(b)
+            elif b != 0:
+                frame.append(b)
+            elif frame:
+                try:
+                    yield ("frame", len(frame) + 2, cobs_decode(bytes(frame)))
+                    in_frame = False
+                except ValueError:
+                    pass        # joined mid-frame: this 0x00 opens the next one
+                frame.clear()
+
+
+def serial_chunks(port):
+    import serial
+    with serial.Serial(port, BAUD_RATE, timeout=1) as ser:
+        while True:
+            yield ser.read(ser.in_waiting or 1)
+
+
+def file_chunks(f):
+    while True:
+        chunk = f.read(4096)
+        if not chunk:
+            return
+        yield chunk
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode binary telemetry frames")
+    parser.add_argument("--serial-port", help="Read from this serial device")
+    parser.add_argument("--input", help="Read a recorded byte stream (default: stdin)")
+    parser.add_argument("--csv", help="Write the decoded samples here")
+    parser.add_argument("--stats", action="store_true",
+                        help="Report the size against the equivalent text lines")
+    parser.add_argument("--period-ms", type=float, default=10,
+                        help="Sampling period, the firmware's control period (default: 10)")
+    args = parser.parse_args()
+
+    if args.serial_port:
+        chunks = serial_chunks(args.serial_port)
+    else:
+        f = open(args.input, "rb") if args.input else sys.stdin.buffer
+        chunks = file_chunks(f)
+
+    out = open(args.csv, "w", newline="") if args.csv else None
+    writer = csv.writer(out) if out else None
+    if writer:
+        writer.writerow(HEADER)
+
+    frames = samples = wire = text = lost = 0
+    last_seq = first_stamp = None
+    core_hz = CORE_HZ
+    try:
+        for item in split(chunks):
+            if item[0] == "text":
+                print(item[1])
+                _, body = split_stamp(item[1])
+                if body.startswith("sync,"):
+                    core_hz = int(body[5:])
+                continue
+            _, size, payload = item
+            try:
+                seq, stamp, rows = decode_frame(payload)
+            except (ValueError, IndexError) as e:
+                print(f"bad frame: {e}", file=sys.stderr)
+                continue
+            if last_seq is not None:
+                lost += (seq - last_seq - 1) % 256
+            last_seq = seq
+            frames += 1
+            samples += len(rows)
+            wire += size
+            if first_stamp is None:
+                first_stamp = stamp
+            for i, row in enumerate(rows):
+                text += len("telemetry,{},{},{}\n".format(*row))
+                if writer:
+                    t = (stamp - first_stamp) / core_hz + i * args.period_ms / 1000.0
+                    writer.writerow([seq, f"{t:.6f}"] + [v / s for v, s in zip(row, SCALE)])
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if out:
+            out.close()
+
+    if args.stats and samples:
+        print(f"{frames} frames, {samples} samples, {lost} frames lost; "
+              f"{wire / samples:.2f} B/sample against {text / samples:.1f} as text, "
+              f"ratio {text / wire:.2f}", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -7,6 +7,8 @@ from datetime import datetime
 import matplotlib.pyplot as plt
 from matplotlib.animation import FuncAnimation
 
+from devclock import DeviceClock, split_stamp
+
 # === CONFIG ===
 DEFAULT_SERIAL_PORT = '/dev/tty.usbmodem1103'
 BAUD_RATE = 115200
@@ -26,7 +28,7 @@ SERIAL_PORT = args.serial_port
 csv_filename = f"log_{datetime.now().strftime('%Y%m%d_%H%M%S')}.csv"
 csvfile = open(csv_filename, 'w', newline='')
 writer = csv.writer(csvfile)
-writer.writerow(['Time (s)', 'Raw', 'Scaled', 'PWM (%)'])
+writer.writerow(['Time (s)', 'Arrival (s)', 'Raw', 'Scaled', 'PWM (%)'])
 
 # === PATTERNS ===
 photo_pattern = re.compile(r'Photocell read: raw=(\d+), scaled=true, value=(\d+)')
@@ -37,6 +39,11 @@ timestamps, raw_vals, scaled_vals, pwm_vals = [], [], [], []
 current_pwm = 0
 start_time = time.time()
 
+# Device time stamps (`@<hex>:` prefix) mapped to host time via the sync
+# records; lines without one, or before the first sync, use their arrival
+clock = DeviceClock(baud=BAUD_RATE)
+syncs = 0
+
 # === FLAGS FOR TOGGLING ===
 show_raw = True
 show_scaled = True
@@ -60,11 +67,23 @@ plt.tight_layout()
 
 # === PLOT UPDATE FUNCTION ===
 def update(frame):
-    global current_pwm
+    global current_pwm, syncs
 
     while ser.in_waiting:
-        line = ser.readline().decode('utf-8', errors='ignore').strip()
-        elapsed = time.time() - start_time
+        data = ser.readline()
+        arrival = time.time()
+        data = data[data.rfind(b'\x00') + 1:]     # text after any binary frame
+        cycles, line = split_stamp(data.decode('utf-8', errors='ignore').strip())
+
+        if line.startswith('sync,') and cycles is not None:
+            clock.add_sync(cycles, int(line[5:]), arrival, len(data))
+            syncs += 1
+            if syncs % 60 == 1:
+                print(f"Device clock: {clock.drift_ppm:+.1f} ppm against the host")
+            continue
+
+        made = clock.to_host(cycles)
+        elapsed = (made if made is not None else arrival) - start_time
 
         photo_match = photo_pattern.search(line)
         pwm_match = pwm_pattern.search(line)
@@ -87,7 +106,8 @@ def update(frame):
                 scaled_vals.pop(0)
                 pwm_vals.pop(0)
 
-            writer.writerow([f"{elapsed:.2f}", raw, scaled, current_pwm])
+            writer.writerow([f"{elapsed:.4f}", f"{arrival - start_time:.4f}",
+                             raw, scaled, current_pwm])
             csvfile.flush()
 
     # Update plot lines